@@ -9,14 +9,40 @@
 
 #include <BaseLib/Result/resultDSL.hpp>
 
+#include <charconv>
+#include <string_view>
+
 namespace {
     const char s_helpString[] = "help";
     const char s_runString[] = "run";
     const char s_uiString[] = "ui";
+    const char s_threadsOptionString[] = "--threads=";
 } // namespace
 
-babelwires::ResultT<ProgramOptions> ProgramOptions::parse(int argc, char* argv[]) {
+babelwires::ResultT<ProgramOptions> ProgramOptions::parse(int& argc, char* argv[]) {
     ProgramOptions options;
+
+    // Options can appear anywhere after the program name.
+    int numRemainingArgs = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.starts_with(s_threadsOptionString)) {
+            const std::string_view valueString = arg.substr(sizeof(s_threadsOptionString) - 1);
+            unsigned int numWorkerThreads = 0;
+            const auto [end, errorCode] =
+                std::from_chars(valueString.data(), valueString.data() + valueString.size(), numWorkerThreads);
+            if ((errorCode != std::errc()) || (end != valueString.data() + valueString.size())) {
+                return babelwires::Error() << "Invalid number of threads \"" << valueString << "\" provided";
+            }
+            options.m_numWorkerThreads = numWorkerThreads;
+        } else {
+            argv[numRemainingArgs] = argv[i];
+            ++numRemainingArgs;
+        }
+    }
+    argc = numRemainingArgs;
+    argv[argc] = nullptr;
+
     if (argc == 1) {
         // UI mode.
         return options;
@@ -40,12 +66,15 @@ babelwires::ResultT<ProgramOptions> ProgramOptions::parse(int argc, char* argv[]
 
 void writeUsage(const std::string& programName, std::ostream& stream) {
     stream << "Usage:" << std::endl;
-    stream << programName << std::endl;
-    stream << programName << " " << s_runString << " projectFile" << std::endl;
+    stream << programName << " [" << s_threadsOptionString << "N]" << std::endl;
+    stream << programName << " " << s_runString << " projectFile [" << s_threadsOptionString << "N]" << std::endl;
     stream << programName << " " << s_helpString << std::endl;
 }
 
 void writeHelp(const std::string& programName, std::ostream& stream) {
     stream << programName << " - A program to transform music sequence data between various file formats." << std::endl;
     writeUsage(programName, stream);
+    stream << "Options:" << std::endl;
+    stream << "  " << s_threadsOptionString
+           << "N  Use N worker threads for parallel processing, in addition to the main thread." << std::endl;
 }
@@ -9,12 +9,15 @@
 
 #include <BaseLib/Result/result.hpp>
 
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <ostream>
 
 struct ProgramOptions {
-    static babelwires::ResultT<ProgramOptions> parse(int argc, char* argv[]);
+    /// Recognized options are removed from argv and argc is reduced accordingly, so any remaining arguments
+    /// can be passed on.
+    static babelwires::ResultT<ProgramOptions> parse(int& argc, char* argv[]);
 
     enum Mode { MODE_UI, MODE_DEFAULT = MODE_UI, MODE_PRINT_HELP, MODE_RUN_PROJECT };
 
@@ -23,6 +26,9 @@ struct ProgramOptions {
     bool m_dumpIsFullDump = false;
 
     std::string m_inputFileName;
+
+    /// The number of worker threads in the thread pool. If not set, a default based on the hardware is used.
+    std::optional<unsigned int> m_numWorkerThreads;
 };
 
 void writeUsage(const std::string& programName, std::ostream& stream);
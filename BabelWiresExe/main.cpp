@@ -16,6 +16,7 @@
 #include <BabelWiresLib/FileFormat/targetFileFormat.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
 #include <BabelWiresLib/Processors/processorFactoryRegistry.hpp>
+#include <BabelWiresLib/Processors/processorResultCache.hpp>
 #include <BabelWiresLib/Project/Modifiers/modifierData.hpp>
 #include <BabelWiresLib/Project/project.hpp>
 #include <BabelWiresLib/Project/projectData.hpp>
@@ -34,6 +35,7 @@
 #include <BaseLib/PluginSupport/pluginOperations.hpp>
 #include <BaseLib/Random/randomService.hpp>
 #include <BaseLib/Serialization/deserializationRegistry.hpp>
+#include <BaseLib/Threading/threadPool.hpp>
 #include <BaseLib/libRegistration.hpp>
 
 // "plugins"
@@ -102,6 +104,11 @@ int main(int argc, char* argv[]) {
     const unsigned int seed = std::chrono::system_clock::now().time_since_epoch().count();
     babelwires::logDebug() << "The random seed was " << seed;
     babelwires::RandomService randomService(seed);
+    babelwires::ThreadPool threadPool(
+        options->m_numWorkerThreads.value_or(babelwires::ThreadPool::getDefaultNumWorkers()));
+    // Lets the project skip processing when a processor's input returns to an earlier value, e.g. on undo.
+    // The budget is measured in value tree nodes (see ProcessorResultCache::estimateSize).
+    babelwires::ProcessorResultCache processorResultCache(1 << 18);
 
     babelwires::Context context;
 
@@ -111,6 +118,8 @@ int main(int argc, char* argv[]) {
 
     context.registerService<babelwires::DeserializationRegistry>(deserializationRegistry);
     context.registerService<babelwires::RandomService>(randomService);
+    context.registerService<babelwires::ThreadPool>(threadPool);
+    context.registerService<babelwires::ProcessorResultCache>(processorResultCache);
     context.registerService<babelwires::SourceFileFormatRegistry>(sourceFileFormatReg);
     context.registerService<babelwires::TargetFileFormatRegistry>(targetFileFormatReg);
     context.registerService<babelwires::ProcessorFactoryRegistry>(processorReg);
@@ -22,14 +22,26 @@
         InstanceImpl(VALUE_TREE_NODE& valueFeature)                                                                    \
             : babelwires::InstanceParent<VALUE_TREE_NODE, TYPE>(valueFeature) {}
 
+/// Used by the field macros below. Each field gets a static FieldSlot, so the field identifier is only constructed
+/// once and the child index of the field is remembered between calls.
+#define DECLARE_INSTANCE_FIELD_SLOT(FIELD_NAME)                                                                        \
+  private:                                                                                                             \
+    static const babelwires::InstanceUtils::FieldSlot& getFieldSlot##FIELD_NAME() {                                    \
+        static const babelwires::InstanceUtils::FieldSlot s_fieldSlot(#FIELD_NAME);                                    \
+        return s_fieldSlot;                                                                                            \
+    }                                                                                                                  \
+                                                                                                                       \
+  public:
+
 /// Declare a (non-optional) field.
 #define DECLARE_INSTANCE_FIELD(FIELD_NAME, VALUE_TYPE)                                                                 \
+    DECLARE_INSTANCE_FIELD_SLOT(FIELD_NAME)                                                                            \
     babelwires::ConstInstance<VALUE_TYPE> get##FIELD_NAME() const {                                                    \
-        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, #FIELD_NAME);                                \
+        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());                 \
     }                                                                                                                  \
     template <typename VALUE_TREE_NODE_M = VALUE_TREE_NODE>                                                            \
     std::enable_if_t<!std::is_const_v<VALUE_TREE_NODE_M>, babelwires::Instance<VALUE_TYPE>> get##FIELD_NAME() {        \
-        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, #FIELD_NAME);                                \
+        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());                 \
     }
 
 /// Declare an optional field.
@@ -37,7 +49,7 @@
     DECLARE_INSTANCE_FIELD(FIELD_NAME, VALUE_TYPE)                                                                     \
     std::optional<babelwires::ConstInstance<VALUE_TYPE>> tryGet##FIELD_NAME() const {                                  \
         if (const babelwires::ValueTreeNode* valueTreeNode =                                                           \
-                babelwires::InstanceUtils::tryGetChild(this->m_valueTreeNode, #FIELD_NAME)) {                          \
+                babelwires::InstanceUtils::tryGetChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME())) {           \
             return {*valueTreeNode};                                                                                   \
         } else {                                                                                                       \
             return {};                                                                                                 \
@@ -46,11 +58,12 @@
     template <typename VALUE_TREE_NODE_M = VALUE_TREE_NODE>                                                            \
     std::enable_if_t<!std::is_const_v<VALUE_TREE_NODE_M>, babelwires::Instance<VALUE_TYPE>>                            \
         activateAndGet##FIELD_NAME() {                                                                                 \
-        return babelwires::InstanceUtils::activateAndGetChild(this->m_valueTreeNode, #FIELD_NAME);                     \
+        return babelwires::InstanceUtils::activateAndGetChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());      \
     }                                                                                                                  \
     template <typename VALUE_TREE_NODE_M = VALUE_TREE_NODE>                                                            \
     std::enable_if_t<!std::is_const_v<VALUE_TREE_NODE_M>, void> deactivate##FIELD_NAME() {                             \
-        return babelwires::InstanceUtils::deactivateChild(this->m_valueTreeNode, #FIELD_NAME);                         \
+        return babelwires::InstanceUtils::deactivateChild(this->m_valueTreeNode,                                       \
+            getFieldSlot##FIELD_NAME().getFieldId());                                                                  \
     }
 
 /// Add convenience methods for specific tag.
@@ -65,37 +78,40 @@
 
 /// Declare a (non-optional) array field.
 #define DECLARE_INSTANCE_ARRAY_FIELD(FIELD_NAME, ENTRY_TYPE)                                                           \
+    DECLARE_INSTANCE_FIELD_SLOT(FIELD_NAME)                                                                            \
     babelwires::ArrayInstanceImpl<const babelwires::ValueTreeNode, ENTRY_TYPE> get##FIELD_NAME() const {               \
-        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, #FIELD_NAME);                                \
+        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());                 \
     }                                                                                                                  \
     template <typename VALUE_TREE_NODE_M = VALUE_TREE_NODE>                                                            \
     std::enable_if_t<!std::is_const_v<VALUE_TREE_NODE_M>,                                                              \
                      babelwires::ArrayInstanceImpl<babelwires::ValueTreeNode, ENTRY_TYPE>>                             \
         get##FIELD_NAME() {                                                                                            \
-        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, #FIELD_NAME);                                \
+        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());                 \
     }
 
 /// Declare a (non-optional) map field.
 #define DECLARE_INSTANCE_MAP_FIELD(FIELD_NAME, SOURCE_TYPE, TARGET_TYPE)                                               \
+    DECLARE_INSTANCE_FIELD_SLOT(FIELD_NAME)                                                                            \
     babelwires::MapInstanceImpl<const babelwires::ValueTreeNode, SOURCE_TYPE, TARGET_TYPE> get##FIELD_NAME() const {   \
-        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, #FIELD_NAME);                                \
+        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());                 \
     }                                                                                                                  \
     template <typename VALUE_TREE_NODE_M = VALUE_TREE_NODE>                                                            \
     std::enable_if_t<!std::is_const_v<VALUE_TREE_NODE_M>,                                                              \
                      babelwires::MapInstanceImpl<babelwires::ValueTreeNode, SOURCE_TYPE, TARGET_TYPE>>                 \
         get##FIELD_NAME() {                                                                                            \
-        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, #FIELD_NAME);                                \
+        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());                 \
     }
 
 /// Declare a (non-optional) field whose value type is not expected to have an instance specialization.
 #define DECLARE_INSTANCE_NON_INSTANCE_FIELD(FIELD_NAME)                                                                     \
+    DECLARE_INSTANCE_FIELD_SLOT(FIELD_NAME)                                                                            \
     babelwires::InstanceUntypedBase<const babelwires::ValueTreeNode> get##FIELD_NAME() const {                         \
-        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, #FIELD_NAME);                                \
+        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());                 \
     }                                                                                                                  \
     template <typename VALUE_TREE_NODE_M = VALUE_TREE_NODE>                                                            \
     std::enable_if_t<!std::is_const_v<VALUE_TREE_NODE_M>, babelwires::InstanceUntypedBase<babelwires::ValueTreeNode>>  \
         get##FIELD_NAME() {                                                                                            \
-        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, #FIELD_NAME);                                \
+        return babelwires::InstanceUtils::getChild(this->m_valueTreeNode, getFieldSlot##FIELD_NAME());                 \
     }
 
 /// Conclude the declaration.
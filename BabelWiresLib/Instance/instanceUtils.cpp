@@ -13,23 +13,41 @@
 
 #include <BaseLib/Result/resultDSL.hpp>
 
+babelwires::InstanceUtils::FieldSlot::FieldSlot(ShortId fieldId)
+    : m_fieldId(fieldId) {}
+
+int babelwires::InstanceUtils::FieldSlot::getChildIndex(const babelwires::ValueTreeNode& recordTreeNode) const {
+    const int hint = m_childIndexHint.load(std::memory_order_relaxed);
+    if ((hint >= 0) && (hint < recordTreeNode.getNumChildren()) &&
+        (recordTreeNode.getStepToChildAtIndex(hint) == PathStep(m_fieldId))) {
+        assert((recordTreeNode.getChildIndexFromStep(m_fieldId) == hint) &&
+               "The remembered child index does not match the layout of the type");
+        return hint;
+    }
+    const int index = recordTreeNode.getChildIndexFromStep(m_fieldId);
+    if (index >= 0) {
+        m_childIndexHint.store(index, std::memory_order_relaxed);
+    }
+    return index;
+}
+
 const babelwires::ValueTreeNode& babelwires::InstanceUtils::getChild(const babelwires::ValueTreeNode& recordTreeNode,
-                                                            babelwires::ShortId id) {
-    const int index = recordTreeNode.getChildIndexFromStep(id);
+                                                            const FieldSlot& field) {
+    const int index = field.getChildIndex(recordTreeNode);
     assert(index >= 0);
     return recordTreeNode.getChild(index)->as<babelwires::ValueTreeNode>();
 }
 
-babelwires::ValueTreeNode& babelwires::InstanceUtils::getChild(babelwires::ValueTreeNode& recordTreeNode, babelwires::ShortId id) {
-    const int index = recordTreeNode.getChildIndexFromStep(id);
+babelwires::ValueTreeNode& babelwires::InstanceUtils::getChild(babelwires::ValueTreeNode& recordTreeNode, const FieldSlot& field) {
+    const int index = field.getChildIndex(recordTreeNode);
     assert(index >= 0);
     return recordTreeNode.getChild(index)->as<babelwires::ValueTreeNode>();
 }
 
 
 const babelwires::ValueTreeNode* babelwires::InstanceUtils::tryGetChild(const babelwires::ValueTreeNode& recordTreeNode,
-                                                               babelwires::ShortId id) {
-    const int index = recordTreeNode.getChildIndexFromStep(id);
+                                                               const FieldSlot& field) {
+    const int index = field.getChildIndex(recordTreeNode);
     if (index >= 0) {
         return &recordTreeNode.getChild(index)->as<babelwires::ValueTreeNode>();
     } else {
@@ -38,15 +56,15 @@ const babelwires::ValueTreeNode* babelwires::InstanceUtils::tryGetChild(const ba
 }
 
 babelwires::ValueTreeNode& babelwires::InstanceUtils::activateAndGetChild(babelwires::ValueTreeNode& recordTreeNode,
-                                                                 babelwires::ShortId id) {
+                                                                 const FieldSlot& field) {
     const RecordType& recordType = recordTreeNode.getType()->as<RecordType>();
     babelwires::ValueHolder recordValue = recordTreeNode.getValue();
-    if (!recordType.isActivated(recordValue, id)) {
+    if (!recordType.isActivated(recordValue, field.getFieldId())) {
         const babelwires::TypeSystem& typeSystem = recordTreeNode.getTypeSystem();
-        recordType.activateField(typeSystem, recordValue, id);
+        recordType.activateField(typeSystem, recordValue, field.getFieldId());
         recordTreeNode.assertSetValue(recordValue);
     }
-    return getChild(recordTreeNode, id);
+    return getChild(recordTreeNode, field);
 }
 
 void babelwires::InstanceUtils::deactivateChild(babelwires::ValueTreeNode& recordTreeNode,
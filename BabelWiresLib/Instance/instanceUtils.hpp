@@ -12,19 +12,40 @@
 
 #include <BaseLib/Result/result.hpp>
 
+#include <atomic>
+
 namespace babelwires {
     /// Out-of-line utility functions used by instance methods.
     namespace InstanceUtils {
+        /// Binds a field getter of the instance DSL to the child index of the field.
+        /// Each getter has its own static FieldSlot, so the identifier is constructed once and the child index
+        /// found by the last look-up can be tried before falling back to a hash look-up.
+        /// The child index of a field can depend on the value (e.g. on which optional fields are active),
+        /// so the remembered index is always confirmed against the step of the child.
+        class BABELWIRESLIB_API FieldSlot {
+          public:
+            explicit FieldSlot(ShortId fieldId);
+
+            ShortId getFieldId() const { return m_fieldId; }
+
+            /// Returns -1 if the field is not a child of the recordTreeNode.
+            int getChildIndex(const babelwires::ValueTreeNode& recordTreeNode) const;
+
+          private:
+            const ShortId m_fieldId;
+            mutable std::atomic<int> m_childIndexHint = -1;
+        };
+
         // Utility functions common between RecordTypes and RecordWithVariantTypes
 
-        BABELWIRESLIB_API const babelwires::ValueTreeNode& getChild(const babelwires::ValueTreeNode& recordTreeNode, babelwires::ShortId id);
-        BABELWIRESLIB_API babelwires::ValueTreeNode& getChild(babelwires::ValueTreeNode& recordTreeNode, babelwires::ShortId id);
+        BABELWIRESLIB_API const babelwires::ValueTreeNode& getChild(const babelwires::ValueTreeNode& recordTreeNode, const FieldSlot& field);
+        BABELWIRESLIB_API babelwires::ValueTreeNode& getChild(babelwires::ValueTreeNode& recordTreeNode, const FieldSlot& field);
 
         // Utility functions for RecordTypes
 
         BABELWIRESLIB_API const babelwires::ValueTreeNode* tryGetChild(const babelwires::ValueTreeNode& recordTreeNode,
-                                babelwires::ShortId id);
-        BABELWIRESLIB_API babelwires::ValueTreeNode& activateAndGetChild(babelwires::ValueTreeNode& recordTreeNode, babelwires::ShortId id);
+                                const FieldSlot& field);
+        BABELWIRESLIB_API babelwires::ValueTreeNode& activateAndGetChild(babelwires::ValueTreeNode& recordTreeNode, const FieldSlot& field);
         BABELWIRESLIB_API void deactivateChild(babelwires::ValueTreeNode& recordTreeNode, babelwires::ShortId id);
 
         // Utility functions for RecordWithVariantTypes
@@ -19,38 +19,175 @@
 #include <BaseLib/common.hpp>
 
 #include <algorithm>
+#include <array>
+#include <limits>
+#include <mutex>
 #include <type_traits>
+#include <unordered_map>
 
 // Try to ensure Path maintains the standard pattern for the IdentifierVisitor.
 static_assert(babelwires::IdentifierVisitable<babelwires::Path>);
 
+namespace {
+    /// The hash of the empty path. Arbitrary value.
+    constexpr std::size_t c_emptyPathHash = 0xa73be88;
+} // namespace
+
+/// The interned children of a node, or of the empty path.
+/// The table holds weak pointers, so nodes are kept alive only by the paths which use them.
+/// Each node has its own table, so threads only contend when they extend the same path, and the children of a node,
+/// which are usually created together, are found without searching a table of all nodes.
+struct babelwires::Path::ChildTable {
+    std::mutex m_mutex;
+    /// Keyed by the exact code of the step, so steps which differ only by discriminator get different nodes.
+    /// The raw pointer identifies the node which the entry was created for.
+    std::unordered_map<std::uint64_t, std::pair<const Node*, std::weak_ptr<const Node>>> m_children;
+};
+
+struct babelwires::Path::Node {
+    /// Removes the node's entry from the table of its parent.
+    ~Node();
+
+    /// Null for the first step of a path.
+    std::shared_ptr<const Node> m_parent;
+    PathStep m_step;
+    unsigned int m_numSteps;
+    /// The hash of the path ending at this node.
+    std::size_t m_hash;
+    /// A jump pointer to an ancestor, or null for the empty path. These follow the skew-binary scheme of Myers'
+    /// "An applicative random-access stack", so any ancestor can be reached in a logarithmic number of jumps.
+    const Node* m_jump;
+    mutable ChildTable m_children;
+};
+
+babelwires::Path::Node::~Node() {
+    ChildTable& table = getChildTable(m_parent.get());
+    std::lock_guard lock(table.m_mutex);
+    const auto it = table.m_children.find(m_step.m_code);
+    // Another thread may have replaced the entry after this node expired.
+    if ((it != table.m_children.end()) && (it->second.first == this)) {
+        table.m_children.erase(it);
+    }
+}
+
+babelwires::Path::ChildTable& babelwires::Path::getChildTable(const Node* parent) {
+    if (parent) {
+        return parent->m_children;
+    }
+    static ChildTable* const s_emptyPathTable = new ChildTable;
+    return *s_emptyPathTable;
+}
+
+std::shared_ptr<const babelwires::Path::Node>
+babelwires::Path::getChild(const std::shared_ptr<const Node>& parent, PathStep step) {
+    assert(!step.isNotAStep() && "Attempt to push a non-step onto a path");
+
+    // The same paths tend to be rebuilt repeatedly, so each thread keeps a small direct-mapped cache of the children
+    // it found most recently, which can be returned without taking a lock. An entry keeps its node alive, so the
+    // parent pointer in its key cannot be reused while the entry exists.
+    struct LocalCacheEntry {
+        const Node* m_parent = nullptr;
+        std::uint64_t m_stepCode = 0;
+        std::shared_ptr<const Node> m_node;
+    };
+    static constexpr unsigned int c_log2NumLocalCacheEntries = 11;
+    thread_local std::array<LocalCacheEntry, 1 << c_log2NumLocalCacheEntries> t_localCache;
+    // Fibonacci hashing spreads the bits of the hash into the top bits used to select the entry.
+    const std::uint64_t keyHash = hash::mixtureOf(parent.get(), step.m_code);
+    LocalCacheEntry& localEntry =
+        t_localCache[(keyHash * 0x9E3779B97F4A7C15ull) >>
+                     (std::numeric_limits<std::uint64_t>::digits - c_log2NumLocalCacheEntries)];
+    if (localEntry.m_node && (localEntry.m_parent == parent.get()) && (localEntry.m_stepCode == step.m_code)) {
+        return localEntry.m_node;
+    }
+
+    ChildTable& table = getChildTable(parent.get());
+    std::shared_ptr<const Node> node;
+    {
+        std::lock_guard lock(table.m_mutex);
+        const auto it = table.m_children.find(step.m_code);
+        if (it != table.m_children.end()) {
+            node = it->second.second.lock();
+        }
+        if (!node) {
+            std::size_t hash = parent ? parent->m_hash : c_emptyPathHash;
+            hash::mixInto(hash, step);
+            node = std::make_shared<const Node>(parent, step, parent ? parent->m_numSteps + 1 : 1, hash,
+                                                getJumpForChildOf(parent.get()));
+            table.m_children.insert_or_assign(step.m_code, std::make_pair(node.get(), std::weak_ptr<const Node>(node)));
+        }
+    }
+    localEntry = {parent.get(), step.m_code, node};
+    return node;
+}
+
+const babelwires::Path::Node* babelwires::Path::getJumpForChildOf(const Node* parent) {
+    // The empty path behaves as a node with zero steps which jumps to itself.
+    if (!parent) {
+        return nullptr;
+    }
+    const Node* const parentJump = parent->m_jump;
+    if (!parentJump) {
+        return parent;
+    }
+    const Node* const parentJumpJump = parentJump->m_jump;
+    const unsigned int parentJumpJumpNumSteps = parentJumpJump ? parentJumpJump->m_numSteps : 0;
+    if ((parent->m_numSteps - parentJump->m_numSteps) == (parentJump->m_numSteps - parentJumpJumpNumSteps)) {
+        return parentJumpJump;
+    }
+    return parent;
+}
+
+const babelwires::Path::Node* babelwires::Path::getAncestor(const Node* node, unsigned int numSteps) {
+    if (numSteps == 0) {
+        return nullptr;
+    }
+    while (node && (node->m_numSteps > numSteps)) {
+        const Node* const jump = node->m_jump;
+        node = (jump && (jump->m_numSteps >= numSteps)) ? jump : node->m_parent.get();
+    }
+    return node;
+}
+
+bool babelwires::Path::areEqual(const Node* a, const Node* b) {
+    while (a != b) {
+        // Equal paths have equal hashes, so this usually distinguishes unequal paths immediately.
+        if ((a->m_hash != b->m_hash) || (a->m_step != b->m_step)) {
+            return false;
+        }
+        a = a->m_parent.get();
+        b = b->m_parent.get();
+    }
+    return true;
+}
+
 babelwires::Path::Path() {}
 
-babelwires::Path::Path(std::vector<PathStep> steps)
-    : m_steps(std::move(steps)) {
-    assert(std::none_of(m_steps.begin(), m_steps.end(), [](auto p) { return p.isNotAStep(); }) &&
+babelwires::Path::Path(std::vector<PathStep> steps) {
+    assert(std::none_of(steps.begin(), steps.end(), [](auto p) { return p.isNotAStep(); }) &&
            "Attempt to construct a path from a vector containing a non-step");
+    for (const auto& step : steps) {
+        m_node = getChild(m_node, step);
+    }
 }
 
 void babelwires::Path::pushStep(PathStep step) {
     assert(!step.isNotAStep() && "Attempt to push a non-step onto a path");
-    m_steps.emplace_back(std::move(step));
+    m_node = getChild(m_node, step);
 }
 
 void babelwires::Path::popStep() {
-    assert(!m_steps.empty() && "You can't pop from an empty path");
-    m_steps.pop_back();
+    assert(m_node && "You can't pop from an empty path");
+    m_node = m_node->m_parent;
 }
 
 std::ostream& babelwires::operator<<(std::ostream& os, const Path& p) {
     const IdentifierRegistry::ReadAccess identifierRegistry = IdentifierRegistry::read();
-    const int numSteps = p.getNumSteps();
-    if (numSteps) {
+    if (p.getNumSteps()) {
         const char* delimiter = "";
-        for (int i = 0; i < numSteps; ++i) {
+        for (const auto& step : p.getSteps()) {
             os << delimiter;
             delimiter = s_pathDelimiterString;
-            const PathStep step = p.getStep(i);
             step.writeToStreamReadable(os, *identifierRegistry);
         }
     } else {
@@ -62,10 +199,10 @@ std::ostream& babelwires::operator<<(std::ostream& os, const Path& p) {
 std::string babelwires::Path::serializeToString() const {
     std::ostringstream os;
     const char* delimiter = "";
-    for (int i = 0; i < getNumSteps(); ++i) {
+    for (const auto& step : getSteps()) {
         os << delimiter;
         delimiter = s_pathDelimiterString;
-        os << getStep(i).serializeToString();
+        os << step.serializeToString();
     }
     return os.str();
 }
@@ -86,10 +223,10 @@ babelwires::ResultT<babelwires::Path> babelwires::Path::deserializeFromString(co
         if (!stepResult) {
             return std::move(stepResult.error());
         }
-        path.m_steps.emplace_back(*stepResult);
-        if (path.m_steps.back().isNotAStep()) {
+        if (stepResult->isNotAStep()) {
             return Error() << "Parsing a path encountered a step which is not a step";
         }
+        path.pushStep(*stepResult);
         start = next;
     } while (start != std::string::npos);
 
@@ -97,32 +234,45 @@ babelwires::ResultT<babelwires::Path> babelwires::Path::deserializeFromString(co
 }
 
 int babelwires::Path::compare(const Path& other) const {
-    auto it = m_steps.begin();
-    auto oit = other.m_steps.begin();
-    while (true) {
-        const bool thisAtEnd = (it == m_steps.end());
-        const bool otherAtEnd = (oit == other.m_steps.end());
-        if (thisAtEnd) {
-            return otherAtEnd ? 0 : -1;
-        } else if (otherAtEnd) {
-            return 1;
-        } else if (*it < *oit) {
-            return -1;
-        } else if (*oit < *it) {
-            return 1;
+    const Node* a = m_node.get();
+    const Node* b = other.m_node.get();
+    if (a == b) {
+        return 0;
+    }
+    const unsigned int numStepsA = getNumSteps();
+    const unsigned int numStepsB = other.getNumSteps();
+    const unsigned int numCommonSteps = std::min(numStepsA, numStepsB);
+    a = getAncestor(a, numCommonSteps);
+    b = getAncestor(b, numCommonSteps);
+    // Walk up to the point where the paths share a node. The first differing step is the last one found.
+    const PathStep* firstDifferenceA = nullptr;
+    const PathStep* firstDifferenceB = nullptr;
+    while (a != b) {
+        if (a->m_step != b->m_step) {
+            firstDifferenceA = &a->m_step;
+            firstDifferenceB = &b->m_step;
         }
-        ++it;
-        ++oit;
+        a = a->m_parent.get();
+        b = b->m_parent.get();
+    }
+    if (firstDifferenceA) {
+        return (*firstDifferenceA < *firstDifferenceB) ? -1 : 1;
+    }
+    if (numStepsA == numStepsB) {
+        return 0;
     }
-    return 0;
+    return (numStepsA < numStepsB) ? -1 : 1;
 }
 
 bool babelwires::Path::operator==(const Path& other) const {
-    return compare(other) == 0;
+    if (getNumSteps() != other.getNumSteps()) {
+        return false;
+    }
+    return areEqual(m_node.get(), other.m_node.get());
 }
 
 bool babelwires::Path::operator!=(const Path& other) const {
-    return compare(other);
+    return !(*this == other);
 }
 
 bool babelwires::Path::operator<(const Path& other) const {
@@ -134,67 +284,89 @@ bool babelwires::Path::operator<=(const Path& other) const {
 }
 
 bool babelwires::Path::isPrefixOf(const Path& other) const {
-    if (m_steps.size() > other.m_steps.size()) {
+    const unsigned int numSteps = getNumSteps();
+    if (numSteps > other.getNumSteps()) {
         return false;
     }
-    const auto pair = std::mismatch(m_steps.begin(), m_steps.end(), other.m_steps.begin());
-    return pair.first == m_steps.end();
+    return areEqual(m_node.get(), getAncestor(other.m_node.get(), numSteps));
 }
 
 bool babelwires::Path::isStrictPrefixOf(const Path& other) const {
     if (isPrefixOf(other)) {
-        return m_steps.size() != other.m_steps.size();
+        return getNumSteps() != other.getNumSteps();
     }
     return false;
 }
 
 unsigned int babelwires::Path::getNumSteps() const {
-    return m_steps.size();
+    return m_node ? m_node->m_numSteps : 0;
 }
 
 void babelwires::Path::truncate(unsigned int newNumSteps) {
-    assert((newNumSteps <= m_steps.size()) && "You can only shrink with truncate");
-    // Have to provide a fill value even though it is never used.
-    m_steps.resize(newNumSteps, 0);
+    assert((newNumSteps <= getNumSteps()) && "You can only shrink with truncate");
+    while (m_node && (m_node->m_numSteps > newNumSteps)) {
+        m_node = m_node->m_parent;
+    }
 }
 
 void babelwires::Path::removePrefix(unsigned int numSteps) {
-    assert((numSteps <= m_steps.size()) && "Cannot remove that many steps");
+    assert((numSteps <= getNumSteps()) && "Cannot remove that many steps");
     if (numSteps > 0) {
-        m_steps.erase(m_steps.begin(), m_steps.begin() + numSteps);
+        const std::vector<PathStep> steps = getSteps();
+        m_node.reset();
+        for (auto it = steps.begin() + numSteps; it != steps.end(); ++it) {
+            m_node = getChild(m_node, *it);
+        }
     }
 }
 
 void babelwires::Path::append(const Path& subpath) {
-    m_steps.insert(m_steps.end(), subpath.m_steps.begin(), subpath.m_steps.end());
+    for (const auto& step : subpath.getSteps()) {
+        m_node = getChild(m_node, step);
+    }
 }
 
-babelwires::PathStep& babelwires::Path::getStep(unsigned int i) {
-    assert((i < m_steps.size()) && "There is no ith step");
-    return m_steps[i];
+void babelwires::Path::setStep(unsigned int i, PathStep step) {
+    assert((i < getNumSteps()) && "There is no ith step");
+    assert(!step.isNotAStep() && "Attempt to put a non-step into a path");
+    std::vector<PathStep> subsequentSteps;
+    subsequentSteps.reserve(getNumSteps() - i - 1);
+    while (m_node->m_numSteps > i + 1) {
+        subsequentSteps.emplace_back(m_node->m_step);
+        m_node = m_node->m_parent;
+    }
+    m_node = getChild(m_node->m_parent, step);
+    for (auto it = subsequentSteps.rbegin(); it != subsequentSteps.rend(); ++it) {
+        m_node = getChild(m_node, *it);
+    }
 }
 
 const babelwires::PathStep& babelwires::Path::getStep(unsigned int i) const {
-    assert((i < m_steps.size()) && "There is no ith step");
-    return m_steps[i];
+    assert((i < getNumSteps()) && "There is no ith step");
+    return getAncestor(m_node.get(), i + 1)->m_step;
 }
 
 const babelwires::PathStep& babelwires::Path::getLastStep() const {
-    assert((m_steps.size() > 0) && "There are no steps.");
-    return m_steps.back();
+    assert(m_node && "There are no steps.");
+    return m_node->m_step;
 }
 
-std::size_t babelwires::Path::getHash() const {
-    // Arbitrary value.
-    std::size_t hash = 0xa73be88;
-    for (const auto& step : m_steps) {
-        hash::mixInto(hash, step);
+std::vector<babelwires::PathStep> babelwires::Path::getSteps() const {
+    std::vector<PathStep> steps(getNumSteps());
+    for (const Node* node = m_node.get(); node; node = node->m_parent.get()) {
+        steps[node->m_numSteps - 1] = node->m_step;
     }
-    return hash;
+    return steps;
+}
+
+std::size_t babelwires::Path::getHash() const {
+    return m_node ? m_node->m_hash : c_emptyPathHash;
 }
 
 void babelwires::Path::visitIdentifiers(IdentifierVisitor& visitor) {
-    for (auto& step : m_steps) {
+    std::vector<PathStep> steps = getSteps();
+    for (auto& step : steps) {
         step.visitIdentifiers(visitor);
     }
+    *this = Path(std::move(steps));
 }
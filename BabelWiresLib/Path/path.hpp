@@ -11,6 +11,8 @@
 #include <BabelWiresLib/Path/pathStep.hpp>
 #include <BaseLib/Result/result.hpp>
 
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -22,6 +24,10 @@ namespace babelwires {
     class ValueTreeRoot;
 
     /// Describes the steps to follow within a ValueTree to reach a particular ValueTreeNode.
+    /// Paths are interned as a trie of steps: Each path refers to a shared node which knows its parent, so copying a
+    /// path just copies a pointer, and paths which share a prefix share the nodes of that prefix.
+    /// Each node caches the hash of its path, so paths which differ can usually be distinguished without comparing
+    /// their steps, and a jump pointer to an ancestor, so steps can be accessed by index in logarithmic time.
     class BABELWIRESLIB_API Path {
       public:
         /// Construct an empty path.
@@ -75,22 +81,56 @@ namespace babelwires {
         /// Get the ith step of the path. Asserts that i is valid.
         const PathStep& getStep(unsigned int i) const;
 
-        /// Get the ith step of the path. Asserts that i is valid.
-        PathStep& getStep(unsigned int i);
+        /// Replace the ith step of the path. Asserts that i is valid.
+        void setStep(unsigned int i, PathStep step);
 
         /// Gets the last step. Asserts that there is one.
         const PathStep& getLastStep() const;
 
+        /// Get the steps of the path as a vector.
+        std::vector<PathStep> getSteps() const;
+
         /// Get a hash of this path.
         std::size_t getHash() const;
 
-        using const_iterator = std::vector<PathStep>::const_iterator;
-        const_iterator begin() const { return m_steps.begin(); }
-        const_iterator end() const { return m_steps.end(); }
-
-        using iterator = std::vector<PathStep>::iterator;
-        iterator begin() { return m_steps.begin(); }
-        iterator end() { return m_steps.end(); }
+        /// Iterates over the steps of a path from first to last.
+        class BABELWIRESLIB_API const_iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = PathStep;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const PathStep*;
+            using reference = const PathStep&;
+
+            const_iterator() = default;
+            const_iterator(const Path* path, unsigned int index)
+                : m_path(path)
+                , m_index(index) {}
+
+            const PathStep& operator*() const { return m_path->getStep(m_index); }
+            const PathStep* operator->() const { return &m_path->getStep(m_index); }
+            const_iterator& operator++() {
+                ++m_index;
+                return *this;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++m_index;
+                return tmp;
+            }
+            difference_type operator-(const const_iterator& other) const {
+                return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+            }
+            bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+            bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+          private:
+            const Path* m_path = nullptr;
+            unsigned int m_index = 0;
+        };
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, getNumSteps()); }
 
         /// Apply the visitor to any fields in the path.
         void visitIdentifiers(IdentifierVisitor& visitor);
@@ -99,7 +139,28 @@ namespace babelwires {
         int compare(const Path& other) const;
 
       private:
-        std::vector<PathStep> m_steps;
+        struct Node;
+        struct ChildTable;
+
+        /// Get the table of the children of parent, which can be null. The table of the empty path is never
+        /// destroyed, since paths can be held in static objects.
+        static ChildTable& getChildTable(const Node* parent);
+
+        /// Get the interned node for the step following parent. Parent can be null.
+        static std::shared_ptr<const Node> getChild(const std::shared_ptr<const Node>& parent, PathStep step);
+
+        /// Get the jump pointer for a new child of parent. Parent can be null.
+        static const Node* getJumpForChildOf(const Node* parent);
+
+        /// Get the ancestor of node with the given number of steps.
+        static const Node* getAncestor(const Node* node, unsigned int numSteps);
+
+        /// Are the paths ending at these nodes equal? Assumes they have the same number of steps.
+        static bool areEqual(const Node* a, const Node* b);
+
+      private:
+        /// The node of the last step, or null for the empty path.
+        std::shared_ptr<const Node> m_node;
     };
 
     /// Write a path to an ostream.
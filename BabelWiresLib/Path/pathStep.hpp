@@ -116,6 +116,8 @@ namespace babelwires {
 
       private:
         friend struct std::hash<PathStep>;
+        /// Paths are interned using the exact contents of steps, including discriminators.
+        friend class Path;
 
         // A union of these.
         ShortId m_fieldIdentifier;
@@ -0,0 +1,67 @@
+/**
+ * A PathSubtreeSet is a set of subtrees of a ValueTree, identified by the paths to their roots.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <BabelWiresLib/Path/pathSubtreeSet.hpp>
+
+void babelwires::PathSubtreeSet::add(const Path& path) {
+    TrieNode* node = &m_root;
+    for (const PathStep& step : path.getSteps()) {
+        if (node->m_isInSet) {
+            return;
+        }
+        std::unique_ptr<TrieNode>& child = node->m_children[step];
+        if (!child) {
+            child = std::make_unique<TrieNode>();
+        }
+        node = child.get();
+    }
+    node->m_isInSet = true;
+    node->m_children.clear();
+}
+
+bool babelwires::PathSubtreeSet::contains(const Path& path) const {
+    const TrieNode* node = &m_root;
+    for (const PathStep& step : path.getSteps()) {
+        if (node->m_isInSet) {
+            return true;
+        }
+        const auto it = node->m_children.find(step);
+        if (it == node->m_children.end()) {
+            return false;
+        }
+        node = it->second.get();
+    }
+    return node->m_isInSet;
+}
+
+bool babelwires::PathSubtreeSet::isEmpty() const {
+    return !m_root.m_isInSet && m_root.m_children.empty();
+}
+
+void babelwires::PathSubtreeSet::clear() {
+    m_root.m_isInSet = false;
+    m_root.m_children.clear();
+}
+
+std::vector<babelwires::Path> babelwires::PathSubtreeSet::getPaths() const {
+    std::vector<Path> paths;
+    Path pathToNode;
+    getPaths(m_root, pathToNode, paths);
+    return paths;
+}
+
+void babelwires::PathSubtreeSet::getPaths(const TrieNode& node, Path& pathToNode, std::vector<Path>& pathsOut) {
+    if (node.m_isInSet) {
+        pathsOut.emplace_back(pathToNode);
+        return;
+    }
+    for (const auto& [step, child] : node.m_children) {
+        pathToNode.pushStep(step);
+        getPaths(*child, pathToNode, pathsOut);
+        pathToNode.popStep();
+    }
+}
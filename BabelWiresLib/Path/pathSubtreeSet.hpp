@@ -0,0 +1,52 @@
+/**
+ * A PathSubtreeSet is a set of subtrees of a ValueTree, identified by the paths to their roots.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BabelWiresLib/babelWiresLibExport.hpp>
+#include <BabelWiresLib/Path/path.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace babelwires {
+
+    /// A set of subtrees of a ValueTree, identified by the paths to their roots and stored as a trie of steps.
+    /// No path in the set is a prefix of another: Adding a path beneath a path in the set has no effect, and adding a
+    /// path removes the paths beneath it. Adding a path is linear in its number of steps, not in the size of the set.
+    class BABELWIRESLIB_API PathSubtreeSet {
+      public:
+        /// Add the subtree at the path.
+        void add(const Path& path);
+
+        /// Is the path in one of the subtrees of the set?
+        bool contains(const Path& path) const;
+
+        bool isEmpty() const;
+
+        void clear();
+
+        /// Get the paths to the roots of the subtrees, in path order.
+        std::vector<Path> getPaths() const;
+
+      private:
+        struct TrieNode {
+            /// When true, the node has no children.
+            bool m_isInSet = false;
+
+            /// Ordered by step, so traversals visit paths in path order.
+            std::map<PathStep, std::unique_ptr<TrieNode>> m_children;
+        };
+
+        static void getPaths(const TrieNode& node, Path& pathToNode, std::vector<Path>& pathsOut);
+
+      private:
+        TrieNode m_root;
+    };
+
+} // namespace babelwires
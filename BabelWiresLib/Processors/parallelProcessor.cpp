@@ -21,16 +21,18 @@
 
 #include <BaseLib/Context/context.hpp>
 #include <BaseLib/Result/error.hpp>
+#include <BaseLib/Threading/threadPool.hpp>
 
 #include <algorithm>
 #include <array>
-#include <execution>
+#include <atomic>
 #include <numeric>
 #include <sstream>
+#include <unordered_map>
 
 namespace {
     babelwires::TypeExp getParallelArray(babelwires::TypeExp&& entryType) {
-        return babelwires::ArrayTypeConstructor::makeTypeExp(std::move(entryType), 1, 16);
+        return babelwires::ArrayTypeConstructor::makeTypeExp(std::move(entryType), 1, babelwires::s_maxParallelFeatures);
     }
 
     std::vector<babelwires::RecordType::FieldDefinition>&&
@@ -56,7 +58,8 @@ babelwires::ParallelProcessorOutputBase::ParallelProcessorOutputBase(TypeExp&& t
 babelwires::ParallelProcessor::ParallelProcessor(const Context& context, const TypeExp& parallelInputExp,
                                                  const TypeExp& parallelOutputExp)
     : Processor(context, parallelInputExp.assertResolve(context.get<TypeSystem>()),
-                parallelOutputExp.assertResolve(context.get<TypeSystem>())) {
+                parallelOutputExp.assertResolve(context.get<TypeSystem>()))
+    , m_threadPool(context.get<ThreadPool>()) {
 #ifndef NDEBUG
     auto inputType = getInput().getType()->as<ParallelProcessorInputBase>();
     auto outputType = getOutput().getType()->as<ParallelProcessorOutputBase>();
@@ -69,6 +72,8 @@ babelwires::ParallelProcessor::ParallelProcessor(const Context& context, const T
 #endif
 }
 
+babelwires::ParallelProcessor::~ParallelProcessor() = default;
+
 babelwires::Result babelwires::ParallelProcessor::processValue(UserLogger& userLogger, const ValueTreeNode& input,
                                                                ValueTreeNode& output) const {
     bool shouldProcessAll = false;
@@ -82,55 +87,105 @@ babelwires::Result babelwires::ParallelProcessor::processValue(UserLogger& userL
     const auto& arrayInput = input.getChild(input.getNumChildren() - 1)->as<ValueTreeNode>();
     auto& arrayOutput = output.getChild(output.getNumChildren() - 1)->as<ValueTreeNode>();
 
-    if (arrayInput.isChanged(ValueTreeNode::Changes::StructureChanged)) {
-        // TODO: This is very inefficient in cases where a single entry has been added or removed.
-        // In the old feature system I was able to maintain a mapping between input and output entries
-        // to avoid this inefficiency. Perhaps that can be done with values too.
-        shouldProcessAll = true;
-        InstanceUtils::assertSetArraySize(arrayOutput, arrayInput.getNumChildren());
-    }
+    const unsigned int numEntries = arrayInput.getNumChildren();
 
-    struct EntryData {
-        EntryData(const TypeSystem& typeSystem, unsigned int index, const ValueTreeNode& inputEntry,
-                  const ValueTreeNode& outputEntry)
-            : m_index(index)
-            , m_inputEntry(inputEntry)
-            , m_outputEntry(std::make_unique<ValueTreeRoot>(typeSystem, outputEntry.getType())) {
-            m_outputEntry->assertSetValue(outputEntry.getValue());
+    const bool isStructureChanged = arrayInput.isChanged(ValueTreeNode::Changes::StructureChanged);
+    const auto isEntryChanged = [&arrayInput, isStructureChanged](unsigned int i) {
+        return isStructureChanged || arrayInput.getChild(i)->isChanged(ValueTreeNode::Changes::SomethingChanged);
+    };
+
+    // An entry whose value was processed before can reuse the output from then, provided the common input has not
+    // changed.
+    std::vector<ValueHolder> outputsToReuse(numEntries);
+    if (!shouldProcessAll && arrayInput.isChanged(ValueTreeNode::Changes::SomethingChanged)) {
+        const ValueHolder previousOutput = arrayOutput.getValue();
+        const ArrayValue& previousOutputArray = previousOutput->as<ArrayValue>();
+        const unsigned int numPreviousEntries =
+            std::min<unsigned int>(m_processedInputEntries.size(), previousOutputArray.getSize());
+        // Usually an entry keeps its position. This comparison is cheap when the value is unchanged, since it
+        // compares pointers first.
+        std::vector<unsigned int> unmatchedEntries;
+        for (unsigned int i = 0; i < numEntries; ++i) {
+            if (isEntryChanged(i)) {
+                if ((i < numPreviousEntries) && (arrayInput.getChild(i)->getValue() == m_processedInputEntries[i])) {
+                    outputsToReuse[i] = previousOutputArray.getValue(i);
+                } else {
+                    unmatchedEntries.emplace_back(i);
+                }
+            }
         }
+        // When entries are inserted or removed, an entry can reuse the output of any previous entry. Otherwise
+        // entries can only have moved between the positions which changed, so a single changed entry (the common
+        // case of an edit) has nothing to match and no values need to be hashed.
+        if (isStructureChanged ? !unmatchedEntries.empty() : (unmatchedEntries.size() > 1)) {
+            std::unordered_map<ValueHolder, unsigned int> previousIndexFromInput;
+            if (isStructureChanged) {
+                for (unsigned int j = 0; j < numPreviousEntries; ++j) {
+                    previousIndexFromInput.insert(std::make_pair(m_processedInputEntries[j], j));
+                }
+            } else {
+                for (unsigned int j : unmatchedEntries) {
+                    if (j < numPreviousEntries) {
+                        previousIndexFromInput.insert(std::make_pair(m_processedInputEntries[j], j));
+                    }
+                }
+            }
+            for (unsigned int i : unmatchedEntries) {
+                const auto it = previousIndexFromInput.find(arrayInput.getChild(i)->getValue());
+                if (it != previousIndexFromInput.end()) {
+                    outputsToReuse[i] = previousOutputArray.getValue(it->second);
+                }
+            }
+        }
+    }
+    if (isStructureChanged) {
+        InstanceUtils::assertSetArraySize(arrayOutput, numEntries);
+    }
 
-        const unsigned int m_index;
+    struct EntryData {
+        unsigned int m_index;
         const ValueTreeNode& m_inputEntry;
-        std::unique_ptr<ValueTreeRoot> m_outputEntry;
+        ValueTreeRoot* m_outputEntry;
         std::string m_failureString;
     };
     std::vector<EntryData> entriesToProcess;
-    entriesToProcess.reserve(s_maxParallelFeatures);
+    entriesToProcess.reserve(numEntries);
 
+    // Entry roots are kept from previous passes, so processing an entry does not have to allocate one.
+    m_outputEntryRoots.resize(numEntries);
     const TypeSystem& typeSystem = input.getTypeSystem();
 
-    for (unsigned int i = 0; i < arrayInput.getNumChildren(); ++i) {
+    for (unsigned int i = 0; i < numEntries; ++i) {
         const ValueTreeNode& inputEntry = arrayInput.getChild(i)->as<ValueTreeNode>();
-        if (shouldProcessAll || arrayInput.getChild(i)->isChanged(ValueTreeNode::Changes::SomethingChanged)) {
-            ValueTreeNode& outputEntry = arrayOutput.getChild(i)->as<ValueTreeNode>();
-            entriesToProcess.emplace_back(EntryData{typeSystem, i, inputEntry, outputEntry});
+        if (outputsToReuse[i]) {
+            continue;
+        }
+        if (shouldProcessAll || isEntryChanged(i)) {
+            const ValueTreeNode& outputEntry = arrayOutput.getChild(i)->as<ValueTreeNode>();
+            std::unique_ptr<ValueTreeRoot>& outputEntryRoot = m_outputEntryRoots[i];
+            if (!outputEntryRoot || (outputEntryRoot->getType() != outputEntry.getType())) {
+                outputEntryRoot = std::make_unique<ValueTreeRoot>(typeSystem, outputEntry.getType());
+            }
+            outputEntryRoot->assertSetValue(outputEntry.getValue());
+            entriesToProcess.emplace_back(EntryData{i, inputEntry, outputEntryRoot.get()});
         }
     }
 
-    bool isFailed = false;
-    std::for_each(
-#ifndef __APPLE__
-        std::execution::par,
-#endif
-        entriesToProcess.begin(), entriesToProcess.end(), [this, &input, &userLogger, &isFailed](EntryData& data) {
-            Result result = processEntry(userLogger, input, data.m_inputEntry, *(data.m_outputEntry));
-            if (!result) {
-                data.m_failureString = result.error().toString();
-                isFailed = true;
-            }
-        });
+    std::atomic<bool> isFailed = false;
+    m_threadPool.parallelFor(entriesToProcess.size(),
+                             [this, &input, &userLogger, &isFailed, &entriesToProcess](std::size_t i) {
+                                 EntryData& data = entriesToProcess[i];
+                                 Result result =
+                                     processEntry(userLogger, input, data.m_inputEntry, *(data.m_outputEntry));
+                                 if (!result) {
+                                     data.m_failureString = result.error().toString();
+                                     isFailed = true;
+                                 }
+                             });
 
     if (isFailed) {
+        // The output will not correspond to the input, so nothing can be reused next time.
+        m_processedInputEntries.clear();
         // TODO: Would be much nicer to have per-entry way to signal failure.
         Error compositeError;
         const char* newline = "";
@@ -145,9 +200,29 @@ babelwires::Result babelwires::ParallelProcessor::processValue(UserLogger& userL
     }
 
     ArrayValue newOutput = arrayOutput.getValue()->as<ArrayValue>();
+    for (unsigned int i = 0; i < numEntries; ++i) {
+        if (outputsToReuse[i]) {
+            newOutput.setValue(i, std::move(outputsToReuse[i]));
+        }
+    }
     for (EntryData& data : entriesToProcess) {
         newOutput.setValue(data.m_index, data.m_outputEntry->getValue());
     }
     arrayOutput.assertSetValue(std::move(newOutput));
+
+    rememberInputEntries(arrayInput);
     return {};
 }
+
+void babelwires::ParallelProcessor::onOutputRestored() {
+    // The restored output corresponds to the current input entries.
+    const ValueTreeNode& input = getInput();
+    rememberInputEntries(input.getChild(input.getNumChildren() - 1)->as<ValueTreeNode>());
+}
+
+void babelwires::ParallelProcessor::rememberInputEntries(const ValueTreeNode& arrayInput) const {
+    m_processedInputEntries.resize(arrayInput.getNumChildren());
+    for (unsigned int i = 0; i < arrayInput.getNumChildren(); ++i) {
+        m_processedInputEntries[i] = arrayInput.getChild(i)->getValue();
+    }
+}
@@ -10,12 +10,20 @@
 
 #include <BabelWiresLib/babelWiresLibExport.hpp>
 #include <BabelWiresLib/Processors/processor.hpp>
+#include <BabelWiresLib/TypeSystem/valueHolder.hpp>
 #include <BabelWiresLib/Types/Record/recordType.hpp>
 
 #include <BaseLib/Result/result.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace babelwires {
-    constexpr int s_maxParallelFeatures = 16;
+    class ThreadPool;
+    class ValueTreeRoot;
+
+    /// The maximum number of entries in the array of a ParallelProcessor.
+    constexpr unsigned int s_maxParallelFeatures = 1 << 16;
 
     /// ParallelProcessors should override this for their input type. An array of the right shape will be automatically
     /// added at the end of the field set. It is typical (but not required) for parallel processors have common input
@@ -49,13 +57,34 @@ namespace babelwires {
       public:
         ParallelProcessor(const Context& context, const TypeExp& parallelInput,
                           const TypeExp& parallelOutput);
+        ~ParallelProcessor();
 
       protected:
         Result processValue(UserLogger& userLogger, const ValueTreeNode& input,
                           ValueTreeNode& output) const override final;
 
+        /// The output entry should depend only on the common input and the value of the input entry.
+        /// This allows the output of an entry to be reused when entries are inserted, removed or reordered.
+        /// Entries are processed concurrently on the ThreadPool, so implementations must be thread-safe: They
+        /// must not modify the processor or any other shared state without synchronization.
         virtual Result processEntry(UserLogger& userLogger, const ValueTreeNode& input,
                                     const ValueTreeNode& inputEntry, ValueTreeNode& outputEntry) const = 0;
+
+        void onOutputRestored() override;
+
+      private:
+        /// Record the values of the input entries to which the output now corresponds.
+        void rememberInputEntries(const ValueTreeNode& arrayInput) const;
+
+      private:
+        /// Entries are processed by the ThreadPool registered in the context.
+        const ThreadPool& m_threadPool;
+
+        /// The values of the input entries, as of the last time the processor succeeded.
+        mutable std::vector<ValueHolder> m_processedInputEntries;
+
+        /// Roots which hold the output of an entry while it is processed, kept between passes.
+        mutable std::vector<std::unique_ptr<ValueTreeRoot>> m_outputEntryRoots;
     };
 
 } // namespace babelwires
@@ -46,6 +46,17 @@ babelwires::Result babelwires::Processor::process(UserLogger& userLogger) {
     return result;
 }
 
+void babelwires::Processor::restoreOutput(const ValueHolder& output) {
+    m_outputValueTreeRoot->assertSetValue(output);
+    onOutputRestored();
+}
+
+bool babelwires::Processor::isOutputCacheable() const {
+    return false;
+}
+
 void babelwires::Processor::onFailure() const {
     m_outputValueTreeRoot->setToDefault();
 }
+
+void babelwires::Processor::onOutputRestored() {}
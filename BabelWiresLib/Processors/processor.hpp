@@ -20,9 +20,10 @@ namespace babelwires {
     class Context;
     class TypeExp;
     class ValueTreeRoot;
+    class ValueHolder;
 
     /// A Processor defines an operation from an input ValueTree to an output ValueTree.
-    /// This should not store any state.
+    /// This should not store any state, except state which only serves to make processing faster.
     class BABELWIRESLIB_API Processor {
       public:
         Processor(const Context& context, TypePtr inputTypeExp, TypePtr outputTypeExp);
@@ -37,6 +38,13 @@ namespace babelwires {
         const ValueTreeRoot& getInput() const;
         const ValueTreeRoot& getOutput() const;
 
+        /// Set the output to a value produced by an earlier call to process with an input equal to the current input.
+        void restoreOutput(const ValueHolder& output);
+
+        /// Return true if the output depends only on the value of the input, so it can be cached.
+        /// The default implementation returns false.
+        virtual bool isOutputCacheable() const;
+
       protected:
         /// Note: Implementations do not need to worry about backing-up or resolving changes in the output.
         virtual Result processValue(UserLogger& userLogger, const ValueTreeNode& input,
@@ -47,6 +55,10 @@ namespace babelwires {
         /// This can be overridden if you want to report failure but have a more subtle effect on the output.
         virtual void onFailure() const;
 
+        /// Called after restoreOutput. Processors which keep state between calls to process should update it.
+        /// The default implementation does nothing.
+        virtual void onOutputRestored();
+
       protected:
         std::unique_ptr<ValueTreeRoot> m_inputValueTreeRoot;
         std::unique_ptr<ValueTreeRoot> m_outputValueTreeRoot;
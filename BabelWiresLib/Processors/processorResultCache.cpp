@@ -0,0 +1,90 @@
+/**
+ * The ProcessorResultCache remembers the outputs which processors produced for given inputs.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <BabelWiresLib/Processors/processorResultCache.hpp>
+
+#include <BabelWiresLib/ValueTree/valueTreeNode.hpp>
+
+#include <BaseLib/Hash/hash.hpp>
+
+#include <cassert>
+
+babelwires::ProcessorResultCache::ProcessorResultCache(std::size_t maximumTotalSize)
+    : m_maximumTotalSize(maximumTotalSize) {
+    assert((maximumTotalSize > 0) && "A ProcessorResultCache needs room for at least one entry");
+}
+
+std::size_t babelwires::ProcessorResultCache::estimateSize(const ValueTreeNode& valueTree) {
+    std::size_t size = 1;
+    for (int i = 0; i < valueTree.getNumChildren(); ++i) {
+        size += estimateSize(*valueTree.getChild(i));
+    }
+    return size;
+}
+
+std::size_t babelwires::ProcessorResultCache::KeyHash::operator()(const Key& key) const {
+    return hash::mixtureOf(key.m_factoryIdentifier, key.m_version, key.m_input);
+}
+
+babelwires::ValueHolder babelwires::ProcessorResultCache::find(const LongId& factoryIdentifier,
+                                                               VersionNumber version,
+                                                               const ValueHolder& input) const {
+    std::lock_guard lock(m_mutex);
+    const auto it = m_entryFromKey.find(Key{factoryIdentifier, version, input});
+    if (it == m_entryFromKey.end()) {
+        return {};
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->m_output;
+}
+
+void babelwires::ProcessorResultCache::insert(const LongId& factoryIdentifier, VersionNumber version,
+                                              const ValueHolder& input, const ValueHolder& output,
+                                              std::size_t size) const {
+    assert(input && output);
+    std::lock_guard lock(m_mutex);
+    Key key{factoryIdentifier, version, input};
+    const auto it = m_entryFromKey.find(key);
+    if (it != m_entryFromKey.end()) {
+        m_totalSize -= it->second->m_size;
+        m_entryFromKey.erase(it->second->m_key);
+        m_entries.erase(it->second);
+    }
+    if (size > m_maximumTotalSize) {
+        return;
+    }
+    evictUntil(m_maximumTotalSize - size);
+    m_entries.emplace_front(Entry{key, output, size});
+    m_entryFromKey.emplace(std::move(key), m_entries.begin());
+    m_totalSize += size;
+}
+
+void babelwires::ProcessorResultCache::evictUntil(std::size_t totalSize) const {
+    while (m_totalSize > totalSize) {
+        assert(!m_entries.empty());
+        m_totalSize -= m_entries.back().m_size;
+        m_entryFromKey.erase(m_entries.back().m_key);
+        m_entries.pop_back();
+    }
+}
+
+std::size_t babelwires::ProcessorResultCache::getNumEntries() const {
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
+
+std::size_t babelwires::ProcessorResultCache::getTotalSize() const {
+    std::lock_guard lock(m_mutex);
+    return m_totalSize;
+}
+
+void babelwires::ProcessorResultCache::clear() const {
+    std::lock_guard lock(m_mutex);
+    m_entryFromKey.clear();
+    m_entries.clear();
+    m_totalSize = 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * The ProcessorResultCache remembers the outputs which processors produced for given inputs.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BabelWiresLib/babelWiresLibExport.hpp>
+#include <BabelWiresLib/TypeSystem/valueHolder.hpp>
+
+#include <BaseLib/Identifiers/identifier.hpp>
+#include <BaseLib/common.hpp>
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace babelwires {
+    class ValueTreeNode;
+
+    /// Remembers the outputs which processors produced for given inputs, so a ProcessorNode whose input returns to a
+    /// value seen before (e.g. after an undo) does not have to process it again.
+    ///
+    /// This is an optional service: ProcessorNodes use it if it is registered in the Context, and only for processors
+    /// which declare that their output is cacheable.
+    /// Entries are keyed by the processor's factory identifier and version, and the input value. Values are compared
+    /// for equality, so a hash collision cannot return the wrong output.
+    /// When the cache is over budget, the least recently used entries are discarded.
+    ///
+    /// Values do not report their memory use, so the budget is measured in value tree nodes, as counted by
+    /// estimateSize. An entry's size counts both its input and output. This is only an estimate of memory: A node
+    /// holding a large string or a long list of events costs the same as one holding an int. Cached values can share
+    /// storage with the live value trees, but they keep the whole value alive once the trees move on (e.g. after an
+    /// undo), so they should be assumed to cost their full size.
+    class BABELWIRESLIB_API ProcessorResultCache {
+      public:
+        /// The maximum total size of the entries, as counted by estimateSize.
+        explicit ProcessorResultCache(std::size_t maximumTotalSize);
+
+        /// The number of nodes in the value tree, which is used as an estimate of the memory its value occupies.
+        static std::size_t estimateSize(const ValueTreeNode& valueTree);
+
+        /// Return the output previously stored for the input, or an empty ValueHolder.
+        ValueHolder find(const LongId& factoryIdentifier, VersionNumber version, const ValueHolder& input) const;
+
+        /// Store the output the processor produced for the input. The size should be an estimate of the memory used
+        /// by both the input and output. An entry which is larger than the whole budget is not stored.
+        void insert(const LongId& factoryIdentifier, VersionNumber version, const ValueHolder& input,
+                    const ValueHolder& output, std::size_t size) const;
+
+        std::size_t getNumEntries() const;
+
+        /// The sum of the sizes of the entries.
+        std::size_t getTotalSize() const;
+
+        void clear() const;
+
+      public:
+        ProcessorResultCache(const ProcessorResultCache&) = delete;
+        ProcessorResultCache& operator=(const ProcessorResultCache&) = delete;
+
+      private:
+        struct Key {
+            LongId m_factoryIdentifier;
+            VersionNumber m_version;
+            ValueHolder m_input;
+
+            bool operator==(const Key& other) const {
+                return (m_factoryIdentifier == other.m_factoryIdentifier) && (m_version == other.m_version) &&
+                       (m_input == other.m_input);
+            }
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        struct Entry {
+            Key m_key;
+            ValueHolder m_output;
+            std::size_t m_size;
+        };
+
+        /// Discard least recently used entries until the total size is at most the given size.
+        void evictUntil(std::size_t totalSize) const;
+
+      private:
+        const std::size_t m_maximumTotalSize;
+
+        mutable std::mutex m_mutex;
+        /// The most recently used entry is at the front.
+        mutable std::list<Entry> m_entries;
+        mutable std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_entryFromKey;
+        mutable std::size_t m_totalSize = 0;
+    };
+
+} // namespace babelwires
@@ -38,17 +38,14 @@ bool babelwires::RemoveAllEditsSubcommand::initializeAndExecute(Project& project
     }
 
     {
-        const Project::ConnectionInfo& connectionInfo = project.getConnectionInfo();
-        auto it = connectionInfo.m_requiredFor.find(nodeToModify);
-        if (it != connectionInfo.m_requiredFor.end()) {
-            for (auto&& connection : it->second) {
-                const ConnectionModifier* const cmod = std::get<0>(connection);
-                const ConnectionModifierData& modifierData = cmod->getModifierData();
-                const Path& modifierPath = modifierData.m_sourcePath;
-                if (m_path.isPrefixOf(modifierPath)) {
-                    const Node* const target = std::get<1>(connection);
-                    subcommands.emplace_back(std::make_unique<RemoveModifierCommand>("Remove modifier subcommand", target->getNodeId(), modifierData.m_targetPath));
-                }
+        const NodeGraph& graph = project.getNodeGraph();
+        for (const NodeGraph::Edge& edge : graph.getOutgoingEdges(graph.getSlot(m_nodeId))) {
+            const ConnectionModifier* const cmod = edge.m_connection;
+            const ConnectionModifierData& modifierData = cmod->getModifierData();
+            const Path& modifierPath = modifierData.m_sourcePath;
+            if (m_path.isPrefixOf(modifierPath)) {
+                const Node* const target = graph.getNode(edge.m_otherSlot);
+                subcommands.emplace_back(std::make_unique<RemoveModifierCommand>("Remove modifier subcommand", target->getNodeId(), modifierData.m_targetPath));
             }
         }
     }
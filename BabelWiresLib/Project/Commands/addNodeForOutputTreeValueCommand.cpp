@@ -76,16 +76,12 @@ void babelwires::AddNodeForOutputTreeValueCommand::execute(Project& project) con
     if (m_relationship == RelationshipToDependentNodes::NewParent) {
         std::vector<ConnectionTupleCopy> connectionsToAdjust;
 
-        const Project::ConnectionInfo& connectionInfo = project.getConnectionInfo();
-        const auto it = connectionInfo.m_requiredFor.find(originalNode);
-        if (it != connectionInfo.m_requiredFor.end()) {
-            const Project::ConnectionInfo::Connections& connections = it->second;
-            for (const auto& connectionTuple : connections) {
-                const ConnectionModifierData& connectionData = std::get<0>(connectionTuple)->getModifierData();
-                const NodeId nodeId = std::get<1>(connectionTuple)->getNodeId();
-                if (m_pathToValue.isPrefixOf(connectionData.m_sourcePath)) {
-                    connectionsToAdjust.emplace_back(ConnectionTupleCopy{connectionData, nodeId});
-                }
+        const NodeGraph& graph = project.getNodeGraph();
+        for (const NodeGraph::Edge& edge : graph.getOutgoingEdges(graph.getSlot(m_originalNodeId))) {
+            const ConnectionModifierData& connectionData = edge.m_connection->getModifierData();
+            const NodeId nodeId = graph.getNode(edge.m_otherSlot)->getNodeId();
+            if (m_pathToValue.isPrefixOf(connectionData.m_sourcePath)) {
+                connectionsToAdjust.emplace_back(ConnectionTupleCopy{connectionData, nodeId});
             }
         }
         for (auto& [connectionData, nodeId] : connectionsToAdjust) {
@@ -108,18 +104,13 @@ void babelwires::AddNodeForOutputTreeValueCommand::undo(Project& project) const
     if (m_relationship == RelationshipToDependentNodes::NewParent) {
         std::vector<ConnectionTupleCopy> connectionsToAdjust;
 
-        const Node* const newNode = project.getNode(m_newNodeId);
-        assert(newNode);
+        assert(project.getNode(m_newNodeId));
 
-        const Project::ConnectionInfo& connectionInfo = project.getConnectionInfo();
-        const auto it = connectionInfo.m_requiredFor.find(newNode);
-        if (it != connectionInfo.m_requiredFor.end()) {
-            const Project::ConnectionInfo::Connections& connections = it->second;
-            for (const auto& connectionTuple : connections) {
-                const ConnectionModifierData& connectionData = std::get<0>(connectionTuple)->getModifierData();
-                const NodeId nodeId = std::get<1>(connectionTuple)->getNodeId();
-                connectionsToAdjust.emplace_back(ConnectionTupleCopy{connectionData, nodeId});
-            }
+        const NodeGraph& graph = project.getNodeGraph();
+        for (const NodeGraph::Edge& edge : graph.getOutgoingEdges(graph.getSlot(m_newNodeId))) {
+            const ConnectionModifierData& connectionData = edge.m_connection->getModifierData();
+            const NodeId nodeId = graph.getNode(edge.m_otherSlot)->getNodeId();
+            connectionsToAdjust.emplace_back(ConnectionTupleCopy{connectionData, nodeId});
         }
         for (auto& [connectionData, nodeId] : connectionsToAdjust) {
             project.removeModifier(nodeId, connectionData.m_targetPath, false);
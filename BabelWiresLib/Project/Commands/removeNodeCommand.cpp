@@ -150,19 +150,15 @@ bool babelwires::RemoveNodeCommand::initialize(const Project& project) {
         m_nodesToRestore.emplace_back(std::move(newElementData));
     }
 
-    const Project::ConnectionInfo& connectionInfo = project.getConnectionInfo();
+    const NodeGraph& graph = project.getNodeGraph();
     for (auto elementId : m_nodeIds) {
-        const Node* node = project.getNode(elementId);
-        auto it = connectionInfo.m_requiredFor.find(node);
-        if (it != connectionInfo.m_requiredFor.end()) {
-            for (const auto& connection : it->second) {
-                const Node* const target = std::get<1>(connection);
-                const ConnectionModifier* const cmod = std::get<0>(connection);
-                const ConnectionModifierData& data = cmod->getModifierData();
-                ConnectionDescription connectionDesc(target->getNodeId(), data);
-                if (connectionsBeingRemoved.insert(connectionDesc).second) {
-                    m_connections.emplace_back(connectionDesc);
-                }
+        for (const NodeGraph::Edge& edge : graph.getOutgoingEdges(graph.getSlot(elementId))) {
+            const Node* const target = graph.getNode(edge.m_otherSlot);
+            const ConnectionModifier* const cmod = edge.m_connection;
+            const ConnectionModifierData& data = cmod->getModifierData();
+            ConnectionDescription connectionDesc(target->getNodeId(), data);
+            if (connectionsBeingRemoved.insert(connectionDesc).second) {
+                m_connections.emplace_back(connectionDesc);
             }
         }
     }
@@ -9,13 +9,24 @@
 
 #include <BabelWiresLib/Project/Nodes/node.hpp>
 #include <BabelWiresLib/Project/Modifiers/connectionModifierData.hpp>
+#include <BabelWiresLib/Project/project.hpp>
 #include <BabelWiresLib/ValueTree/valueTreeNode.hpp>
+#include <BabelWiresLib/ValueTree/valueTreeRoot.hpp>
 
 #include <BaseLib/Context/context.hpp>
 #include <BaseLib/Log/userLogger.hpp>
 
 #include <cassert>
 
+namespace {
+    std::uint64_t getStructureGenerationOfTree(const babelwires::ValueTreeNode* node) {
+        while (const babelwires::ValueTreeNode* owner = node->getOwner()) {
+            node = owner;
+        }
+        return node->as<babelwires::ValueTreeRoot>().getStructureGeneration();
+    }
+} // namespace
+
 babelwires::ConnectionModifier::ConnectionModifier(std::unique_ptr<ConnectionModifierData> moddata)
     : Modifier(std::move(moddata)) {}
 
@@ -47,24 +58,32 @@ void babelwires::ConnectionModifier::applyConnection(const Project& project, Use
     ValueTreeNode* target = nullptr;
 
     const babelwires::ConnectionModifierData& data = getModifierData();
-    const auto targetResult = data.getTarget(container);
-    if (!targetResult) {
-        userLogger.logError() << "Failed to apply operation: " << targetResult.error().toString();
-        setFailed(state, targetResult.error().toString());
-        return;
+    target = tryGetCachedTarget(container);
+    if (!target) {
+        const auto targetResult = data.getTarget(container);
+        if (!targetResult) {
+            userLogger.logError() << "Failed to apply operation: " << targetResult.error().toString();
+            setFailed(state, targetResult.error().toString());
+            return;
+        }
+        target = &*targetResult;
+        cacheTarget(container, target);
     }
-    target = &*targetResult;
     state = State::SourceMissing;
-    const auto sourceResult = data.getSourceTreeNode(project);
-    if (!sourceResult) {
-        userLogger.logError() << "Failed to apply operation: " << sourceResult.error().toString();
-        if (target) {
-            target->setToDefault();
+    const ValueTreeNode* source = tryGetCachedSource(project);
+    if (!source) {
+        const auto sourceResult = data.getSourceTreeNode(project);
+        if (!sourceResult) {
+            userLogger.logError() << "Failed to apply operation: " << sourceResult.error().toString();
+            if (target) {
+                target->setToDefault();
+            }
+            setFailed(state, sourceResult.error().toString());
+            return;
         }
-        setFailed(state, sourceResult.error().toString());
-        return;
+        source = &*sourceResult;
+        cacheSource(project, source);
     }
-    const ValueTreeNode* source = &*sourceResult;
     state = State::ApplicationFailed;
     const auto applyResult = data.apply(source, target, shouldForce);
     if (!applyResult) {
@@ -78,6 +97,54 @@ void babelwires::ConnectionModifier::applyConnection(const Project& project, Use
     setSucceeded();
 }
 
+babelwires::ValueTreeNode* babelwires::ConnectionModifier::tryGetCachedTarget(const ValueTreeNode* container) const {
+    if ((m_resolvedTarget.m_container != container) ||
+        (m_resolvedTarget.m_structureGeneration != getStructureGenerationOfTree(container)) ||
+        (m_resolvedTarget.m_targetPath != getModifierData().m_targetPath)) {
+        return nullptr;
+    }
+    return m_resolvedTarget.m_target;
+}
+
+const babelwires::ValueTreeNode* babelwires::ConnectionModifier::tryGetCachedSource(const Project& project) const {
+    const ConnectionModifierData& data = getModifierData();
+    if ((m_resolvedSource.m_project != &project) ||
+        (m_resolvedSource.m_nodesGeneration != project.getNodesGeneration()) ||
+        (m_resolvedSource.m_sourceId != data.m_sourceId)) {
+        return nullptr;
+    }
+    // The node is still owned by the project, so it is safe to query.
+    const ValueTreeNode* const output = m_resolvedSource.m_sourceNode->getOutput();
+    if ((m_resolvedSource.m_output != output) ||
+        (m_resolvedSource.m_structureGeneration != getStructureGenerationOfTree(output)) ||
+        (m_resolvedSource.m_sourcePath != data.m_sourcePath)) {
+        return nullptr;
+    }
+    return m_resolvedSource.m_source;
+}
+
+void babelwires::ConnectionModifier::cacheTarget(const ValueTreeNode* container, ValueTreeNode* target) {
+    m_resolvedTarget.m_container = container;
+    m_resolvedTarget.m_structureGeneration = getStructureGenerationOfTree(container);
+    m_resolvedTarget.m_targetPath = getModifierData().m_targetPath;
+    m_resolvedTarget.m_target = target;
+}
+
+void babelwires::ConnectionModifier::cacheSource(const Project& project, const ValueTreeNode* source) {
+    const ConnectionModifierData& data = getModifierData();
+    const Node* const sourceNode = project.getNode(data.m_sourceId);
+    assert(sourceNode && "The source was found, so its node must exist");
+    const ValueTreeNode* const output = sourceNode->getOutput();
+    m_resolvedSource.m_project = &project;
+    m_resolvedSource.m_nodesGeneration = project.getNodesGeneration();
+    m_resolvedSource.m_sourceId = data.m_sourceId;
+    m_resolvedSource.m_sourceNode = sourceNode;
+    m_resolvedSource.m_output = output;
+    m_resolvedSource.m_structureGeneration = getStructureGenerationOfTree(output);
+    m_resolvedSource.m_sourcePath = data.m_sourcePath;
+    m_resolvedSource.m_source = source;
+}
+
 bool babelwires::ConnectionModifier::isConnected() const {
     const State state = getState();
     return ((state == State::Success) || (state == State::ApplicationFailed));
@@ -90,7 +157,7 @@ void babelwires::ConnectionModifier::adjustSourceArrayIndices(const babelwires::
     if (pathToArray.isStrictPrefixOf(modifierPath)) {
         // Is the modifier affected?
         const unsigned int pathIndexOfStepIntoArray = pathToArray.getNumSteps();
-        babelwires::PathStep& stepIntoArray = modifierPath.getStep(pathIndexOfStepIntoArray);
+        const babelwires::PathStep& stepIntoArray = modifierPath.getStep(pathIndexOfStepIntoArray);
         if (stepIntoArray.isIndex()) {
             const babelwires::ArrayIndex arrayIndex = stepIntoArray.getIndex();
             if (arrayIndex >= startIndex) {
@@ -98,7 +165,7 @@ void babelwires::ConnectionModifier::adjustSourceArrayIndices(const babelwires::
                     setChanged(Changes::ModifierMoved);
                     getOwner()->setModifierMoving(*this);
                 }
-                stepIntoArray = arrayIndex + adjustment;
+                modifierPath.setStep(pathIndexOfStepIntoArray, arrayIndex + adjustment);
             }
         }
     }
@@ -8,7 +8,11 @@
 #pragma once
 
 #include <BabelWiresLib/babelWiresLibExport.hpp>
+#include <BabelWiresLib/Path/path.hpp>
 #include <BabelWiresLib/Project/Modifiers/modifier.hpp>
+#include <BabelWiresLib/Project/projectIds.hpp>
+
+#include <cstdint>
 
 namespace babelwires {
     struct UserLogger;
@@ -43,6 +47,43 @@ namespace babelwires {
 
       protected:
         const ConnectionModifier* doAsConnectionModifier() const override;
+
+      private:
+        /// Returns nullptr if the cached target cannot be used.
+        ValueTreeNode* tryGetCachedTarget(const ValueTreeNode* container) const;
+
+        /// Returns nullptr if the cached source cannot be used.
+        const ValueTreeNode* tryGetCachedSource(const Project& project) const;
+
+        void cacheTarget(const ValueTreeNode* container, ValueTreeNode* target);
+        void cacheSource(const Project& project, const ValueTreeNode* source);
+
+      private:
+        /// Following the paths to the target and source on every application is a significant cost in projects with
+        /// many connections, so the resolved nodes are cached. A cached node is only used while the data which
+        /// led to it and the structure of its tree are unchanged.
+        struct ResolvedTarget {
+            const ValueTreeNode* m_container = nullptr;
+            std::uint64_t m_structureGeneration = 0;
+            Path m_targetPath;
+            ValueTreeNode* m_target = nullptr;
+        };
+
+        /// See ResolvedTarget.
+        struct ResolvedSource {
+            const Project* m_project = nullptr;
+            std::uint64_t m_nodesGeneration = 0;
+            NodeId m_sourceId = INVALID_NODE_ID;
+            const Node* m_sourceNode = nullptr;
+            const ValueTreeNode* m_output = nullptr;
+            std::uint64_t m_structureGeneration = 0;
+            Path m_sourcePath;
+            const ValueTreeNode* m_source = nullptr;
+        };
+
+        /// These are not copied when the modifier is cloned.
+        ResolvedTarget m_resolvedTarget;
+        ResolvedSource m_resolvedSource;
     };
 
 } // namespace babelwires
@@ -125,14 +125,14 @@ void babelwires::Modifier::adjustArrayIndex(const babelwires::Path& pathToArray,
 
     assert(pathToArray.isStrictPrefixOf(modifierPath) && "This code only applies when the path is correct.");
     const unsigned int pathIndexOfStepIntoArray = pathToArray.getNumSteps();
-    babelwires::PathStep& stepIntoArray = modifierPath.getStep(pathIndexOfStepIntoArray);
+    const babelwires::PathStep& stepIntoArray = modifierPath.getStep(pathIndexOfStepIntoArray);
     auto index = stepIntoArray.getIndex();
     assert((index >= startIndex) && "This code only applies when the index is correct.");
     if (!isChanged(Changes::ModifierMoved)) {
         setChanged(Changes::ModifierMoved);
         getOwner()->setModifierMoving(*this);
     }
-    stepIntoArray = index + adjustment;
+    modifierPath.setStep(pathIndexOfStepIntoArray, index + adjustment);
 }
 
 const babelwires::ConnectionModifier* babelwires::Modifier::asConnectionModifier() const {
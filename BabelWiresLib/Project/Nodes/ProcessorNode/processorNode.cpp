@@ -12,6 +12,7 @@
 #include <BabelWiresLib/Processors/processor.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
 #include <BabelWiresLib/Processors/processorFactoryRegistry.hpp>
+#include <BabelWiresLib/Processors/processorResultCache.hpp>
 #include <BabelWiresLib/Project/Nodes/ProcessorNode/processorNodeData.hpp>
 #include <BabelWiresLib/Project/Modifiers/modifier.hpp>
 #include <BabelWiresLib/Project/Modifiers/modifierData.hpp>
@@ -39,6 +40,10 @@ babelwires::ProcessorNode::ProcessorNode(const Context& context, UserLogger& use
     auto newProcessor = factory.createNewProcessor(context);
     newProcessor->getInput().setToDefault();
     newProcessor->getOutput().setToDefault();
+    if (newProcessor->isOutputCacheable()) {
+        m_resultCache = context.tryGet<ProcessorResultCache>();
+        m_factoryVersion = factory.getVersion();
+    }
     setProcessor(std::move(newProcessor));
     setFactoryName(factory.getName());
 }
@@ -97,7 +102,23 @@ std::string babelwires::ProcessorNode::getRootLabel() const {
 void babelwires::ProcessorNode::doProcess(UserLogger& userLogger) {
     if (m_processor) {
         if (getInput()->isChanged(ValueTreeNode::Changes::SomethingChanged)) {
-            Result result = m_processor->process(userLogger);
+            ValueHolder cachedOutput;
+            if (m_resultCache) {
+                cachedOutput = m_resultCache->find(getNodeData().m_factoryIdentifier, m_factoryVersion,
+                                                   m_processor->getInput().getValue());
+            }
+            Result result;
+            if (cachedOutput) {
+                m_processor->restoreOutput(cachedOutput);
+            } else {
+                result = m_processor->process(userLogger);
+                if (result && m_resultCache) {
+                    m_resultCache->insert(getNodeData().m_factoryIdentifier, m_factoryVersion,
+                                          m_processor->getInput().getValue(), m_processor->getOutput().getValue(),
+                                          ProcessorResultCache::estimateSize(m_processor->getInput()) +
+                                              ProcessorResultCache::estimateSize(m_processor->getOutput()));
+                }
+            }
             if (result) {
                 if (isFailed()) {
                     clearInternalFailure();
@@ -10,12 +10,15 @@
 #include <BabelWiresLib/babelWiresLibExport.hpp>
 #include <BabelWiresLib/Project/Nodes/node.hpp>
 
+#include <BaseLib/common.hpp>
+
 namespace babelwires {
     struct UserLogger;
     class Context;
     struct ProcessorNodeData;
     class Processor;
     class ValueTreeRoot;
+    class ProcessorResultCache;
 
     class BABELWIRESLIB_API ProcessorNode : public Node {
       public:
@@ -42,6 +45,12 @@ namespace babelwires {
       private:
         std::unique_ptr<Processor> m_processor;
 
+        /// Non-null if a ProcessorResultCache is registered and the processor's output can be cached.
+        const ProcessorResultCache* m_resultCache = nullptr;
+
+        /// The version of the factory which created the processor, which is part of the cache key.
+        VersionNumber m_factoryVersion = 0;
+
         /// Non-null when the defined processor could not be constructed.
         std::unique_ptr<babelwires::ValueTreeRoot> m_failedValueTree;
     };
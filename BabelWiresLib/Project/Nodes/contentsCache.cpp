@@ -19,6 +19,9 @@
 
 #include <BaseLib/Identifiers/identifierRegistry.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <mutex>
 #include <unordered_set>
 
 babelwires::ContentsCacheEntry::ContentsCacheEntry(std::string label, const ValueTreeNode* input,
@@ -56,13 +59,16 @@ namespace babelwires {
     namespace Detail {
 
         struct ContentsCacheBuilder {
-            ContentsCacheBuilder(std::vector<ContentsCacheEntry>& rows, EditTree& edits)
+            ContentsCacheBuilder(std::vector<ContentsCacheEntry>& rows, std::vector<ContentsCache::LazyRun>& lazyRuns,
+                                 EditTree& edits)
                 : m_identifierRegistry(IdentifierRegistry::read())
                 , m_rows(rows)
+                , m_lazyRuns(lazyRuns)
                 , m_edits(edits) {}
 
             IdentifierRegistry::ReadAccess m_identifierRegistry;
             std::vector<ContentsCacheEntry>& m_rows;
+            std::vector<ContentsCache::LazyRun>& m_lazyRuns;
             /// Stack of generic types encountered when exploring the tree, as indices into m_rows
             std::vector<unsigned int> m_inputGenericTypeStack;
             /// Stack of generic types encountered when exploring the tree, as indices into m_rows
@@ -88,6 +94,46 @@ namespace babelwires {
                 int m_depthInUnassignedGenericTree = -1;
             };
 
+            // Rows without edits are assumed to be collapsed.
+            static_assert(!EditTree::c_expandedByDefault);
+
+            std::unordered_set<PathStep> getStepsToChildrenWithEdits(const Path& path) const {
+                const std::vector<PathStep> steps = m_edits.getStepsToChildrenWithEdits(path);
+                return {steps.begin(), steps.end()};
+            }
+
+            static bool isGenericType(const ValueTreeNode* valueTreeNode) {
+                return valueTreeNode && (valueTreeNode->getNumChildren() == GenericType::c_numChildren) &&
+                       valueTreeNode->getType()->tryAs<GenericType>();
+            }
+
+            /// The row of a child need not be stored if it has no edits at or beneath it (so it is collapsed and
+            /// unmodified) and it is not a generic type. The row of the parent must not be beneath a generic type
+            /// with unassigned type variables.
+            static bool canBeLazy(const ValueTreeNode* input, const ValueTreeNode* output, const PathStep& step,
+                                  const std::unordered_set<PathStep>& stepsWithEdits) {
+                return !stepsWithEdits.contains(step) && !isGenericType(input) && !isGenericType(output);
+            }
+
+            /// Add the row of a child to the open run of lazy rows, opening a new run if openRunIndex is -1.
+            /// The caller should set openRunIndex to -1 when it stores a row.
+            void addLazyRow(int& openRunIndex, int parentRowIndex, bool isOutputOnly, int childIndex,
+                            bool recordChildIndex) {
+                if (openRunIndex < 0) {
+                    openRunIndex = m_lazyRuns.size();
+                    ContentsCache::LazyRun& run = m_lazyRuns.emplace_back();
+                    run.m_parentRowIndex = parentRowIndex;
+                    run.m_position = m_rows.size();
+                    run.m_isOutputOnly = isOutputOnly;
+                    run.m_firstChildIndex = childIndex;
+                }
+                ContentsCache::LazyRun& run = m_lazyRuns[openRunIndex];
+                if (recordChildIndex) {
+                    run.m_childIndices.emplace_back(childIndex);
+                }
+                ++run.m_numRows;
+            }
+
             template <bool isInput>
             void markRowsWithUnassignedTypeVariables(unsigned int currentRowIndex, unsigned int levelsFromEnd) {
                 const unsigned int genericTypeStackSize =
@@ -177,10 +223,18 @@ namespace babelwires {
                 handleGenericInputTypes(valueTreeNode, numChildren, isExpanded, genericTypeInfo);
                 if (isExpanded) {
                     ++depth;
+                    const int rowIndex = m_rows.size() - 1;
+                    const bool canHaveLazyChildren = (genericTypeInfo.m_depthInUnassignedGenericTree < 0);
+                    const std::unordered_set<PathStep> stepsWithEdits = getStepsToChildrenWithEdits(path);
+                    int openRunIndex = -1;
                     for (int i = 0; i < valueTreeNode->getNumChildren(); ++i) {
                         const ValueTreeNode* child = valueTreeNode->getChild(i);
-                        // TODO Needless cost doing this.
-                        PathStep step = valueTreeNode->getStepToChild(child);
+                        const PathStep& step = valueTreeNode->getStepToChildAtIndex(i);
+                        if (canHaveLazyChildren && canBeLazy(child, nullptr, step, stepsWithEdits)) {
+                            addLazyRow(openRunIndex, rowIndex, false, i, false);
+                            continue;
+                        }
+                        openRunIndex = -1;
                         Path pathToChild = path;
                         pathToChild.pushStep(step);
                         std::ostringstream os;
@@ -201,10 +255,18 @@ namespace babelwires {
                 handleGenericOutputTypes(valueTreeNode, numChildren, isExpanded, genericTypeInfo);
                 if (isExpanded) {
                     ++depth;
+                    const int rowIndex = m_rows.size() - 1;
+                    const bool canHaveLazyChildren = (genericTypeInfo.m_depthInUnassignedGenericTree < 0);
+                    const std::unordered_set<PathStep> stepsWithEdits = getStepsToChildrenWithEdits(path);
+                    int openRunIndex = -1;
                     for (int i = 0; i < numChildren; ++i) {
                         const ValueTreeNode* child = valueTreeNode->getChild(i);
-                        // TODO Needless cost doing this.
-                        PathStep step = valueTreeNode->getStepToChild(child);
+                        const PathStep& step = valueTreeNode->getStepToChildAtIndex(i);
+                        if (canHaveLazyChildren && canBeLazy(nullptr, child, step, stepsWithEdits)) {
+                            addLazyRow(openRunIndex, rowIndex, true, i, false);
+                            continue;
+                        }
+                        openRunIndex = -1;
                         Path pathToChild = path;
                         pathToChild.pushStep(step);
                         std::ostringstream os;
@@ -230,13 +292,28 @@ namespace babelwires {
                 handleGenericOutputTypes(output, numOutputChildren, isExpanded, outputDepthInUnassignedGenericTree);
                 if (isExpanded) {
                     ++depth;
+                    const int rowIndex = m_rows.size() - 1;
+                    const bool canHaveLazyChildren =
+                        (inputDepthInUnassignedGenericTree.m_depthInUnassignedGenericTree < 0) &&
+                        (outputDepthInUnassignedGenericTree.m_depthInUnassignedGenericTree < 0);
+                    const std::unordered_set<PathStep> stepsWithEdits = getStepsToChildrenWithEdits(path);
+                    int openRunIndex = -1;
                     std::unordered_set<int> outputIndicesHandled;
                     for (int i = 0; i < input->getNumChildren(); ++i) {
-                        const ValueTreeNode* child = input->getChild(i);
-                        // TODO Needless cost doing this.
-                        PathStep step = input->getStepToChild(child);
-                        Path pathToChild = path;
+                        const PathStep& step = input->getStepToChildAtIndex(i);
                         const int outputChildIndex = output->getChildIndexFromStep(step);
+                        if (outputChildIndex >= 0) {
+                            outputIndicesHandled.insert(outputChildIndex);
+                        }
+                        if (canHaveLazyChildren &&
+                            canBeLazy(input->getChild(i),
+                                      (outputChildIndex >= 0) ? output->getChild(outputChildIndex) : nullptr, step,
+                                      stepsWithEdits)) {
+                            addLazyRow(openRunIndex, rowIndex, false, i, false);
+                            continue;
+                        }
+                        openRunIndex = -1;
+                        Path pathToChild = path;
                         pathToChild.pushStep(step);
                         std::ostringstream os;
                         step.writeToStreamReadable(os, *m_identifierRegistry);
@@ -244,17 +321,22 @@ namespace babelwires {
                             addFeatureToCache(os.str(), input->getChild(i), output->getChild(outputChildIndex),
                                               std::move(pathToChild), depth, indent, inputDepthInUnassignedGenericTree,
                                               outputDepthInUnassignedGenericTree);
-                            outputIndicesHandled.insert(outputChildIndex);
                         } else {
                             addInputFeatureToCache(os.str(), input->getChild(i), std::move(pathToChild), depth, indent,
                                                    inputDepthInUnassignedGenericTree);
                         }
                     }
+                    // The output-only children are not consecutive, so their runs record their indices.
+                    openRunIndex = -1;
                     for (int i = 0; i < output->getNumChildren(); ++i) {
                         if (outputIndicesHandled.find(i) == outputIndicesHandled.end()) {
                             const ValueTreeNode* child = output->getChild(i);
-                            // TODO Needless cost doing this.
-                            PathStep step = output->getStepToChild(child);
+                            const PathStep& step = output->getStepToChildAtIndex(i);
+                            if (canHaveLazyChildren && canBeLazy(nullptr, child, step, stepsWithEdits)) {
+                                addLazyRow(openRunIndex, rowIndex, true, i, true);
+                                continue;
+                            }
+                            openRunIndex = -1;
                             Path pathToChild = path;
                             pathToChild.pushStep(step);
                             std::ostringstream os;
@@ -283,10 +365,204 @@ namespace babelwires {
     } // namespace Detail
 } // namespace babelwires
 
+namespace babelwires {
+    namespace Detail {
+        /// The tree structure of the rows of a ContentsCache, which is implicit in their depths.
+        struct ContentsCacheRowTree {
+            ContentsCacheRowTree(const std::vector<ContentsCacheEntry>& rows)
+                : m_subtreeEnd(rows.size())
+                , m_parent(rows.size()) {
+                std::vector<int> ancestors;
+                for (int i = 0; i < rows.size(); ++i) {
+                    while (!ancestors.empty() && (rows[ancestors.back()].getDepth() >= rows[i].getDepth())) {
+                        m_subtreeEnd[ancestors.back()] = i;
+                        ancestors.pop_back();
+                    }
+                    m_parent[i] = ancestors.empty() ? -1 : ancestors.back();
+                    ancestors.emplace_back(i);
+                }
+                for (int i : ancestors) {
+                    m_subtreeEnd[i] = rows.size();
+                }
+            }
+
+            /// The index after the last row in the subtree at each row.
+            std::vector<int> m_subtreeEnd;
+
+            /// The index of the parent of each row, or -1 for the first row.
+            std::vector<int> m_parent;
+        };
+    } // namespace Detail
+} // namespace babelwires
+
+namespace {
+    using RowTree = babelwires::Detail::ContentsCacheRowTree;
+
+    /// Get the deepest row whose path is a prefix of the path.
+    int getDeepestVisibleRow(const std::vector<babelwires::ContentsCacheEntry>& rows, const RowTree& rowTree,
+                             const babelwires::Path& path) {
+        int rowIndex = 0;
+        for (const babelwires::PathStep& step : path.getSteps()) {
+            int childRowIndex = rowIndex + 1;
+            while ((childRowIndex < rowTree.m_subtreeEnd[rowIndex]) &&
+                   (rows[childRowIndex].getPath().getLastStep() != step)) {
+                childRowIndex = rowTree.m_subtreeEnd[childRowIndex];
+            }
+            if (childRowIndex == rowTree.m_subtreeEnd[rowIndex]) {
+                break;
+            }
+            rowIndex = childRowIndex;
+        }
+        return rowIndex;
+    }
+
+    bool isGenericTypeRow(const babelwires::ContentsCacheEntry& row) {
+        return (row.getInput() && row.getInput()->getType()->tryAs<babelwires::GenericType>()) ||
+               (row.getOutput() && row.getOutput()->getType()->tryAs<babelwires::GenericType>());
+    }
+
+    /// Sort the row indices and remove any which are in the subtree of another.
+    void removeNestedRows(const RowTree& rowTree, std::vector<int>& rowIndices) {
+        std::sort(rowIndices.begin(), rowIndices.end());
+        int endOfCurrentSubtree = 0;
+        auto it = std::remove_if(rowIndices.begin(), rowIndices.end(), [&](int rowIndex) {
+            if (rowIndex < endOfCurrentSubtree) {
+                return true;
+            }
+            endOfCurrentSubtree = rowTree.m_subtreeEnd[rowIndex];
+            return false;
+        });
+        rowIndices.erase(it, rowIndices.end());
+    }
+} // namespace
+
+bool babelwires::ContentsCache::doChildRowsMatch(const Detail::ContentsCacheRowTree& rowTree, int rowIndex) const {
+    // This checks the same sequence of children which the cache builder would produce.
+    const ContentsCacheEntry& row = m_rows[rowIndex];
+    const ValueTreeNode* const input = row.m_input;
+    const ValueTreeNode* const output = row.m_output;
+    const int subtreeEnd = rowTree.m_subtreeEnd[rowIndex];
+    int childRowIndex = rowIndex + 1;
+
+    // The lazy runs of the row, in the order of their rows.
+    auto runIt = std::lower_bound(m_lazyRunsFromParent.begin(), m_lazyRunsFromParent.end(),
+                                  std::make_pair(rowIndex, 0));
+    int numChildrenMatchedInRun = 0;
+
+    const auto matchNextChildRow = [&](const ValueTreeNode* inputChild, const ValueTreeNode* outputChild,
+                                       const PathStep& step, bool isOutputOnly, int childIndex) {
+        if ((runIt != m_lazyRunsFromParent.end()) && (runIt->first == rowIndex)) {
+            const LazyRun& run = m_lazyRuns[runIt->second];
+            if ((run.m_isOutputOnly == isOutputOnly) && (run.findChildIndex(childIndex) == numChildrenMatchedInRun)) {
+                // The builder would have to store the row if the child were now a generic type.
+                if ((run.m_position != childRowIndex) ||
+                    Detail::ContentsCacheBuilder::isGenericType(inputChild) ||
+                    Detail::ContentsCacheBuilder::isGenericType(outputChild)) {
+                    return false;
+                }
+                if (++numChildrenMatchedInRun == run.m_numRows) {
+                    ++runIt;
+                    numChildrenMatchedInRun = 0;
+                }
+                return true;
+            }
+        }
+        if (childRowIndex == subtreeEnd) {
+            return false;
+        }
+        const ContentsCacheEntry& childRow = m_rows[childRowIndex];
+        if ((childRow.m_input != inputChild) || (childRow.m_output != outputChild) ||
+            (childRow.m_path.getLastStep() != step)) {
+            return false;
+        }
+        childRowIndex = rowTree.m_subtreeEnd[childRowIndex];
+        return true;
+    };
+
+    if (input && output) {
+        std::vector<bool> outputIndicesHandled(output->getNumChildren(), false);
+        for (int i = 0; i < input->getNumChildren(); ++i) {
+            const PathStep& step = input->getStepToChildAtIndex(i);
+            const int outputChildIndex = output->getChildIndexFromStep(step);
+            const ValueTreeNode* outputChild = nullptr;
+            if (outputChildIndex >= 0) {
+                outputChild = output->getChild(outputChildIndex);
+                outputIndicesHandled[outputChildIndex] = true;
+            }
+            if (!matchNextChildRow(input->getChild(i), outputChild, step, false, i)) {
+                return false;
+            }
+        }
+        for (int i = 0; i < output->getNumChildren(); ++i) {
+            if (!outputIndicesHandled[i] &&
+                !matchNextChildRow(nullptr, output->getChild(i), output->getStepToChildAtIndex(i), true, i)) {
+                return false;
+            }
+        }
+    } else if (input) {
+        for (int i = 0; i < input->getNumChildren(); ++i) {
+            if (!matchNextChildRow(input->getChild(i), nullptr, input->getStepToChildAtIndex(i), false, i)) {
+                return false;
+            }
+        }
+    } else {
+        for (int i = 0; i < output->getNumChildren(); ++i) {
+            if (!matchNextChildRow(nullptr, output->getChild(i), output->getStepToChildAtIndex(i), true, i)) {
+                return false;
+            }
+        }
+    }
+    // All the stored rows and all the rows of the runs must have been matched.
+    return (childRowIndex == subtreeEnd) &&
+           ((runIt == m_lazyRunsFromParent.end()) || (runIt->first != rowIndex));
+}
+
+void babelwires::ContentsCache::findStructurallyChangedRows(const Detail::ContentsCacheRowTree& rowTree,
+                                                            int rowIndex, std::vector<int>& rowsToRebuildOut) const {
+    // A row is reused only if its features are known to be the ones it was built with: Either because their
+    // subtrees did not change since the rows were built, or because the rows of their parents were checked.
+    const ContentsCacheEntry& row = m_rows[rowIndex];
+    const bool inputChanged = row.m_input && (row.m_input->getStructureGeneration() > m_inputStructureGeneration);
+    const bool outputChanged =
+        row.m_output && (row.m_output->getStructureGeneration() > m_outputStructureGeneration);
+    if (!inputChanged && !outputChanged) {
+        return;
+    }
+    if (row.m_isExpanded && doChildRowsMatch(rowTree, rowIndex)) {
+        for (int childRowIndex = rowIndex + 1; childRowIndex < rowTree.m_subtreeEnd[rowIndex];
+             childRowIndex = rowTree.m_subtreeEnd[childRowIndex]) {
+            findStructurallyChangedRows(rowTree, childRowIndex, rowsToRebuildOut);
+        }
+    } else {
+        rowsToRebuildOut.emplace_back(rowIndex);
+    }
+}
+
 void babelwires::ContentsCache::setValueTrees(std::string rootLabel, const ValueTreeNode* input,
                                               const ValueTreeNode* output) {
+    assert((input || output) && "Invalid case");
+    m_lastUpdateStatistics = UpdateStatistics();
+    std::vector<Path> expandedPaths = m_edits.getAllExpandedPaths();
+    if (tryUpdateRows(input, output, expandedPaths)) {
+        m_rows[0].m_label = std::move(rootLabel);
+    } else {
+        rebuildRows(std::move(rootLabel), input, output);
+    }
+    m_inputStructureGeneration = input ? input->getStructureGeneration() : 0;
+    m_outputStructureGeneration = output ? output->getStructureGeneration() : 0;
+    m_expandedPaths = std::move(expandedPaths);
+    indexRows();
+    storeLazyRowsWithEdits();
+    setChanged(Changes::StructureChanged);
+    updateModifierFlags();
+    m_lastUpdateStatistics.m_numRowsStored = m_rows.size();
+}
+
+void babelwires::ContentsCache::rebuildRows(std::string rootLabel, const ValueTreeNode* input,
+                                            const ValueTreeNode* output) {
     m_rows.clear();
-    Detail::ContentsCacheBuilder builder(m_rows, m_edits);
+    m_lazyRuns.clear();
+    Detail::ContentsCacheBuilder builder(m_rows, m_lazyRuns, m_edits);
     if (input && output) {
         builder.addFeatureToCache(std::move(rootLabel), input, output, Path(), 0, 0,
                                   Detail::ContentsCacheBuilder::GenericTypeInfo(),
@@ -297,15 +573,174 @@ void babelwires::ContentsCache::setValueTrees(std::string rootLabel, const Value
     } else if (output) {
         builder.addOutputFeatureToCache(std::move(rootLabel), output, Path(), 0, 0,
                                         Detail::ContentsCacheBuilder::GenericTypeInfo());
-    } else {
-        assert(!"Invalid case");
     }
-    setChanged(Changes::StructureChanged);
-    updateModifierFlags();
+    m_lastUpdateStatistics.m_numRowsBuilt += m_rows.size();
+}
+
+bool babelwires::ContentsCache::tryUpdateRows(const ValueTreeNode* input, const ValueTreeNode* output,
+                                              const std::vector<Path>& expandedPaths) {
+    if (m_rows.empty() || (m_rows[0].m_input != input) || (m_rows[0].m_output != output)) {
+        return false;
+    }
+
+    const RowTree rowTree(m_rows);
+    std::vector<int> rowsToRebuild;
+
+    findStructurallyChangedRows(rowTree, 0, rowsToRebuild);
+
+    // Rows whose expansion state changed. If such a row is not visible, its closest visible ancestor is rebuilt.
+    std::vector<Path> pathsWithChangedExpansion;
+    std::set_symmetric_difference(m_expandedPaths.begin(), m_expandedPaths.end(), expandedPaths.begin(),
+                                  expandedPaths.end(), std::back_inserter(pathsWithChangedExpansion));
+    for (const Path& path : pathsWithChangedExpansion) {
+        rowsToRebuild.emplace_back(getDeepestVisibleRow(m_rows, rowTree, path));
+    }
+
+    if (rowsToRebuild.empty()) {
+        return true;
+    }
+
+    return rebuildSubtrees(std::move(rowsToRebuild));
+}
+
+bool babelwires::ContentsCache::rebuildSubtrees(std::vector<int> rowsToRebuild) {
+    const RowTree rowTree(m_rows);
+
+    // Rows beneath generic types are marked with respect to those generic types, so rebuild from the outermost
+    // generic type above a changed row.
+    // The features of a row are only known to be valid if the row is not beneath another row being rebuilt, so the
+    // nested rows are removed first.
+    removeNestedRows(rowTree, rowsToRebuild);
+    for (int& rowIndex : rowsToRebuild) {
+        for (int ancestorIndex = rowIndex; ancestorIndex >= 0; ancestorIndex = rowTree.m_parent[ancestorIndex]) {
+            if (isGenericTypeRow(m_rows[ancestorIndex])) {
+                rowIndex = ancestorIndex;
+            }
+        }
+    }
+    removeNestedRows(rowTree, rowsToRebuild);
+
+    if (rowsToRebuild[0] == 0) {
+        return false;
+    }
+
+    std::vector<ContentsCacheEntry> newRows;
+    newRows.reserve(m_rows.size());
+    std::vector<LazyRun> newLazyRuns;
+    // For each rebuilt subtree, the index after it in m_rows and the amount by which later indices move.
+    std::vector<std::pair<int, int>> shiftAfterSubtree;
+    int nextRowToCopy = 0;
+    for (int rowIndex : rowsToRebuild) {
+        std::move(m_rows.begin() + nextRowToCopy, m_rows.begin() + rowIndex, std::back_inserter(newRows));
+        const int numRowsBeforeSubtree = newRows.size();
+        const ContentsCacheEntry& row = m_rows[rowIndex];
+        // No generic types are above the row, so the builder starts with empty generic type information.
+        Detail::ContentsCacheBuilder builder(newRows, newLazyRuns, m_edits);
+        if (row.m_input && row.m_output) {
+            builder.addFeatureToCache(row.m_label, row.m_input, row.m_output, row.m_path, row.m_depth, row.m_indent,
+                                      Detail::ContentsCacheBuilder::GenericTypeInfo(),
+                                      Detail::ContentsCacheBuilder::GenericTypeInfo());
+        } else if (row.m_input) {
+            builder.addInputFeatureToCache(row.m_label, row.m_input, row.m_path, row.m_depth, row.m_indent,
+                                           Detail::ContentsCacheBuilder::GenericTypeInfo());
+        } else {
+            builder.addOutputFeatureToCache(row.m_label, row.m_output, row.m_path, row.m_depth, row.m_indent,
+                                            Detail::ContentsCacheBuilder::GenericTypeInfo());
+        }
+        m_lastUpdateStatistics.m_numRowsBuilt += newRows.size() - numRowsBeforeSubtree;
+        nextRowToCopy = rowTree.m_subtreeEnd[rowIndex];
+        shiftAfterSubtree.emplace_back(nextRowToCopy, static_cast<int>(newRows.size()) - nextRowToCopy);
+    }
+    std::move(m_rows.begin() + nextRowToCopy, m_rows.end(), std::back_inserter(newRows));
+
+    // Keep the lazy runs outside the rebuilt subtrees, adjusting their indices.
+    const auto getNewIndex = [&shiftAfterSubtree](int rowIndex) {
+        const auto it = std::upper_bound(shiftAfterSubtree.begin(), shiftAfterSubtree.end(), rowIndex,
+                                         [](int index, const std::pair<int, int>& shift) { return index < shift.first; });
+        return (it == shiftAfterSubtree.begin()) ? rowIndex : rowIndex + std::prev(it)->second;
+    };
+    for (LazyRun& run : m_lazyRuns) {
+        const auto it = std::upper_bound(rowsToRebuild.begin(), rowsToRebuild.end(), run.m_parentRowIndex);
+        if ((it != rowsToRebuild.begin()) && (run.m_parentRowIndex < rowTree.m_subtreeEnd[*std::prev(it)])) {
+            continue;
+        }
+        run.m_parentRowIndex = getNewIndex(run.m_parentRowIndex);
+        run.m_position = getNewIndex(run.m_position);
+        newLazyRuns.emplace_back(std::move(run));
+    }
+    // Runs at the same position end successively shallower subtrees. A row can have two runs at the same position
+    // (its last input children and its output-only children), whose order the stable sort preserves.
+    std::stable_sort(newLazyRuns.begin(), newLazyRuns.end(), [&newRows](const LazyRun& a, const LazyRun& b) {
+        if (a.m_position != b.m_position) {
+            return a.m_position < b.m_position;
+        }
+        return newRows[a.m_parentRowIndex].m_depth > newRows[b.m_parentRowIndex].m_depth;
+    });
+
+    m_rows.swap(newRows);
+    m_lazyRuns.swap(newLazyRuns);
+    return true;
+}
+
+void babelwires::ContentsCache::storeLazyRowsWithEdits() {
+    std::vector<int> rowsToRebuild;
+    for (auto it = m_lazyRunsFromParent.begin(); it != m_lazyRunsFromParent.end();) {
+        const int parentRowIndex = it->first;
+        for (const PathStep& step : m_edits.getStepsToChildrenWithEdits(m_rows[parentRowIndex].m_path)) {
+            int childIndex;
+            bool hasInput;
+            bool hasOutput;
+            if (findLazyRunContainingChild(parentRowIndex, step, childIndex, hasInput, hasOutput) >= 0) {
+                rowsToRebuild.emplace_back(parentRowIndex);
+                break;
+            }
+        }
+        while ((it != m_lazyRunsFromParent.end()) && (it->first == parentRowIndex)) {
+            ++it;
+        }
+    }
+    if (rowsToRebuild.empty()) {
+        return;
+    }
+    if (!rebuildSubtrees(std::move(rowsToRebuild))) {
+        const ContentsCacheEntry& rootRow = m_rows[0];
+        rebuildRows(rootRow.m_label, rootRow.m_input, rootRow.m_output);
+    }
+    indexRows();
+}
+
+void babelwires::ContentsCache::indexRows() {
+    int numLazyRows = 0;
+    m_lazyRunsFromParent.clear();
+    for (int i = 0; i < m_lazyRuns.size(); ++i) {
+        LazyRun& run = m_lazyRuns[i];
+        run.m_firstRow = run.m_position + numLazyRows;
+        numLazyRows += run.m_numRows;
+        m_lazyRunsFromParent.emplace_back(run.m_parentRowIndex, i);
+    }
+    std::sort(m_lazyRunsFromParent.begin(), m_lazyRunsFromParent.end());
+    m_numLazyRows = numLazyRows;
+
+    m_rowIndexFromPath.clear();
+    m_rowIndexFromPath.reserve(m_rows.size());
+    for (int i = 0; i < m_rows.size(); ++i) {
+        m_rowIndexFromPath.emplace(m_rows[i].m_path, i);
+    }
+
+    std::unique_lock lock(m_mutexForLazyEntries);
+    m_lazyEntries.clear();
+    m_lazyEntryOrder.clear();
 }
 
 void babelwires::ContentsCache::updateModifierCache() {
+    m_lastUpdateStatistics = UpdateStatistics();
+    storeLazyRowsWithEdits();
     updateModifierFlags();
+    m_lastUpdateStatistics.m_numRowsStored = m_rows.size();
+    // The entries of lazy rows take some flags from their parents.
+    std::unique_lock lock(m_mutexForLazyEntries);
+    m_lazyEntries.clear();
+    m_lazyEntryOrder.clear();
 }
 
 void babelwires::ContentsCache::updateModifierFlags() {
@@ -423,35 +858,168 @@ void babelwires::ContentsCache::updateModifierFlags() {
     }
 }
 
+int babelwires::ContentsCache::LazyRun::getChildIndex(int i) const {
+    assert((0 <= i) && (i < m_numRows));
+    return m_childIndices.empty() ? m_firstChildIndex + i : m_childIndices[i];
+}
+
+int babelwires::ContentsCache::LazyRun::findChildIndex(int childIndex) const {
+    if (m_childIndices.empty()) {
+        const int i = childIndex - m_firstChildIndex;
+        return ((0 <= i) && (i < m_numRows)) ? i : -1;
+    }
+    const auto it = std::lower_bound(m_childIndices.begin(), m_childIndices.end(), childIndex);
+    return ((it != m_childIndices.end()) && (*it == childIndex)) ? (it - m_childIndices.begin()) : -1;
+}
+
 const babelwires::ContentsCacheEntry* babelwires::ContentsCache::getEntry(int i) const {
-    if ((0 <= i) && (i < m_rows.size())) {
+    if ((i < 0) || (i >= getNumRows())) {
+        // TODO This is defensive. Is this necessary?
+        return nullptr;
+    }
+    // Find the last run which starts at or before the row.
+    const auto it = std::upper_bound(m_lazyRuns.begin(), m_lazyRuns.end(), i,
+                                     [](int row, const LazyRun& run) { return row < run.m_firstRow; });
+    if (it == m_lazyRuns.begin()) {
         return &m_rows[i];
     }
-    // TODO This is defensive. Is this necessary?
-    return nullptr;
+    const LazyRun& run = *std::prev(it);
+    const int endOfRun = run.m_firstRow + run.m_numRows;
+    if (i >= endOfRun) {
+        return &m_rows[i - (endOfRun - run.m_position)];
+    }
+    {
+        std::shared_lock lock(m_mutexForLazyEntries);
+        const auto entryIt = m_lazyEntries.find(i);
+        if (entryIt != m_lazyEntries.end()) {
+            return &entryIt->second;
+        }
+    }
+    ContentsCacheEntry entry = computeLazyEntry(run, i - run.m_firstRow);
+    std::unique_lock lock(m_mutexForLazyEntries);
+    const auto [entryIt, wasInserted] = m_lazyEntries.try_emplace(i, std::move(entry));
+    if (wasInserted) {
+        m_lazyEntryOrder.emplace_back(i);
+        if (m_lazyEntryOrder.size() > c_maximumNumLazyEntries) {
+            m_lazyEntries.erase(m_lazyEntryOrder.front());
+            m_lazyEntryOrder.pop_front();
+        }
+    }
+    return &entryIt->second;
+}
+
+babelwires::ContentsCacheEntry babelwires::ContentsCache::computeLazyEntry(const LazyRun& run, int i) const {
+    const ContentsCacheEntry& parentRow = m_rows[run.m_parentRowIndex];
+    const int childIndex = run.getChildIndex(i);
+    const ValueTreeNode* input = nullptr;
+    const ValueTreeNode* output = nullptr;
+    Path pathToChild = parentRow.m_path;
+    if (run.m_isOutputOnly) {
+        output = parentRow.m_output->getChild(childIndex);
+        pathToChild.pushStep(parentRow.m_output->getStepToChildAtIndex(childIndex));
+    } else {
+        input = parentRow.m_input->getChild(childIndex);
+        pathToChild.pushStep(parentRow.m_input->getStepToChildAtIndex(childIndex));
+        if (parentRow.m_output) {
+            const int outputChildIndex = parentRow.m_output->getChildIndexFromStep(pathToChild.getLastStep());
+            if (outputChildIndex >= 0) {
+                output = parentRow.m_output->getChild(outputChildIndex);
+            }
+        }
+    }
+    std::ostringstream os;
+    pathToChild.getLastStep().writeToStreamReadable(os, *IdentifierRegistry::read());
+    ContentsCacheEntry entry(os.str(), input, output, pathToChild, parentRow.m_depth + 1, parentRow.m_indent + 1);
+    entry.m_isExpandable = ((input ? input->getNumChildren() : 0) + (output ? output->getNumChildren() : 0)) > 0;
+    // The row has no edits, so it is collapsed and unmodified, and it is structurally editable unless its parent
+    // is beneath a connection.
+    entry.m_isStructureEditable = parentRow.m_isStructureEditable;
+    return entry;
 }
 
 int babelwires::ContentsCache::getNumRows() const {
-    return m_rows.size();
+    return m_rows.size() + m_numLazyRows;
 }
 
-int babelwires::ContentsCache::getIndexOfPath(bool seekInputFeature, const Path& path) const {
-    for (int i = 0; i < m_rows.size(); ++i) {
-        const ContentsCacheEntry& entry = m_rows[i];
-        if ((seekInputFeature && !entry.m_input) || (!seekInputFeature && !entry.m_output)) {
-            continue;
+int babelwires::ContentsCache::getVisibleIndexOfStoredRow(int rowIndex) const {
+    // Find the last run which precedes the row.
+    const auto it = std::upper_bound(m_lazyRuns.begin(), m_lazyRuns.end(), rowIndex,
+                                     [](int index, const LazyRun& run) { return index < run.m_position; });
+    if (it == m_lazyRuns.begin()) {
+        return rowIndex;
+    }
+    const LazyRun& run = *std::prev(it);
+    return rowIndex + (run.m_firstRow + run.m_numRows - run.m_position);
+}
+
+int babelwires::ContentsCache::findLazyRunContainingChild(int parentRowIndex, const PathStep& step,
+                                                          int& childIndexOut, bool& hasInputOut,
+                                                          bool& hasOutputOut) const {
+    const ContentsCacheEntry& parentRow = m_rows[parentRowIndex];
+    bool isOutputOnly = false;
+    int childIndex = parentRow.m_input ? parentRow.m_input->getChildIndexFromStep(step) : -1;
+    if (childIndex >= 0) {
+        hasInputOut = true;
+        hasOutputOut = parentRow.m_output && (parentRow.m_output->getChildIndexFromStep(step) >= 0);
+    } else {
+        childIndex = parentRow.m_output ? parentRow.m_output->getChildIndexFromStep(step) : -1;
+        if (childIndex < 0) {
+            return -1;
         }
-        if (path == m_rows[i].m_path) {
-            return i;
+        isOutputOnly = true;
+        hasInputOut = false;
+        hasOutputOut = true;
+    }
+    childIndexOut = childIndex;
+    for (auto it = std::lower_bound(m_lazyRunsFromParent.begin(), m_lazyRunsFromParent.end(),
+                                    std::make_pair(parentRowIndex, 0));
+         (it != m_lazyRunsFromParent.end()) && (it->first == parentRowIndex); ++it) {
+        const LazyRun& run = m_lazyRuns[it->second];
+        if ((run.m_isOutputOnly == isOutputOnly) && (run.findChildIndex(childIndex) >= 0)) {
+            return it->second;
         }
     }
     return -1;
 }
 
+int babelwires::ContentsCache::getIndexOfPath(bool seekInputFeature, const Path& path) const {
+    const auto it = m_rowIndexFromPath.find(path);
+    if (it != m_rowIndexFromPath.end()) {
+        const ContentsCacheEntry& entry = m_rows[it->second];
+        if ((seekInputFeature && !entry.m_input) || (!seekInputFeature && !entry.m_output)) {
+            return -1;
+        }
+        return getVisibleIndexOfStoredRow(it->second);
+    }
+    // The row may be lazy, in which case its parent is stored.
+    if (path.getNumSteps() == 0) {
+        return -1;
+    }
+    Path pathToParent = path;
+    pathToParent.popStep();
+    const auto parentIt = m_rowIndexFromPath.find(pathToParent);
+    if (parentIt == m_rowIndexFromPath.end()) {
+        return -1;
+    }
+    int childIndex;
+    bool hasInput;
+    bool hasOutput;
+    const int runIndex = findLazyRunContainingChild(parentIt->second, path.getLastStep(), childIndex, hasInput, hasOutput);
+    if ((runIndex < 0) || (seekInputFeature && !hasInput) || (!seekInputFeature && !hasOutput)) {
+        return -1;
+    }
+    const LazyRun& run = m_lazyRuns[runIndex];
+    return run.m_firstRow + run.findChildIndex(childIndex);
+}
+
 bool babelwires::ContentsCache::isChanged(Changes changes) const {
     return (m_changes & changes) != Changes::NothingChanged;
 }
 
+babelwires::ContentsCache::UpdateStatistics babelwires::ContentsCache::getLastUpdateStatistics() const {
+    return m_lastUpdateStatistics;
+}
+
 void babelwires::ContentsCache::clearChanges() {
     m_changes = Changes::NothingChanged;
 }
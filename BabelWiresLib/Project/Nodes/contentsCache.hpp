@@ -8,6 +8,9 @@
 #pragma once
 
 #include <BabelWiresLib/babelWiresLibExport.hpp>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -23,6 +26,7 @@ namespace babelwires {
 
     namespace Detail {
         struct ContentsCacheBuilder;
+        struct ContentsCacheRowTree;
     }
 
     /// The information cached about a single row in the contents of a Node.
@@ -122,6 +126,9 @@ namespace babelwires {
     /// A cache of the contents of a Node visible to the user.
     /// This is relevant only to the UI, but is included in the base library
     /// because the logic is independent of the particular UI framework.
+    /// Rows which carry no edits and are not expanded (for example, most of the entries of a large expanded array)
+    /// are not stored. Runs of such rows are recorded instead, and their entries are computed when requested, so the
+    /// cost of the cache depends on the rows which are displayed rather than the number of visible rows.
     class BABELWIRESLIB_API ContentsCache {
       public:
         /// The EditTree object is never replaced, so we can keep a reference.
@@ -131,6 +138,8 @@ namespace babelwires {
         ContentsCache(EditTree& edits);
 
         /// Build the cache with the given input and output features.
+        /// If the features are the ones the cache was last built with, only the rows of subtrees whose structure or
+        /// expansion changed since then are rebuilt.
         void setValueTrees(std::string rootName, const ValueTreeNode* input, const ValueTreeNode* output);
 
         /// Update the part of the cache concerning modifiers.
@@ -140,10 +149,16 @@ namespace babelwires {
         int getNumRows() const;
 
         /// Get the ith visible row.
+        /// The entry remains valid until the cache is next updated. The entry of a row which is not stored is
+        /// computed on demand, and also becomes invalid once c_maximumNumLazyEntries other such entries are computed.
         const ContentsCacheEntry* getEntry(int i) const;
 
+        /// The maximum number of entries of rows which are not stored that are kept between updates.
+        static constexpr std::size_t c_maximumNumLazyEntries = 1 << 12;
+
         /// Return the index if the path is in one of the visible rows.
         /// Otherwise return -1.
+        /// This does not depend on the number of visible rows.
         int getIndexOfPath(bool seekInputFeature, const Path& path) const;
 
         /// Describes the way a node may have changed.
@@ -161,22 +176,135 @@ namespace babelwires {
         /// Clear any changes the node is carrying.
         void clearChanges();
 
+        /// Information about the work done by the last update of the cache.
+        struct UpdateStatistics {
+            /// The number of rows which were stored by the update, including any whose subtrees were rebuilt.
+            int m_numRowsBuilt = 0;
+            /// The number of rows stored after the update.
+            int m_numRowsStored = 0;
+        };
+
+        /// Get information about the work done by the last call to setValueTrees or updateModifierCache.
+        UpdateStatistics getLastUpdateStatistics() const;
+
       private:
+        friend Detail::ContentsCacheBuilder;
+
+        /// A run of consecutive sibling rows which are not stored in m_rows.
+        /// The rows are children of the input feature of the parent row (paired with the corresponding children of
+        /// its output feature, if any), or children of its output feature which are not paired.
+        struct LazyRun {
+            /// The index in m_rows of the parent of the rows.
+            int m_parentRowIndex;
+
+            /// The number of rows in m_rows which precede the rows of the run.
+            int m_position;
+
+            /// Are the rows children of the output feature which are not paired with children of the input?
+            bool m_isOutputOnly;
+
+            /// The child index of the first row, when the child indices are consecutive.
+            int m_firstChildIndex;
+
+            /// The number of rows in the run.
+            int m_numRows = 0;
+
+            /// The child indices of the rows, when they are not consecutive. Otherwise empty.
+            std::vector<int> m_childIndices;
+
+            /// The index of the first row among the visible rows. Set once all the rows are built.
+            int m_firstRow = 0;
+
+            /// Get the child index of the ith row of the run.
+            int getChildIndex(int i) const;
+
+            /// Get the position of the child in the run, or -1 if it is not in the run.
+            int findChildIndex(int childIndex) const;
+        };
+
         /// Set flags recording a change.
         void setChanged(Changes changes);
 
+        /// Rebuild all the rows.
+        void rebuildRows(std::string rootLabel, const ValueTreeNode* input, const ValueTreeNode* output);
+
+        /// Rebuild the rows of subtrees which have changed since the rows were built, reusing the others.
+        /// Returns false if the rows cannot be updated this way.
+        bool tryUpdateRows(const ValueTreeNode* input, const ValueTreeNode* output,
+                           const std::vector<Path>& expandedPaths);
+
+        /// Do the stored rows and lazy runs of the children of the row correspond to the current children of its
+        /// features?
+        bool doChildRowsMatch(const Detail::ContentsCacheRowTree& rowTree, int rowIndex) const;
+
+        /// Find the rows whose subtrees need to be rebuilt because nodes were added to or removed from the features
+        /// beneath them.
+        void findStructurallyChangedRows(const Detail::ContentsCacheRowTree& rowTree, int rowIndex,
+                                         std::vector<int>& rowsToRebuildOut) const;
+
+        /// Rebuild the rows of the subtrees at the given indices of m_rows.
+        /// Returns false if the rows cannot be updated this way.
+        bool rebuildSubtrees(std::vector<int> rowsToRebuild);
+
+        /// Store any lazy rows which now carry edits.
+        void storeLazyRowsWithEdits();
+
+        /// Update the data used to find rows, once the rows have been built.
+        void indexRows();
+
+        /// Get the index of the stored row among the visible rows.
+        int getVisibleIndexOfStoredRow(int rowIndex) const;
+
+        /// Compute the entry of the ith row of the lazy run.
+        ContentsCacheEntry computeLazyEntry(const LazyRun& run, int i) const;
+
+        /// Return the index of the run containing the child of the row at the given step, or -1.
+        /// If the run is found, hasInputOut and hasOutputOut are set according to the features of the row.
+        int findLazyRunContainingChild(int parentRowIndex, const PathStep& step, int& childIndexOut, bool& hasInputOut,
+                                       bool& hasOutputOut) const;
+
         /// Update the flags for modifiers in the entries.
         void updateModifierFlags();
 
       private:
-        /// The rows of the contents. The first row may be hidden if there's no useful information there.
+        /// The stored rows of the contents, in the order they are displayed. The first row may be hidden if there's no
+        /// useful information there.
         std::vector<ContentsCacheEntry> m_rows;
 
+        /// The runs of rows which are not stored, ordered by their position among the visible rows.
+        std::vector<LazyRun> m_lazyRuns;
+
+        /// The total number of rows in m_lazyRuns.
+        int m_numLazyRows = 0;
+
+        /// The indices in m_rows of the stored rows.
+        std::unordered_map<Path, int> m_rowIndexFromPath;
+
+        /// Pairs of the index of a parent row and the index of one of its lazy runs, in order.
+        std::vector<std::pair<int, int>> m_lazyRunsFromParent;
+
+        /// The entries of lazy rows which have been requested, keyed by their visible index.
+        mutable std::unordered_map<int, ContentsCacheEntry> m_lazyEntries;
+        /// The keys of m_lazyEntries in the order they were added, so the oldest can be discarded.
+        mutable std::deque<int> m_lazyEntryOrder;
+        mutable std::shared_mutex m_mutexForLazyEntries;
+
         /// The edits carries the information about which nodes have been expanded.
         /// Non-const because the cache builder can encounter features whose style states that they are not collapsable
         /// (i.e. that they are expanded without required an edit) and we have to update the edit tree with that fact.
         EditTree& m_edits;
 
+        /// The structure generation of the input feature when the rows were built.
+        std::uint64_t m_inputStructureGeneration = 0;
+
+        /// The structure generation of the output feature when the rows were built.
+        std::uint64_t m_outputStructureGeneration = 0;
+
+        /// The paths which were expanded when the rows were built, in path order.
+        std::vector<Path> m_expandedPaths;
+
+        UpdateStatistics m_lastUpdateStatistics;
+
         Changes m_changes;
     };
 
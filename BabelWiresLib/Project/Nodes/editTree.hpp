@@ -13,6 +13,7 @@
 
 #include <BaseLib/common.hpp>
 
+#include <map>
 #include <memory>
 #include <type_traits>
 
@@ -21,7 +22,9 @@ namespace babelwires {
     class ConnectionModifier;
 
     /// Arranges edits (modifiers and expand/collapse) in a tree organized by paths.
-    /// All tree data is stored in one compact block, so it should be cheap to traverse assuming EditTrees are small.
+    /// The edits are stored in an ordered map keyed by path, so finding, adding and removing an edit is logarithmic in
+    /// the number of edits, and the edits of a subtree are contiguous in the map.
+    /// Nodes of the tree which carry no edit (because only their descendents do) are implicit.
     /// Management of the changes of the expansion state is done explicitly within the tree.
     class BABELWIRESLIB_API EditTree {
       public:
@@ -63,6 +66,12 @@ namespace babelwires {
         /// Return all the explicitly expanded paths in the tree.
         std::vector<Path> getAllExplicitlyExpandedPaths(const Path& path = Path()) const;
 
+        /// Return all the paths which are expanded, explicitly or implicitly, in path order.
+        std::vector<Path> getAllExpandedPaths() const;
+
+        /// Return the steps from the path to those of its children which have edits at or beneath them, in path order.
+        std::vector<PathStep> getStepsToChildrenWithEdits(const Path& path) const;
+
       public:
         // Iteration through the tree of nodes.
 
@@ -98,28 +107,10 @@ namespace babelwires {
         modifierRange(const Path& featurePath) const;
 
       private:
-        struct RootedPath;
-        struct RootedPathIterator;
-
-        struct BABELWIRESLIB_API FindNodeIndexResult {
-            int m_nodeIndex = -1;
-            /// If there is a missing child, this is the index where the missing child would be.
-            int m_missingChildIndex = -1;
-        };
-
-        /// A stack of indices which can be returned by findNodeIndex.
-        using AncestorStack = std::vector<std::uint16_t>;
-
-        /// Advance current along the nodes and return the index of the last node reached.
-        /// If ancestorStackOut is provided, the indices of the path will be pushed on.
-        FindNodeIndexResult findNodeIndex(RootedPathIterator& current, const RootedPathIterator& end,
-                                          AncestorStack* ancestorStackOut = nullptr) const;
-
         /// Check assertions about the validity of the tree.
         bool validateTree() const;
 
         template <typename EDIT_TREE, typename MODIFIER_TYPE> friend struct ModifierIterator;
-        template <typename EDIT_TREE, typename MODIFIER_TYPE> friend struct ModifierRange;
 
         struct TreeNode;
 
@@ -131,11 +122,6 @@ namespace babelwires {
         /// Remove the edit from the node at the path, allowing nodes to be removed.
         void removeEdit(const Path& featurePath, const EditNodeFunc& applyFunc);
 
-        using TreeNodeIndex = std::uint16_t;
-
-        /// Get the path of steps which leads to the node at the given index.
-        Path getPathToNode(TreeNodeIndex nodeIndex) const;
-
       public:
         /// This determines if the second or deeper levels are expanded by default.
         /// The first level is always expanded.
@@ -146,14 +132,10 @@ namespace babelwires {
         EditTree& operator=(const EditTree& other) = delete;
 
       private:
-        /// The data structure which carries the tree's data.
+        /// The data structure which carries the edits at a path.
         struct BABELWIRESLIB_API TreeNode {
-            /// Non-null for leaf nodes.
+            /// Non-null if there is a modifier at the path.
             std::unique_ptr<Modifier> m_modifier;
-            /// The step to this node from its parent.
-            PathStep m_step;
-            /// The total number of descendents of this node (not including this node).
-            std::uint16_t m_numDescendents = 0;
 
             /// Is the feature at this path expanded? (Compounds only.)
             bool m_isExpanded = c_expandedByDefault;
@@ -164,8 +146,7 @@ namespace babelwires {
             /// The feature at the path is not collapsible, so it should be treated as expanded without an edit.
             bool m_isImplicitlyExpanded = false;
 
-            /// Is this tree node needed, either because it has descendents or it
-            /// carries an edit?
+            /// Does this tree node carry an edit?
             bool isNeeded() const;
 
             TreeNode() = default;
@@ -175,9 +156,29 @@ namespace babelwires {
             TreeNode& operator=(TreeNode&& other) = default;
         };
 
-        /// Children follow immediately after their parent.
+        /// Stands for the position just after all the paths which have m_path as a prefix.
+        struct SubtreeEnd {
+            const Path& m_path;
+        };
+
+        /// Orders paths in path order. Since a path precedes its extensions, the paths of a subtree are contiguous.
+        struct BABELWIRESLIB_API PathOrder {
+            using is_transparent = void;
+            bool operator()(const Path& a, const Path& b) const;
+            bool operator()(const SubtreeEnd& a, const Path& b) const;
+            bool operator()(const Path& a, const SubtreeEnd& b) const;
+        };
+
+        using NodeMap = std::map<Path, TreeNode, PathOrder>;
+
+        /// The map iterator type used by iterators over the given EDIT_TREE type.
+        template <typename EDIT_TREE>
+        using NodeMapIterator =
+            std::conditional_t<std::is_const_v<EDIT_TREE>, NodeMap::const_iterator, NodeMap::iterator>;
+
+        /// Only paths which carry edits have entries.
         /// This is empty when there are no edits.
-        std::vector<TreeNode> m_nodes;
+        NodeMap m_nodes;
     };
 
 } // namespace babelwires
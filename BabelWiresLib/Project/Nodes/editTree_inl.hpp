@@ -6,55 +6,59 @@
  * Licensed under the GPLv3.0. See LICENSE file.
  **/
 
-/// Iterate over a RootedPath.
-struct BABELWIRESLIB_API babelwires::EditTree::RootedPathIterator {
-    void operator++();
-    bool operator==(const RootedPathIterator& other) const;
-    bool operator!=(const RootedPathIterator& other) const;
-    int distanceFrom(const RootedPathIterator& other) const;
-    PathStep operator*() const;
-
-    Path::const_iterator m_it;
-    bool m_isAtRoot;
-};
-
-/// Acts like the path it wraps, but has an extra "NotAStep" at the front to indicate
-/// the non-step to the root. This is a convenience structure which simplifies
-/// a lot of the EditTree code, since RootedPaths correspond in a nicer way to
-/// nodes of the EditTree.
-struct babelwires::EditTree::RootedPath {
-    RootedPath(const Path& path)
-        : m_path(path) {}
-    RootedPathIterator begin() const { return RootedPathIterator{m_path.begin(), true}; }
-    RootedPathIterator end() const { return RootedPathIterator{m_path.end(), false}; }
-    unsigned int getNumSteps() const { return m_path.getNumSteps() + 1; }
-
-    const Path& m_path;
-};
-
+/// Identifies a node of the tree by its path and the first entry in the map at or below that path.
+/// Since entries are in path order, the first entry serves as the position of the node in a preorder traversal.
 template <typename EDIT_TREE> struct babelwires::EditTree::Iterator {
     using EDIT_TREE_PARAM = EDIT_TREE;
+    using MapIterator = EditTree::NodeMapIterator<EDIT_TREE>;
 
-    Iterator(EDIT_TREE& tree, EditTree::TreeNodeIndex index, EditTree::TreeNodeIndex endIndex)
+    Iterator(EDIT_TREE& tree, MapIterator firstInSubtree, Path path)
         : m_tree(tree)
-        , m_index(index)
-        , m_endIndex(endIndex) {}
+        , m_firstInSubtree(firstInSubtree)
+        , m_path(std::move(path)) {}
+
+    Iterator(const Iterator& other) = default;
 
     Iterator& operator=(const Iterator& other) {
         assert((&m_tree == &other.m_tree) && "Cannot assign iterators from different trees");
-        m_index = other.m_index;
-        m_endIndex = other.m_endIndex;
+        m_firstInSubtree = other.m_firstInSubtree;
+        m_path = other.m_path;
         return *this;
     }
 
     /// May return nullptr.
-    typename CopyConst<EDIT_TREE, Modifier>::type* getModifier() { return m_tree.m_nodes[m_index].m_modifier.get(); }
+    typename CopyConst<EDIT_TREE, Modifier>::type* getModifier() {
+        if (m_firstInSubtree->first.getNumSteps() == m_path.getNumSteps()) {
+            return m_firstInSubtree->second.m_modifier.get();
+        }
+        return nullptr;
+    }
 
-    PathStep getStep() const { return m_tree.m_nodes[m_index].m_step; }
+    PathStep getStep() const { return (m_path.getNumSteps() > 0) ? m_path.getLastStep() : PathStep(); }
 
-    Iterator childrenBegin() const { return Iterator(m_tree, m_index + 1, m_endIndex); }
+    Iterator childrenBegin() const {
+        const unsigned int numSteps = m_path.getNumSteps();
+        MapIterator it = m_firstInSubtree;
+        if (it->first.getNumSteps() == numSteps) {
+            ++it;
+        }
+        if ((it != m_tree.m_nodes.end()) && m_path.isStrictPrefixOf(it->first)) {
+            return Iterator(m_tree, it, getPrefix(it->first, numSteps + 1));
+        }
+        // There are no children, so this is the position after the subtree.
+        return Iterator(m_tree, it, m_path);
+    }
 
-    void nextSibling() { m_index = m_index + m_tree.m_nodes[m_index].m_numDescendents + 1; }
+    void nextSibling() {
+        m_firstInSubtree = m_tree.m_nodes.upper_bound(SubtreeEnd{m_path});
+        const unsigned int numSteps = m_path.getNumSteps();
+        if ((numSteps > 0) && (m_firstInSubtree != m_tree.m_nodes.end())) {
+            const Path parentPath = getPrefix(m_path, numSteps - 1);
+            if (parentPath.isStrictPrefixOf(m_firstInSubtree->first)) {
+                m_path = getPrefix(m_firstInSubtree->first, numSteps);
+            }
+        }
+    }
 
     Iterator childrenEnd() const {
         Iterator ret = *this;
@@ -62,122 +66,109 @@ template <typename EDIT_TREE> struct babelwires::EditTree::Iterator {
         return ret;
     }
 
-    bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+    bool operator==(const Iterator& other) const { return m_firstInSubtree == other.m_firstInSubtree; }
     bool operator!=(const Iterator& other) const { return !(*this == other); }
 
+    static Path getPrefix(const Path& path, unsigned int numSteps) {
+        Path prefix = path;
+        prefix.truncate(numSteps);
+        return prefix;
+    }
+
     EDIT_TREE& m_tree;
-    EditTree::TreeNodeIndex m_index;
-    EditTree::TreeNodeIndex m_endIndex;
+    MapIterator m_firstInSubtree;
+    Path m_path;
 };
 
 template <typename EDIT_TREE, typename MODIFIER_TYPE> struct babelwires::EditTree::ModifierIterator {
     using EDIT_TREE_PARAM = EDIT_TREE;
+    using MapIterator = EditTree::NodeMapIterator<EDIT_TREE>;
 
-    ModifierIterator(EDIT_TREE& tree, EditTree::TreeNodeIndex index, EditTree::TreeNodeIndex endIndex)
+    ModifierIterator(EDIT_TREE& tree, MapIterator current, MapIterator end)
         : m_tree(tree)
-        , m_index(index)
-        , m_endIndex(endIndex) {
+        , m_current(current)
+        , m_end(end) {
         skipFilteredElements();
     }
 
     void skipFilteredElements() {
         // Skip over filtered modifiers.
-        while (m_index < m_endIndex) {
-            if (m_tree.m_nodes[m_index].m_modifier.get() != nullptr) {
+        while (m_current != m_end) {
+            if (m_current->second.m_modifier.get() != nullptr) {
                 static_assert(std::is_same_v<ConnectionModifier, std::remove_const_t<MODIFIER_TYPE>> ||
                               std::is_same_v<Modifier, std::remove_const_t<MODIFIER_TYPE>>);
                 if constexpr (std::is_same_v<ConnectionModifier, std::remove_const_t<MODIFIER_TYPE>>) {
-                    if (m_tree.m_nodes[m_index].m_modifier->asConnectionModifier()) {
+                    if (m_current->second.m_modifier->asConnectionModifier()) {
                         break;
                     }
                 } else {
                     break;
                 }
             }
-            ++m_index;
+            ++m_current;
         }
     }
 
     void operator++() {
-        ++m_index;
-        // Catch one possible misuse.
-        assert((m_tree.m_nodes.size() >= m_endIndex) && "Elements removed from EditTree during traversal");
+        ++m_current;
         skipFilteredElements();
     }
     typename CopyConst<EDIT_TREE, MODIFIER_TYPE>::type* operator*() {
-        auto* currentModifier = m_tree.m_nodes[m_index].m_modifier.get();
+        auto* currentModifier = m_current->second.m_modifier.get();
         assert(currentModifier->template tryAs<MODIFIER_TYPE>() && "The filter isn't working");
         return static_cast<MODIFIER_TYPE*>(currentModifier);
     }
 
-    bool operator==(const ModifierIterator& other) const { return m_index == other.m_index; }
+    bool operator==(const ModifierIterator& other) const { return m_current == other.m_current; }
     bool operator!=(const ModifierIterator& other) const { return !(*this == other); }
 
     EDIT_TREE& m_tree;
-    EditTree::TreeNodeIndex m_index;
-    EditTree::TreeNodeIndex m_endIndex;
+    MapIterator m_current;
+    MapIterator m_end;
 };
 
 template <typename ITERATOR> struct babelwires::EditTree::IteratorRange {
-    IteratorRange(typename ITERATOR::EDIT_TREE_PARAM& tree, EditTree::TreeNodeIndex index,
-                  EditTree::TreeNodeIndex endIndex)
+    using MapIterator = typename ITERATOR::MapIterator;
+
+    IteratorRange(typename ITERATOR::EDIT_TREE_PARAM& tree, MapIterator begin, MapIterator end)
         : m_tree(tree)
-        , m_index(index)
-        , m_endIndex(endIndex) {}
+        , m_begin(begin)
+        , m_end(end) {}
 
-    ITERATOR begin() { return {m_tree, m_index, m_endIndex}; }
+    ITERATOR begin() { return {m_tree, m_begin, m_end}; }
 
-    ITERATOR end() { return {m_tree, m_endIndex, m_endIndex}; }
+    ITERATOR end() { return {m_tree, m_end, m_end}; }
 
-    ITERATOR begin() const { return {m_tree, m_index, m_endIndex}; }
+    ITERATOR begin() const { return {m_tree, m_begin, m_end}; }
 
-    ITERATOR end() const { return {m_tree, m_endIndex, m_endIndex}; }
+    ITERATOR end() const { return {m_tree, m_end, m_end}; }
 
     typename ITERATOR::EDIT_TREE_PARAM& m_tree;
-    const EditTree::TreeNodeIndex m_index;
-    const EditTree::TreeNodeIndex m_endIndex;
+    const MapIterator m_begin;
+    const MapIterator m_end;
 };
 
 template <typename MODIFIER_TYPE>
 babelwires::EditTree::IteratorRange<babelwires::EditTree::ModifierIterator<babelwires::EditTree, MODIFIER_TYPE>>
 babelwires::EditTree::modifierRange() {
-    return {*this, 0, static_cast<TreeNodeIndex>(m_nodes.size())};
+    return {*this, m_nodes.begin(), m_nodes.end()};
 }
 
 template <typename MODIFIER_TYPE>
 babelwires::EditTree::IteratorRange<babelwires::EditTree::ModifierIterator<const babelwires::EditTree, MODIFIER_TYPE>>
 babelwires::EditTree::modifierRange() const {
-    return {*this, 0, static_cast<TreeNodeIndex>(m_nodes.size())};
+    return {*this, m_nodes.begin(), m_nodes.end()};
 }
 
 template <typename MODIFIER_TYPE>
 babelwires::EditTree::IteratorRange<babelwires::EditTree::ModifierIterator<babelwires::EditTree, MODIFIER_TYPE>>
 babelwires::EditTree::modifierRange(const Path& path) {
-    RootedPath featurePath(path);
-    auto it = featurePath.begin();
-    const auto end = featurePath.end();
-
-    const auto [beginIndex, _] = findNodeIndex(it, end);
-    if (it == featurePath.end()) {
-        const TreeNodeIndex endIndex = beginIndex + m_nodes[beginIndex].m_numDescendents + 1;
-        return {*this, static_cast<TreeNodeIndex>(beginIndex), endIndex};
-    } else {
-        return {*this, 0, 0};
-    }
+    // The range is empty if there are no edits at or below the path.
+    return {*this, m_nodes.lower_bound(path), m_nodes.upper_bound(SubtreeEnd{path})};
 }
 
 template <typename MODIFIER_TYPE>
 babelwires::EditTree::IteratorRange<babelwires::EditTree::ModifierIterator<const babelwires::EditTree, MODIFIER_TYPE>>
 babelwires::EditTree::modifierRange(const Path& path) const {
-    RootedPath featurePath(path);
-    auto it = featurePath.begin();
-    const auto end = featurePath.end();
-
-    const auto [beginIndex, _] = findNodeIndex(it, end);
-    if (it == featurePath.end()) {
-        const TreeNodeIndex endIndex = beginIndex + m_nodes[beginIndex].m_numDescendents + 1;
-        return {*this, static_cast<TreeNodeIndex>(beginIndex), endIndex};
-    } else {
-        return {*this, 0, 0};
-    }
+    return {*this, m_nodes.lower_bound(path), m_nodes.upper_bound(SubtreeEnd{path})};
 }
@@ -307,34 +307,18 @@ void babelwires::Node::setModifierMoving(const babelwires::Modifier& modifierAbo
 
 void babelwires::Node::modifyValueAt(ValueTreeNode* input, const Path& path) {
     assert((input != nullptr) && "Trying to modify a node with no input feature");
-
-    unsigned int j = 0;
-    for (unsigned int i = 0; i < m_modifiedPaths.size(); ++i) {
-        const auto& p = m_modifiedPaths[i];
-        if (p.isPrefixOf(path)) {
-            assert(i == j);
-            return;
-        }
-        if (path.isPrefixOf(p)) {
-            // Remove the path at i by not incrementing j in this iteration.
-        } else {
-            // Keep this path.
-            if (j < i) {
-                m_modifiedPaths[j] = m_modifiedPaths[i];
-            }
-            ++j;
-        }
-    }
-    m_modifiedPaths.resize(j);
-    m_modifiedPaths.emplace_back(path);
+    m_modifiedPaths.add(path);
 }
 
 void babelwires::Node::finishModifications(const Project& project, UserLogger& userLogger) {
+    if (m_modifiedPaths.isEmpty()) {
+        return;
+    }
+    // Get the input feature directly.
+    ValueTreeNode* input = doGetInputNonConst();
     // Reapply modifiers beneath the modified paths.
-    for (const auto& p : m_modifiedPaths) {
-        // Get the input feature directly.
-        ValueTreeNode* input = doGetInputNonConst();
-        // First, apply any other modifiers which apply beneath the path
+    // The paths are disjoint subtrees in path order, so this is a single pass through the edits in path order.
+    for (const Path& p : m_modifiedPaths.getPaths()) {
         for (auto it : m_edits.modifierRange(p)) {
             if (const auto& connection = it->tryAs<ConnectionModifier>()) {
                 // We force connections in this case.
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <BabelWiresLib/babelWiresLibExport.hpp>
+#include <BabelWiresLib/Path/pathSubtreeSet.hpp>
 #include <BabelWiresLib/Project/Nodes/contentsCache.hpp>
 #include <BabelWiresLib/Project/Nodes/editTree.hpp>
 #include <BabelWiresLib/Project/projectIds.hpp>
@@ -235,7 +236,7 @@ namespace babelwires {
 
         /// After modifications to compounds, modifiers need to be reapplied.
         /// This records the paths at which that should happen.
-        std::vector<Path> m_modifiedPaths;
+        PathSubtreeSet m_modifiedPaths;
 
         ContentsCache m_contentsCache;
     };
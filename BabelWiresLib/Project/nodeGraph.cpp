@@ -0,0 +1,372 @@
+/**
+ * The NodeGraph assigns the Nodes of a project dense slots and stores the connections between them by slot.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <BabelWiresLib/Project/nodeGraph.hpp>
+
+#include <BabelWiresLib/Project/Nodes/node.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+babelwires::NodeGraph::Slot babelwires::NodeGraph::addNode(Node* node) {
+    assert(node && "Cannot add a null node");
+    Slot slot;
+    if (m_freeSlots.empty()) {
+        slot = getNumSlots();
+        m_nodeFromSlot.emplace_back(node);
+        // A node without connections can go anywhere in the order.
+        m_positionFromSlot.emplace_back(static_cast<std::uint32_t>(m_slotFromPosition.size()));
+        m_slotFromPosition.emplace_back(slot);
+        m_isVisited.emplace_back(false);
+    } else {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_nodeFromSlot[slot] = node;
+    }
+    m_incoming.resetSlot(slot);
+    m_outgoing.resetSlot(slot);
+    [[maybe_unused]] const bool wasInserted = m_slotFromNodeId.insert(std::make_pair(node->getNodeId(), slot)).second;
+    assert(wasInserted && "A node with the same id is already in the graph");
+    return slot;
+}
+
+void babelwires::NodeGraph::removeNode(Slot slot) {
+    Node* const node = m_nodeFromSlot[slot];
+    assert(node && "The slot is not in use");
+    assert(!m_incoming.hasEdges(slot) && !m_outgoing.hasEdges(slot) &&
+           "The connections of a node must be removed before the node");
+    m_slotFromNodeId.erase(node->getNodeId());
+    m_nodeFromSlot[slot] = nullptr;
+    m_incoming.resetSlot(slot);
+    m_outgoing.resetSlot(slot);
+    m_freeSlots.emplace_back(slot);
+}
+
+babelwires::NodeGraph::Slot babelwires::NodeGraph::getSlot(NodeId nodeId) const {
+    const auto it = m_slotFromNodeId.find(nodeId);
+    return (it != m_slotFromNodeId.end()) ? it->second : c_invalidSlot;
+}
+
+void babelwires::NodeGraph::addConnection(Slot sourceSlot, Slot targetSlot, ConnectionModifier* connection) {
+    assert(m_nodeFromSlot[sourceSlot] && m_nodeFromSlot[targetSlot] && "A connection must be between nodes in the graph");
+    const bool closesLoop = !tryToOrder(sourceSlot, targetSlot);
+    const std::uint32_t outgoingIndex = m_outgoing.addEdge(sourceSlot, Edge{connection, targetSlot});
+    const std::uint32_t incomingIndex = m_incoming.addEdge(targetSlot, Edge{connection, sourceSlot});
+    [[maybe_unused]] const bool wasInserted =
+        m_connections
+            .insert(std::make_pair(connection, ConnectionEntry{sourceSlot, targetSlot, outgoingIndex, incomingIndex}))
+            .second;
+    assert(wasInserted && "The connection is already in the graph");
+    if (closesLoop) {
+        setClosesLoop(m_connections.find(connection)->second, true);
+        m_loopConnections.emplace_back(connection);
+    }
+}
+
+void babelwires::NodeGraph::removeConnection(const ConnectionModifier* connection) {
+    const auto it = m_connections.find(connection);
+    assert((it != m_connections.end()) && "Cannot find the connection to remove");
+    const ConnectionEntry entry = it->second;
+    const bool closedLoop = m_outgoing.getEdge(entry.m_sourceSlot, entry.m_outgoingIndex).m_closesLoop;
+    m_connections.erase(it);
+    m_outgoing.removeEdge(entry.m_sourceSlot, entry.m_outgoingIndex);
+    updateOutgoingIndices(entry.m_sourceSlot, entry.m_outgoingIndex);
+    m_incoming.removeEdge(entry.m_targetSlot, entry.m_incomingIndex);
+    updateIncomingIndices(entry.m_targetSlot, entry.m_incomingIndex);
+    if (closedLoop) {
+        m_loopConnections.erase(std::find(m_loopConnections.begin(), m_loopConnections.end(), connection));
+    } else if (!m_loopConnections.empty()) {
+        // The removed connection may have been part of the loops.
+        tryToOrderLoopConnections();
+    }
+}
+
+void babelwires::NodeGraph::updateOutgoingIndices(Slot slot, std::uint32_t fromIndex) {
+    const std::span<const Edge> edges = m_outgoing.getEdges(slot);
+    for (std::uint32_t i = fromIndex; i < edges.size(); ++i) {
+        m_connections.find(edges[i].m_connection)->second.m_outgoingIndex = i;
+    }
+}
+
+void babelwires::NodeGraph::updateIncomingIndices(Slot slot, std::uint32_t fromIndex) {
+    const std::span<const Edge> edges = m_incoming.getEdges(slot);
+    for (std::uint32_t i = fromIndex; i < edges.size(); ++i) {
+        m_connections.find(edges[i].m_connection)->second.m_incomingIndex = i;
+    }
+}
+
+bool babelwires::NodeGraph::hasConnection(const ConnectionModifier* connection) const {
+    return m_connections.find(connection) != m_connections.end();
+}
+
+std::vector<babelwires::NodeGraph::Slot> babelwires::NodeGraph::getSlotsInDependencyLoops() const {
+    std::vector<Slot> slotsInLoops;
+    if (m_loopConnections.empty()) {
+        return slotsInLoops;
+    }
+    // Every loop includes a connection which closes a loop, since the other connections respect the order.
+    // A slot is on a loop through the connection if the target of the connection reaches it and it reaches the
+    // source.
+    std::vector<bool> isInLoop(getNumSlots(), false);
+    std::vector<bool> reachesSource(getNumSlots(), false);
+    std::vector<bool> isReachedFromTarget(getNumSlots(), false);
+    for (const ConnectionModifier* connection : m_loopConnections) {
+        const ConnectionEntry& entry = m_connections.find(connection)->second;
+
+        // These vectors double as stacks.
+        std::vector<Slot> slotsReachingSource{entry.m_sourceSlot};
+        reachesSource[entry.m_sourceSlot] = true;
+        for (std::size_t i = 0; i < slotsReachingSource.size(); ++i) {
+            for (const Edge& edge : getIncomingEdges(slotsReachingSource[i])) {
+                if (!reachesSource[edge.m_otherSlot]) {
+                    reachesSource[edge.m_otherSlot] = true;
+                    slotsReachingSource.emplace_back(edge.m_otherSlot);
+                }
+            }
+        }
+
+        // Every slot on a path from the target to the source reaches the source.
+        std::vector<Slot> slotsOnLoop{entry.m_targetSlot};
+        isReachedFromTarget[entry.m_targetSlot] = true;
+        for (std::size_t i = 0; i < slotsOnLoop.size(); ++i) {
+            isInLoop[slotsOnLoop[i]] = true;
+            for (const Edge& edge : getOutgoingEdges(slotsOnLoop[i])) {
+                if (reachesSource[edge.m_otherSlot] && !isReachedFromTarget[edge.m_otherSlot]) {
+                    isReachedFromTarget[edge.m_otherSlot] = true;
+                    slotsOnLoop.emplace_back(edge.m_otherSlot);
+                }
+            }
+        }
+
+        for (Slot slot : slotsReachingSource) {
+            reachesSource[slot] = false;
+        }
+        for (Slot slot : slotsOnLoop) {
+            isReachedFromTarget[slot] = false;
+        }
+    }
+    for (Slot slot = 0; slot < getNumSlots(); ++slot) {
+        if (isInLoop[slot]) {
+            slotsInLoops.emplace_back(slot);
+        }
+    }
+    return slotsInLoops;
+}
+
+bool babelwires::NodeGraph::tryToOrder(Slot sourceSlot, Slot targetSlot) {
+    if (sourceSlot == targetSlot) {
+        return false;
+    }
+    const std::uint32_t lowerBound = m_positionFromSlot[targetSlot];
+    const std::uint32_t upperBound = m_positionFromSlot[sourceSlot];
+    if (upperBound < lowerBound) {
+        return true;
+    }
+
+    const auto clearVisited = [this]() {
+        for (Slot slot : m_forwardSlots) {
+            m_isVisited[slot] = false;
+        }
+        for (Slot slot : m_backwardSlots) {
+            m_isVisited[slot] = false;
+        }
+        m_forwardSlots.clear();
+        m_backwardSlots.clear();
+    };
+
+    // Find the slots reachable from the target which are not after the source.
+    // These slots are added to their vector when visited, so the vector doubles as the stack.
+    m_isVisited[targetSlot] = true;
+    m_forwardSlots.emplace_back(targetSlot);
+    for (std::size_t i = 0; i < m_forwardSlots.size(); ++i) {
+        for (const Edge& edge : getOutgoingEdges(m_forwardSlots[i])) {
+            if (edge.m_closesLoop) {
+                continue;
+            }
+            const std::uint32_t position = m_positionFromSlot[edge.m_otherSlot];
+            if (position == upperBound) {
+                // The target reaches the source, so the connection would close a loop.
+                clearVisited();
+                return false;
+            }
+            if ((position < upperBound) && !m_isVisited[edge.m_otherSlot]) {
+                m_isVisited[edge.m_otherSlot] = true;
+                m_forwardSlots.emplace_back(edge.m_otherSlot);
+            }
+        }
+    }
+
+    // Find the slots which reach the source and are not before the target.
+    m_isVisited[sourceSlot] = true;
+    m_backwardSlots.emplace_back(sourceSlot);
+    for (std::size_t i = 0; i < m_backwardSlots.size(); ++i) {
+        for (const Edge& edge : getIncomingEdges(m_backwardSlots[i])) {
+            if (edge.m_closesLoop) {
+                continue;
+            }
+            const std::uint32_t position = m_positionFromSlot[edge.m_otherSlot];
+            if ((position > lowerBound) && !m_isVisited[edge.m_otherSlot]) {
+                m_isVisited[edge.m_otherSlot] = true;
+                m_backwardSlots.emplace_back(edge.m_otherSlot);
+            }
+        }
+    }
+
+    // Reuse the positions of the visited slots, putting the backward slots before the forward slots.
+    const auto byPosition = [this](Slot a, Slot b) { return m_positionFromSlot[a] < m_positionFromSlot[b]; };
+    std::sort(m_forwardSlots.begin(), m_forwardSlots.end(), byPosition);
+    std::sort(m_backwardSlots.begin(), m_backwardSlots.end(), byPosition);
+    m_positions.clear();
+    for (Slot slot : m_backwardSlots) {
+        m_positions.emplace_back(m_positionFromSlot[slot]);
+    }
+    for (Slot slot : m_forwardSlots) {
+        m_positions.emplace_back(m_positionFromSlot[slot]);
+    }
+    std::sort(m_positions.begin(), m_positions.end());
+    std::size_t i = 0;
+    for (Slot slot : m_backwardSlots) {
+        m_positionFromSlot[slot] = m_positions[i];
+        m_slotFromPosition[m_positions[i]] = slot;
+        ++i;
+    }
+    for (Slot slot : m_forwardSlots) {
+        m_positionFromSlot[slot] = m_positions[i];
+        m_slotFromPosition[m_positions[i]] = slot;
+        ++i;
+    }
+    clearVisited();
+    return true;
+}
+
+void babelwires::NodeGraph::setClosesLoop(const ConnectionEntry& entry, bool closesLoop) {
+    m_outgoing.getEdge(entry.m_sourceSlot, entry.m_outgoingIndex).m_closesLoop = closesLoop;
+    m_incoming.getEdge(entry.m_targetSlot, entry.m_incomingIndex).m_closesLoop = closesLoop;
+}
+
+void babelwires::NodeGraph::tryToOrderLoopConnections() {
+    for (std::size_t i = 0; i < m_loopConnections.size();) {
+        const ConnectionEntry& entry = m_connections.find(m_loopConnections[i])->second;
+        if (tryToOrder(entry.m_sourceSlot, entry.m_targetSlot)) {
+            setClosesLoop(entry, false);
+            m_loopConnections[i] = m_loopConnections.back();
+            m_loopConnections.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void babelwires::NodeGraph::clear() {
+    m_nodeFromSlot.clear();
+    m_freeSlots.clear();
+    m_slotFromNodeId.clear();
+    m_incoming.clear();
+    m_outgoing.clear();
+    m_connections.clear();
+    m_slotFromPosition.clear();
+    m_positionFromSlot.clear();
+    m_loopConnections.clear();
+    m_isVisited.clear();
+}
+
+void babelwires::NodeGraph::validate() const {
+#ifndef NDEBUG
+    assert((m_slotFromNodeId.size() + m_freeSlots.size() == m_nodeFromSlot.size()) && "Every slot is used or free");
+    for (const auto& [nodeId, slot] : m_slotFromNodeId) {
+        assert(m_nodeFromSlot[slot] && (m_nodeFromSlot[slot]->getNodeId() == nodeId) && "The slot map is inconsistent");
+    }
+    std::size_t numOutgoing = 0;
+    std::size_t numIncoming = 0;
+    for (Slot slot = 0; slot < getNumSlots(); ++slot) {
+        assert((m_nodeFromSlot[slot] || (!m_incoming.hasEdges(slot) && !m_outgoing.hasEdges(slot))) &&
+               "A free slot has edges");
+        numOutgoing += getOutgoingEdges(slot).size();
+        numIncoming += getIncomingEdges(slot).size();
+    }
+    assert((numOutgoing == m_connections.size()) && (numIncoming == m_connections.size()) &&
+           "The edges do not match the connections");
+    for (Slot slot = 0; slot < getNumSlots(); ++slot) {
+        assert((m_slotFromPosition[m_positionFromSlot[slot]] == slot) && "The order is not a permutation of the slots");
+    }
+    std::size_t numLoopConnections = 0;
+    for (const auto& [connection, entry] : m_connections) {
+        const Edge& outgoing = getOutgoingEdges(entry.m_sourceSlot)[entry.m_outgoingIndex];
+        assert((outgoing.m_connection == connection) && (outgoing.m_otherSlot == entry.m_targetSlot) &&
+               "The outgoing edge is not where expected");
+        const Edge& incoming = getIncomingEdges(entry.m_targetSlot)[entry.m_incomingIndex];
+        assert((incoming.m_connection == connection) && (incoming.m_otherSlot == entry.m_sourceSlot) &&
+               "The incoming edge is not where expected");
+        assert((outgoing.m_closesLoop == incoming.m_closesLoop) && "The edges of a connection disagree about loops");
+        if (outgoing.m_closesLoop) {
+            ++numLoopConnections;
+        } else {
+            assert((m_positionFromSlot[entry.m_sourceSlot] < m_positionFromSlot[entry.m_targetSlot]) &&
+                   "A connection does not respect the dependency order");
+        }
+    }
+    assert((numLoopConnections == m_loopConnections.size()) && "The loop connections are not all recorded");
+#endif // NDEBUG
+}
+
+void babelwires::NodeGraph::Adjacency::resetSlot(Slot slot) {
+    if (slot >= m_blocks.size()) {
+        m_blocks.resize(slot + 1);
+    } else {
+        Block& block = m_blocks[slot];
+        m_numAbandoned += block.m_capacity;
+        block = Block();
+    }
+}
+
+std::uint32_t babelwires::NodeGraph::Adjacency::addEdge(Slot slot, Edge edge) {
+    Block& block = m_blocks[slot];
+    if (block.m_size == block.m_capacity) {
+        // Move the block to the end of the pool, leaving room to grow.
+        const std::uint32_t newCapacity = std::max<std::uint32_t>(2 * block.m_capacity, 2);
+        const std::uint32_t newBegin = static_cast<std::uint32_t>(m_pool.size());
+        m_pool.resize(m_pool.size() + newCapacity);
+        std::copy_n(m_pool.begin() + block.m_begin, block.m_size, m_pool.begin() + newBegin);
+        m_numAbandoned += block.m_capacity;
+        block.m_begin = newBegin;
+        block.m_capacity = newCapacity;
+    }
+    const std::uint32_t index = block.m_size;
+    m_pool[block.m_begin + index] = edge;
+    ++block.m_size;
+    if (m_numAbandoned > m_pool.size() / 2) {
+        compact();
+    }
+    return index;
+}
+
+void babelwires::NodeGraph::Adjacency::removeEdge(Slot slot, std::uint32_t index) {
+    Block& block = m_blocks[slot];
+    assert((index < block.m_size) && "Edge index out of range");
+    // Preserving the order keeps the results of queries independent of the history of removals.
+    const auto begin = m_pool.begin() + block.m_begin;
+    std::move(begin + index + 1, begin + block.m_size, begin + index);
+    --block.m_size;
+}
+
+void babelwires::NodeGraph::Adjacency::clear() {
+    m_pool.clear();
+    m_blocks.clear();
+    m_numAbandoned = 0;
+}
+
+void babelwires::NodeGraph::Adjacency::compact() {
+    std::vector<Edge> newPool;
+    newPool.reserve(m_pool.size() - m_numAbandoned);
+    for (Block& block : m_blocks) {
+        const std::uint32_t newBegin = static_cast<std::uint32_t>(newPool.size());
+        newPool.insert(newPool.end(), m_pool.begin() + block.m_begin, m_pool.begin() + block.m_begin + block.m_capacity);
+        block.m_begin = newBegin;
+    }
+    m_pool = std::move(newPool);
+    m_numAbandoned = 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * The NodeGraph assigns the Nodes of a project dense slots and stores the connections between them by slot.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BabelWiresLib/babelWiresLibExport.hpp>
+#include <BabelWiresLib/Project/projectIds.hpp>
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace babelwires {
+
+    class Node;
+    class ConnectionModifier;
+
+    /// Assigns the Nodes of a project dense slots and stores the connections between them by slot.
+    /// Traversals of the graph therefore index contiguous arrays rather than chasing pointers through maps.
+    /// The NodeGraph does not own the Nodes or the ConnectionModifiers.
+    ///
+    /// The graph also maintains a dependency order of its slots as connections are added and removed, using the
+    /// dynamic topological sort of Pearce and Kelly. A connection which cannot be ordered because it would close a
+    /// dependency loop is marked as closing a loop, and is ignored by the order until a removal allows it.
+    class BABELWIRESLIB_API NodeGraph {
+      public:
+        using Slot = std::uint32_t;
+        static constexpr Slot c_invalidSlot = ~Slot(0);
+
+        /// A connection, as seen from one of the Nodes it connects.
+        struct Edge {
+            ConnectionModifier* m_connection;
+            /// The slot of the Node at the other end of the connection.
+            Slot m_otherSlot;
+            /// This connection is not respected by the dependency order, because it closes a dependency loop.
+            bool m_closesLoop = false;
+        };
+
+        /// Give the node a slot. The slots of removed Nodes are reused.
+        Slot addNode(Node* node);
+
+        /// Free the slot of the node. The node must not have any connections.
+        void removeNode(Slot slot);
+
+        /// Returns c_invalidSlot if there is no Node with the id.
+        Slot getSlot(NodeId nodeId) const;
+
+        /// Returns nullptr if the slot is free.
+        Node* getNode(Slot slot) const { return m_nodeFromSlot[slot]; }
+
+        /// Slots are less than this number. Some of them may be free.
+        Slot getNumSlots() const { return static_cast<Slot>(m_nodeFromSlot.size()); }
+
+        std::size_t getNumNodes() const { return m_slotFromNodeId.size(); }
+
+        /// Record a connection from the source Node to the target Node.
+        /// The connection must not already be in the graph.
+        void addConnection(Slot sourceSlot, Slot targetSlot, ConnectionModifier* connection);
+
+        /// Forget a connection previously added. The remaining edges of its nodes keep their order.
+        /// This takes time linear in the number of edges of the nodes, unless there are connections which close loops
+        /// and might now be orderable.
+        void removeConnection(const ConnectionModifier* connection);
+
+        /// Was the connection added and not yet removed?
+        bool hasConnection(const ConnectionModifier* connection) const;
+
+        std::size_t getNumConnections() const { return m_connections.size(); }
+
+        /// The connections whose target is the Node in the slot. The other slot of each edge is the source.
+        std::span<const Edge> getIncomingEdges(Slot slot) const { return m_incoming.getEdges(slot); }
+
+        /// The connections whose source is the Node in the slot. The other slot of each edge is the target.
+        std::span<const Edge> getOutgoingEdges(Slot slot) const { return m_outgoing.getEdges(slot); }
+
+        /// All slots, including free ones, such that the source of every connection which does not close a loop comes
+        /// before its target.
+        std::span<const Slot> getSlotsInDependencyOrder() const { return m_slotFromPosition; }
+
+        /// Get the slots of exactly those Nodes which are on a dependency loop.
+        /// This only does work if some connection closes a loop.
+        std::vector<Slot> getSlotsInDependencyLoops() const;
+
+        void clear();
+
+        /// Assert that the slots and edges are consistent with each other. Does nothing in release builds.
+        void validate() const;
+
+      private:
+        /// A compressed adjacency representation which can be updated incrementally.
+        /// The edges of each slot are contiguous in a shared pool. A block which fills up is moved to the end of the
+        /// pool with double the capacity, and the pool is compacted when the abandoned space exceeds the used space.
+        class Adjacency {
+          public:
+            std::span<const Edge> getEdges(Slot slot) const {
+                const Block& block = m_blocks[slot];
+                return {m_pool.data() + block.m_begin, block.m_size};
+            }
+            /// Ensure the slot exists and has no edges.
+            void resetSlot(Slot slot);
+            /// Returns the index of the edge within the edges of the slot.
+            std::uint32_t addEdge(Slot slot, Edge edge);
+            /// The later edges of the slot are shifted down, so the order of the remaining edges is preserved.
+            void removeEdge(Slot slot, std::uint32_t index);
+            Edge& getEdge(Slot slot, std::uint32_t index) { return m_pool[m_blocks[slot].m_begin + index]; }
+            bool hasEdges(Slot slot) const { return m_blocks[slot].m_size > 0; }
+            void clear();
+
+          private:
+            struct Block {
+                std::uint32_t m_begin = 0;
+                std::uint32_t m_size = 0;
+                std::uint32_t m_capacity = 0;
+            };
+            void compact();
+
+          private:
+            std::vector<Edge> m_pool;
+            std::vector<Block> m_blocks;
+            /// The capacity of blocks which are no longer in use.
+            std::uint32_t m_numAbandoned = 0;
+        };
+
+        /// Where a connection is in the graph.
+        struct ConnectionEntry {
+            Slot m_sourceSlot;
+            Slot m_targetSlot;
+            /// The index of the edge among the outgoing edges of the source.
+            std::uint32_t m_outgoingIndex;
+            /// The index of the edge among the incoming edges of the target.
+            std::uint32_t m_incomingIndex;
+        };
+
+        /// Try to reorder slots so the source comes before the target, following Pearce and Kelly.
+        /// Only the slots between the target and the source in the current order are visited.
+        /// Returns false without changing the order if the target already reaches the source.
+        bool tryToOrder(Slot sourceSlot, Slot targetSlot);
+
+        /// Record the indices of the edges at or after the index, after an earlier edge of the slot was removed.
+        void updateOutgoingIndices(Slot slot, std::uint32_t fromIndex);
+        void updateIncomingIndices(Slot slot, std::uint32_t fromIndex);
+
+        /// Set the flag in both edges of the connection.
+        void setClosesLoop(const ConnectionEntry& entry, bool closesLoop);
+
+        /// Try to order the connections which close loops, in case a removal has broken their loops.
+        void tryToOrderLoopConnections();
+
+      private:
+        std::vector<Node*> m_nodeFromSlot;
+        std::vector<Slot> m_freeSlots;
+        std::unordered_map<NodeId, Slot> m_slotFromNodeId;
+        Adjacency m_incoming;
+        Adjacency m_outgoing;
+        std::unordered_map<const ConnectionModifier*, ConnectionEntry> m_connections;
+
+        /// The dependency order, and its inverse.
+        std::vector<Slot> m_slotFromPosition;
+        std::vector<std::uint32_t> m_positionFromSlot;
+
+        /// The connections which close dependency loops.
+        std::vector<const ConnectionModifier*> m_loopConnections;
+
+        /// Scratch space for tryToOrder, kept to avoid allocations.
+        std::vector<bool> m_isVisited;
+        std::vector<Slot> m_forwardSlots;
+        std::vector<Slot> m_backwardSlots;
+        std::vector<std::uint32_t> m_positions;
+    };
+
+} // namespace babelwires
@@ -70,6 +70,8 @@ babelwires::Node* babelwires::Project::addNodeWithoutCachingConnection(const Nod
     std::unique_ptr<Node> nodePtr = data.createNode(m_context, m_userLogger, availableId);
     Node* node = nodePtr.get();
     m_nodes.insert(std::make_pair(availableId, std::move(nodePtr)));
+    m_graph.addNode(node);
+    ++m_nodesGeneration;
     return node;
 }
 
@@ -93,9 +95,11 @@ void babelwires::Project::removeNode(NodeId nodeId) {
     for (const auto& connectionModifier : node->getConnectionModifiers()) {
         removeConnectionFromCache(node, connectionModifier);
     }
+    m_graph.removeNode(m_graph.getSlot(nodeId));
 
     m_removedNodes.insert(std::move(*mapIt));
     m_nodes.erase(mapIt);
+    ++m_nodesGeneration;
 }
 
 void babelwires::Project::addModifier(NodeId nodeId, const ModifierData& modifierData, bool applyModifier) {
@@ -130,13 +134,8 @@ void babelwires::Project::adjustModifiersInArrayElements(NodeId nodeId, const ba
     // The addition would seem to affect only input features, so this may seem unneccessary.
     // However, we allow input and output features of processors to share paths,
     // in which case, we want any matching output connections to update too.
-    const auto r = m_connectionCache.m_requiredFor.find(node);
-    if (r != m_connectionCache.m_requiredFor.end()) {
-        const babelwires::Project::ConnectionInfo::Connections& connections = r->second;
-        for (auto&& pair : connections) {
-            babelwires::ConnectionModifier& modifier = *std::get<0>(pair);
-            modifier.adjustSourceArrayIndices(pathToArray, startIndex, adjustment);
-        }
+    for (const NodeGraph::Edge& edge : m_graph.getOutgoingEdges(m_graph.getSlot(nodeId))) {
+        edge.m_connection->adjustSourceArrayIndices(pathToArray, startIndex, adjustment);
     }
 }
 
@@ -257,7 +256,9 @@ void babelwires::Project::clear() {
     // TODO Why not just clear? This isn't undoable.
     m_removedNodes.swap(m_nodes);
     m_nodes.clear();
-    setConnectionCacheInvalid();
+    m_graph.clear();
+    m_brokenConnections.clear();
+    ++m_nodesGeneration;
     randomizeProjectId();
     m_maxAssignedNodeId = 0;
 }
@@ -265,18 +266,18 @@ void babelwires::Project::clear() {
 babelwires::Project::~Project() {}
 
 babelwires::Node* babelwires::Project::getNode(NodeId id) {
-    auto&& it = m_nodes.find(id);
-    if (it != m_nodes.end()) {
-        return it->second.get();
+    const NodeGraph::Slot slot = m_graph.getSlot(id);
+    if (slot != NodeGraph::c_invalidSlot) {
+        return m_graph.getNode(slot);
     } else {
         return nullptr;
     }
 }
 
 const babelwires::Node* babelwires::Project::getNode(NodeId id) const {
-    auto&& it = m_nodes.find(id);
-    if (it != m_nodes.end()) {
-        return it->second.get();
+    const NodeGraph::Slot slot = m_graph.getSlot(id);
+    if (slot != NodeGraph::c_invalidSlot) {
+        return m_graph.getNode(slot);
     } else {
         return nullptr;
     }
@@ -336,142 +337,72 @@ void babelwires::Project::tryToSaveTarget(NodeId id) {
     fileNode->save(m_context, m_userLogger);
 }
 
-void babelwires::Project::setConnectionCacheInvalid() {
-    m_connectionCache.m_dependsOn.clear();
-    m_connectionCache.m_requiredFor.clear();
-    m_connectionCache.m_brokenConnections.clear();
-}
-
 void babelwires::Project::addConnectionToCache(Node* node, ConnectionModifier* connectionModifier) {
-    if (auto source = getNode(connectionModifier->getModifierData().m_sourceId)) {
-        {
-            auto itAndBool = m_connectionCache.m_dependsOn.insert(
-                std::make_pair(node, babelwires::Project::ConnectionInfo::Connections()));
-            babelwires::Project::ConnectionInfo::Connections& connections = itAndBool.first->second;
-            connections.emplace_back(std::make_tuple(connectionModifier, source));
-        }
-        {
-            auto itAndBool = m_connectionCache.m_requiredFor.insert(
-                std::make_pair(source, babelwires::Project::ConnectionInfo::Connections()));
-            babelwires::Project::ConnectionInfo::Connections& connections = itAndBool.first->second;
-            connections.emplace_back(std::make_tuple(connectionModifier, node));
-        }
+    const NodeGraph::Slot sourceSlot = m_graph.getSlot(connectionModifier->getModifierData().m_sourceId);
+    if (sourceSlot != NodeGraph::c_invalidSlot) {
+        m_graph.addConnection(sourceSlot, m_graph.getSlot(node->getNodeId()), connectionModifier);
     } else {
-        m_connectionCache.m_brokenConnections.emplace_back(std::make_tuple(connectionModifier, node));
+        m_brokenConnections.emplace_back(connectionModifier, node);
     }
 }
 
 void babelwires::Project::removeConnectionFromCache(Node* node, ConnectionModifier* connectionModifier) {
-    if (auto source = getNode(connectionModifier->getModifierData().m_sourceId)) {
-        {
-            auto dit = m_connectionCache.m_dependsOn.find(node);
-            assert((dit != m_connectionCache.m_dependsOn.end()) && "Cannot find dependency with connection to remove");
-            babelwires::Project::ConnectionInfo::Connections& connections = dit->second;
-            auto cit = std::find(connections.begin(), connections.end(), std::make_tuple(connectionModifier, source));
-            assert((cit != connections.end()) && "Cannot find connection to remove");
-            connections.erase(cit);
-            if (connections.empty()) {
-                m_connectionCache.m_dependsOn.erase(dit);
-            }
-        }
-        {
-            auto rit = m_connectionCache.m_requiredFor.find(source);
-            assert((rit != m_connectionCache.m_requiredFor.end()) &&
-                   "Cannot find dependency with connection to remove");
-            auto& connections = rit->second;
-            auto cit = std::find(connections.begin(), connections.end(), std::make_tuple(connectionModifier, node));
-            assert((cit != connections.end()) && "Cannot find connection to remove");
-            connections.erase(cit);
-            if (connections.empty()) {
-                m_connectionCache.m_requiredFor.erase(rit);
-            }
-        }
+    if (m_graph.hasConnection(connectionModifier)) {
+        m_graph.removeConnection(connectionModifier);
     } else {
-        auto it = std::find(m_connectionCache.m_brokenConnections.begin(), m_connectionCache.m_brokenConnections.end(),
-                            std::make_tuple(connectionModifier, node));
-        m_connectionCache.m_brokenConnections.erase(it);
+        const auto it =
+            std::find_if(m_brokenConnections.begin(), m_brokenConnections.end(),
+                         [connectionModifier](const auto& entry) { return entry.first == connectionModifier; });
+        assert((it != m_brokenConnections.end()) && "Cannot find connection to remove");
+        m_brokenConnections.erase(it);
     }
 }
 
 void babelwires::Project::validateConnectionCache() const {
 #ifndef NDEBUG
-    const auto checkOwned = [this](const Node* pointerToCheck) {
-        const auto it = std::find_if(m_nodes.begin(), m_nodes.end(), [pointerToCheck](const auto& uPtr) {
-            return std::get<1>(uPtr).get() == pointerToCheck;
-        });
-        assert((it != m_nodes.end()) && "The cache refers to an node that is not owned by the project");
-    };
-
-    for (auto mapPair : m_connectionCache.m_dependsOn) {
-        checkOwned(mapPair.first);
-        for (auto connectionPair : mapPair.second) {
-            checkOwned(std::get<1>(connectionPair));
-        }
-    }
-
-    for (auto mapPair : m_connectionCache.m_requiredFor) {
-        checkOwned(mapPair.first);
-        for (auto connectionPair : mapPair.second) {
-            checkOwned(std::get<1>(connectionPair));
-        }
-    }
-
-    for (const auto& pair : m_nodes) {
-        const Node* target = pair.second.get();
-
-        for (const auto& connectionModifier : target->getConnectionModifiers()) {
-            if (auto source = getNode(connectionModifier->getModifierData().m_sourceId)) {
-                {
-                    const auto dit = m_connectionCache.m_dependsOn.find(target);
-                    assert((dit != m_connectionCache.m_dependsOn.end()) &&
-                           "The connection cache is missing a dependsOn dependency");
-                    const babelwires::Project::ConnectionInfo::Connections& connections = dit->second;
-                    auto cit =
-                        std::find(connections.begin(), connections.end(), std::make_tuple(connectionModifier, source));
-                    assert((cit != connections.end()) && "The connection cache is missing a dependsOn connection");
-                }
-                {
-                    const auto rit = m_connectionCache.m_requiredFor.find(source);
-                    assert((rit != m_connectionCache.m_requiredFor.end()) &&
-                           "The connection cache is missing a requiredFor dependency");
-                    const auto& connections = rit->second;
-                    const auto cit =
-                        std::find(connections.begin(), connections.end(), std::make_tuple(connectionModifier, target));
-                    assert((cit != connections.end()) && "The connection cache is missing a requiredFor connection");
-                }
+    m_graph.validate();
+    assert((m_graph.getNumNodes() == m_nodes.size()) && "The graph does not have the same nodes as the project");
+
+    std::size_t numConnections = 0;
+    std::size_t numBrokenConnections = 0;
+    for (const auto& [nodeId, node] : m_nodes) {
+        const NodeGraph::Slot targetSlot = m_graph.getSlot(nodeId);
+        assert((m_graph.getNode(targetSlot) == node.get()) && "The graph does not have the node in the project");
+        for (const auto& connectionModifier : node->getConnectionModifiers()) {
+            const NodeGraph::Slot sourceSlot = m_graph.getSlot(connectionModifier->getModifierData().m_sourceId);
+            if (sourceSlot != NodeGraph::c_invalidSlot) {
+                assert(m_graph.hasConnection(connectionModifier) && "The graph is missing a connection");
+                ++numConnections;
             } else {
-                const auto it =
-                    std::find(m_connectionCache.m_brokenConnections.begin(),
-                              m_connectionCache.m_brokenConnections.end(), std::make_tuple(connectionModifier, target));
-                assert((it != m_connectionCache.m_brokenConnections.end()) &&
+                const auto it = std::find(m_brokenConnections.begin(), m_brokenConnections.end(),
+                                          std::make_pair(connectionModifier, node.get()));
+                assert((it != m_brokenConnections.end()) &&
                        "The connection cache is missing a broken connection");
+                ++numBrokenConnections;
             }
         }
     }
+    assert((numConnections == m_graph.getNumConnections()) && "The graph has connections which are not in the project");
+    assert((numBrokenConnections == m_brokenConnections.size()) &&
+           "There are broken connections which are not in the project");
 #endif // NDEBUG
 }
 
-const babelwires::Project::ConnectionInfo& babelwires::Project::getConnectionInfo() const {
-    return m_connectionCache;
+const babelwires::NodeGraph& babelwires::Project::getNodeGraph() const {
+    return m_graph;
 }
 
-void babelwires::Project::propagateChanges(const Node* e) {
-    const auto r = m_connectionCache.m_requiredFor.find(e);
-    if (r != m_connectionCache.m_requiredFor.end()) {
-        const ConnectionInfo::Connections& connections = r->second;
-        for (auto&& pair : connections) {
-            ConnectionModifier* connection = std::get<0>(pair);
-            Node* targetNode = std::get<1>(pair);
-            if (ValueTreeNode* input = targetNode->getInputNonConst(connection->getTargetPath())) {
-                connection->applyConnection(*this, m_userLogger, input);
-            }
+void babelwires::Project::propagateChanges(NodeGraph::Slot slot) {
+    for (const NodeGraph::Edge& edge : m_graph.getOutgoingEdges(slot)) {
+        ConnectionModifier* connection = edge.m_connection;
+        Node* targetNode = m_graph.getNode(edge.m_otherSlot);
+        if (ValueTreeNode* input = targetNode->getInputNonConst(connection->getTargetPath())) {
+            connection->applyConnection(*this, m_userLogger, input);
         }
     }
 
     // Check that all broken connections are marked failed.
-    for (auto pair : m_connectionCache.m_brokenConnections) {
-        ConnectionModifier* connection = std::get<0>(pair);
-        Node* owner = std::get<1>(pair);
+    for (const auto& [connection, owner] : m_brokenConnections) {
         if (!connection->isFailed()) {
             if (ValueTreeNode* input = owner->getInputNonConst(connection->getTargetPath())) {
                 connection->applyConnection(*this, m_userLogger, input);
@@ -483,62 +414,37 @@ void babelwires::Project::propagateChanges(const Node* e) {
 void babelwires::Project::process() {
     validateConnectionCache();
 
-    // Topologically sort the nodes in a later-depends-on-earlier order.
-    std::vector<Node*> sortedNodes;
-
-    sortedNodes.reserve(m_nodes.size());
-    for (auto&& pair : m_nodes) {
-        sortedNodes.emplace_back(pair.second.get());
-    }
-
-    std::unordered_map<const Node*, int> numDependencies;
-    numDependencies.reserve(m_connectionCache.m_dependsOn.size());
-    for (auto&& pair : m_connectionCache.m_dependsOn) {
-        numDependencies.insert(std::make_pair(pair.first, pair.second.size()));
+    // The graph only flags the nodes which are actually on a loop. Nodes downstream of a loop are processed in the
+    // normal way, using whatever their failed sources provide.
+    std::vector<bool> isInDependencyLoop(m_graph.getNumSlots(), false);
+    for (NodeGraph::Slot slot : m_graph.getSlotsInDependencyLoops()) {
+        isInDependencyLoop[slot] = true;
     }
-
-    // Because we're marking the Nodes as they are sorted, we have to iterate to the end.
-    for (int firstUnsortedIndex = 0; firstUnsortedIndex < m_nodes.size();) {
-        const int firstUnsortedIndexBefore = firstUnsortedIndex;
-        for (int j = firstUnsortedIndex; j < m_nodes.size(); ++j) {
-            Node* node = sortedNodes[j];
-
-            const auto it = numDependencies.find(node);
-            if (it == numDependencies.end() || it->second == 0) {
-                std::swap(sortedNodes[firstUnsortedIndex], sortedNodes[j]);
-                node->setInDependencyLoop(false);
-                ++firstUnsortedIndex;
-                const auto r = m_connectionCache.m_requiredFor.find(node);
-                if (r != m_connectionCache.m_requiredFor.end()) {
-                    const ConnectionInfo::Connections& connections = r->second;
-                    for (auto&& pair : connections) {
-                        const auto sit = numDependencies.find(std::get<1>(pair));
-                        if (sit != numDependencies.end()) {
-                            --sit->second;
-                        }
-                    }
-                }
-            }
-        }
-        // Check for a dependency loop.
-        if (firstUnsortedIndex == firstUnsortedIndexBefore) {
-            for (int i = firstUnsortedIndex; i < m_nodes.size(); ++i) {
-                sortedNodes[i]->setInDependencyLoop(true);
-            }
-            break;
+    for (NodeGraph::Slot slot = 0; slot < m_graph.getNumSlots(); ++slot) {
+        if (Node* const node = m_graph.getNode(slot)) {
+            node->setInDependencyLoop(isInDependencyLoop[slot]);
         }
     }
 
     // Now iterate in dependency order.
-    for (auto&& node : sortedNodes) {
+    // The graph maintains the order as connections change, so there is no need to sort here.
+    for (NodeGraph::Slot slot : m_graph.getSlotsInDependencyOrder()) {
+        Node* const node = m_graph.getNode(slot);
+        if (!node) {
+            continue;
+        }
         node->process(*this, m_userLogger);
         // Existing connections only apply their contents if their source has changed,
         // so this doesn't unnecessarily change dependent data.
         // We do need to visit all out-going connections in case some are new.
-        propagateChanges(node);
+        propagateChanges(slot);
     }
 }
 
+std::uint64_t babelwires::Project::getNodesGeneration() const {
+    return m_nodesGeneration;
+}
+
 const std::map<babelwires::NodeId, std::unique_ptr<babelwires::Node>>& babelwires::Project::getNodes() const {
     return m_nodes;
 }
@@ -8,9 +8,11 @@
 #pragma once
 
 #include <BabelWiresLib/babelWiresLibExport.hpp>
+#include <BabelWiresLib/Project/nodeGraph.hpp>
 #include <BabelWiresLib/Project/projectData.hpp>
 #include <BabelWiresLib/Project/projectIds.hpp>
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <tuple>
@@ -107,6 +109,10 @@ namespace babelwires {
         Node* getNode(NodeId id);
         const Node* getNode(NodeId id) const;
 
+        /// A number which changes whenever nodes are added to or removed from the project.
+        /// A Node pointer obtained from getNode remains valid while this number is unchanged.
+        std::uint64_t getNodesGeneration() const;
+
         /// Reload the source file.
         /// File exceptions are caught and written to the userLogger.
         void tryToReloadSource(NodeId id);
@@ -132,26 +138,9 @@ namespace babelwires {
         /// Mark all features in the project as unchanged.
         void clearChanges();
 
-        /// Information about the connections between Nodes.
-        /// The connectionInfo includes Nodes and modifiers which failed.
-        struct BABELWIRESLIB_API ConnectionInfo {
-            using Connections = std::vector<std::tuple<ConnectionModifier*, Node*>>;
-            using ConnectionMap = std::unordered_map<const Node*, Connections>;
-
-            /// Information about the Nodes a given Node depends on.
-            /// There is an entry for a Node only if it has an incoming connection.
-            ConnectionMap m_dependsOn;
-
-            /// Information about the Nodes which depend on a given Node.
-            /// There is an entry for a Node only if it has an outgoing connection.
-            ConnectionMap m_requiredFor;
-
-            /// Connections that are missing their source, paired with their owner.
-            Connections m_brokenConnections;
-        };
-
-        /// Get information about the connections between Nodes.
-        const ConnectionInfo& getConnectionInfo() const;
+        /// Get the Nodes and the connections between them.
+        /// The graph includes Nodes and modifiers which failed, but not connections whose source is missing.
+        const NodeGraph& getNodeGraph() const;
 
         /// Get the Nodes which have been removed since the last time
         /// changes were cleared.
@@ -171,12 +160,9 @@ namespace babelwires {
         Project& operator=(const Project&) = delete;
 
       private:
-        /// Mark the connection cache as invalid, so the next time it is queried, it gets recomputed.
-        void setConnectionCacheInvalid();
-
-        /// If the output of e has any changes, propagate them to the input features of connected
-        /// Nodes, as described by the requiredForMap.
-        void propagateChanges(const Node* e);
+        /// If the output of the node in the slot has any changes, propagate them to the input features of
+        /// connected Nodes.
+        void propagateChanges(NodeGraph::Slot slot);
 
         /// Set the ProjectId to a random value.
         void randomizeProjectId();
@@ -185,6 +171,8 @@ namespace babelwires {
 
         void removeConnectionFromCache(Node* node, ConnectionModifier* data);
 
+        /// Check that the graph and broken connections match the connection modifiers of the nodes.
+        /// Does nothing in release builds.
         void validateConnectionCache() const;
 
         Node* addNodeWithoutCachingConnection(const NodeData& data);
@@ -206,8 +194,16 @@ namespace babelwires {
         /// A map of Nodes, keyed by NodeId.
         std::map<NodeId, std::unique_ptr<Node>> m_nodes;
 
-        /// Cache of connection information.
-        ConnectionInfo m_connectionCache;
+        /// See getNodesGeneration.
+        std::uint64_t m_nodesGeneration = 0;
+
+        /// The nodes and the connections between them, arranged for fast traversal.
+        /// This is maintained connection by connection alongside m_nodes.
+        NodeGraph m_graph;
+
+        /// Connections that are missing their source, paired with their owner.
+        /// Kept in insertion order, so they are always reapplied in the same order. There are rarely many.
+        std::vector<std::pair<ConnectionModifier*, Node*>> m_brokenConnections;
 
         /// Nodes which have been removed since the last time changes were cleared.
         /// Use a map because we iterate.
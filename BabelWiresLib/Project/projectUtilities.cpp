@@ -27,49 +27,46 @@ namespace {
         assert(valueIndex < values.size());
         const babelwires::Node* node = std::get<0>(values[valueIndex]);
         const babelwires::Path& pathToValue = std::get<1>(values[valueIndex]);
-        const babelwires::Project::ConnectionInfo& connectionInfo = project.getConnectionInfo();
-        const auto& rit = connectionInfo.m_requiredFor.find(node);
-        if (rit != connectionInfo.m_requiredFor.end()) {
-            for (auto cit : rit->second) {
-                const babelwires::Node* const targetElement = std::get<1>(cit);
-                // TODO: Build an interface in the project that avoids the need to query this.
-                if (targetElement->isInDependencyLoop()) {
-                    continue;
+        const babelwires::NodeGraph& graph = project.getNodeGraph();
+        for (const babelwires::NodeGraph::Edge& edge : graph.getOutgoingEdges(graph.getSlot(node->getNodeId()))) {
+            const babelwires::Node* const targetElement = graph.getNode(edge.m_otherSlot);
+            // TODO: Build an interface in the project that avoids the need to query this.
+            if (targetElement->isInDependencyLoop()) {
+                continue;
+            }
+            const babelwires::ConnectionModifier* connectionModifier = edge.m_connection;
+            const babelwires::ConnectionModifierData& connectionData = connectionModifier->getModifierData();
+            if (connectionData.m_sourcePath.isPrefixOf(pathToValue)) {
+                // There is a connection between an ancestor and some node in the node.
+                babelwires::Path pathToPossibleValueInTarget;
+                {
+                    babelwires::Path pathFromAncestor = pathToValue;
+                    pathFromAncestor.removePrefix(connectionData.m_sourcePath.getNumSteps());
+                    pathToPossibleValueInTarget = connectionData.m_targetPath;
+                    pathToPossibleValueInTarget.append(pathFromAncestor);
                 }
-                const babelwires::ConnectionModifier* connectionModifier = std::get<0>(cit);
-                const babelwires::ConnectionModifierData& connectionData = connectionModifier->getModifierData();
-                if (connectionData.m_sourcePath.isPrefixOf(pathToValue)) {
-                    // There is a connection between an ancestor and some node in the node.
-                    babelwires::Path pathToPossibleValueInTarget;
-                    {
-                        babelwires::Path pathFromAncestor = pathToValue;
-                        pathFromAncestor.removePrefix(connectionData.m_sourcePath.getNumSteps());
-                        pathToPossibleValueInTarget = connectionData.m_targetPath;
-                        pathToPossibleValueInTarget.append(pathFromAncestor);
-                    }
-                    // See if there is a more specific modifier in the target which means this connection does not
-                    // actually affect the value in the target. Since only connection modifiers can modify
-                    // structure if a value already has a connected ancestor, it should be sufficient to check
-                    // connection modifiers.
-                    bool foundOverridingModifier = false;
-                    // TODO The edit tree could provide an O(log N) algorithm for this.
-                    for (auto modifier : targetElement->getConnectionModifiers()) {
-                        // Using strict here means that connectionModifier itself is exempt from consideration.
-                        if (connectionData.m_targetPath.isStrictPrefixOf(modifier->getTargetPath()) &&
-                            modifier->getTargetPath().isPrefixOf(pathToPossibleValueInTarget)) {
-                            foundOverridingModifier = true;
-                            break;
-                        }
-                    }
-                    if (!foundOverridingModifier) {
-                        assert(tryFollowPath(pathToPossibleValueInTarget, *targetElement->getInput()) &&
-                               "Expected to find a matching feature in the target, since ancestors are connected and "
-                               "there "
-                               "are no overriding modifiers");
-                        values.emplace_back(std::tuple<const babelwires::Node*, babelwires::Path>{
-                            targetElement, std::move(pathToPossibleValueInTarget)});
+                // See if there is a more specific modifier in the target which means this connection does not
+                // actually affect the value in the target. Since only connection modifiers can modify
+                // structure if a value already has a connected ancestor, it should be sufficient to check
+                // connection modifiers.
+                bool foundOverridingModifier = false;
+                // TODO The edit tree could provide an O(log N) algorithm for this.
+                for (auto modifier : targetElement->getConnectionModifiers()) {
+                    // Using strict here means that connectionModifier itself is exempt from consideration.
+                    if (connectionData.m_targetPath.isStrictPrefixOf(modifier->getTargetPath()) &&
+                        modifier->getTargetPath().isPrefixOf(pathToPossibleValueInTarget)) {
+                        foundOverridingModifier = true;
+                        break;
                     }
                 }
+                if (!foundOverridingModifier) {
+                    assert(tryFollowPath(pathToPossibleValueInTarget, *targetElement->getInput()) &&
+                           "Expected to find a matching feature in the target, since ancestors are connected and "
+                           "there "
+                           "are no overriding modifiers");
+                    values.emplace_back(std::tuple<const babelwires::Node*, babelwires::Path>{
+                        targetElement, std::move(pathToPossibleValueInTarget)});
+                }
             }
         }
     }
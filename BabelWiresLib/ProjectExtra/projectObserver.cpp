@@ -43,46 +43,39 @@ namespace {
         addToConnections(connections, state, std::move(connectionDesc), sourceElement, targetElement);
     }
 
-    void addAllLiveInConnections(const babelwires::Project::ConnectionInfo& connectionInfo,
-                                 const babelwires::Node* targetElement,
+    void addAllLiveInConnections(const babelwires::NodeGraph& graph, const babelwires::Node* targetElement,
                                  std::unordered_set<babelwires::ConnectionDescription>& connections, State state) {
         const babelwires::NodeId nodeId = targetElement->getNodeId();
-        const auto& inConnections = connectionInfo.m_dependsOn.find(targetElement);
-        if (inConnections != connectionInfo.m_dependsOn.end()) {
-            for (const auto& connection : inConnections->second) {
-                const babelwires::ConnectionModifier& connectionModifier = *std::get<0>(connection);
-                if (connectionModifier.isConnected() &&
-                    ((state == State::CurrentState) ||
-                     !connectionModifier.isChanged(babelwires::Modifier::Changes::ModifierIsNew |
-                                                   babelwires::Modifier::Changes::ModifierMoved |
-                                                   babelwires::Modifier::Changes::ModifierConnected))) {
-                    const babelwires::Node* sourceElement = std::get<1>(connection);
-                    addToConnections(connections, state,
-                                     babelwires::ConnectionDescription(nodeId, connectionModifier.getModifierData()),
-                                     sourceElement, targetElement);
-                }
+        for (const babelwires::NodeGraph::Edge& edge : graph.getIncomingEdges(graph.getSlot(nodeId))) {
+            const babelwires::ConnectionModifier& connectionModifier = *edge.m_connection;
+            if (connectionModifier.isConnected() &&
+                ((state == State::CurrentState) ||
+                 !connectionModifier.isChanged(babelwires::Modifier::Changes::ModifierIsNew |
+                                               babelwires::Modifier::Changes::ModifierMoved |
+                                               babelwires::Modifier::Changes::ModifierConnected))) {
+                const babelwires::Node* sourceElement = graph.getNode(edge.m_otherSlot);
+                addToConnections(connections, state,
+                                 babelwires::ConnectionDescription(nodeId, connectionModifier.getModifierData()),
+                                 sourceElement, targetElement);
             }
         }
     }
 
-    void addAllLiveOutConnections(const babelwires::Project::ConnectionInfo& connectionInfo,
-                                  const babelwires::Node* sourceElement,
+    void addAllLiveOutConnections(const babelwires::NodeGraph& graph, const babelwires::Node* sourceElement,
                                   std::unordered_set<babelwires::ConnectionDescription>& connections, State state) {
-        const auto& outConnections = connectionInfo.m_requiredFor.find(sourceElement);
-        if (outConnections != connectionInfo.m_requiredFor.end()) {
-            for (auto&& connection : outConnections->second) {
-                const babelwires::Node* const targetElement = std::get<1>(connection);
-                const babelwires::ConnectionModifier& connectionModifier = *std::get<0>(connection);
-                if (connectionModifier.isConnected() &&
-                    ((state == State::CurrentState) ||
-                     !connectionModifier.isChanged(babelwires::Modifier::Changes::ModifierIsNew |
-                                                   babelwires::Modifier::Changes::ModifierMoved |
-                                                   babelwires::Modifier::Changes::ModifierConnected))) {
-                    addToConnections(connections, state,
-                                     babelwires::ConnectionDescription(targetElement->getNodeId(),
-                                                                       connectionModifier.getModifierData()),
-                                     sourceElement, targetElement);
-                }
+        for (const babelwires::NodeGraph::Edge& edge :
+             graph.getOutgoingEdges(graph.getSlot(sourceElement->getNodeId()))) {
+            const babelwires::Node* const targetElement = graph.getNode(edge.m_otherSlot);
+            const babelwires::ConnectionModifier& connectionModifier = *edge.m_connection;
+            if (connectionModifier.isConnected() &&
+                ((state == State::CurrentState) ||
+                 !connectionModifier.isChanged(babelwires::Modifier::Changes::ModifierIsNew |
+                                               babelwires::Modifier::Changes::ModifierMoved |
+                                               babelwires::Modifier::Changes::ModifierConnected))) {
+                addToConnections(connections, state,
+                                 babelwires::ConnectionDescription(targetElement->getNodeId(),
+                                                                   connectionModifier.getModifierData()),
+                                 sourceElement, targetElement);
             }
         }
     }
@@ -112,7 +105,7 @@ void babelwires::ProjectObserver::interpretChangesAndFireSignals() {
         }
     }
 
-    const Project::ConnectionInfo& connectionInfo = m_project.getConnectionInfo();
+    const NodeGraph& graph = m_project.getNodeGraph();
 
     // We compile the changes into these containers, and apply them below.
     // Note: The nodeeditor based UI does not know how to handle nodes which have changed
@@ -154,7 +147,7 @@ void babelwires::ProjectObserver::interpretChangesAndFireSignals() {
 
         if (node->isChanged(Node::Changes::NodeIsNew)) {
             nodesToCreate.emplace_back(node);
-            addAllLiveInConnections(connectionInfo, node, connectionsToAdd, State::CurrentState);
+            addAllLiveInConnections(graph, node, connectionsToAdd, State::CurrentState);
         } else {
             allModifiersWereRemoved(node, nodeId, node->getRemovedModifiers());
             if (node->isChanged(Node::Changes::ModifierDisconnected)) {
@@ -181,12 +174,12 @@ void babelwires::ProjectObserver::interpretChangesAndFireSignals() {
             const bool hasStructureChange =
                 node->getContentsCache().isChanged(ContentsCache::Changes::StructureChanged);
             if (hasStructureChange) {
-                addAllLiveInConnections(connectionInfo, node, connectionsToRemove, State::PreviousState);
-                addAllLiveOutConnections(connectionInfo, node, connectionsToRemove, State::PreviousState);
+                addAllLiveInConnections(graph, node, connectionsToRemove, State::PreviousState);
+                addAllLiveOutConnections(graph, node, connectionsToRemove, State::PreviousState);
                 nodesToRemove.emplace_back(node);
                 nodesToCreate.emplace_back(node);
-                addAllLiveInConnections(connectionInfo, node, connectionsToAdd, State::CurrentState);
-                addAllLiveOutConnections(connectionInfo, node, connectionsToAdd, State::CurrentState);
+                addAllLiveInConnections(graph, node, connectionsToAdd, State::CurrentState);
+                addAllLiveOutConnections(graph, node, connectionsToAdd, State::CurrentState);
             }
 
             if (node->isChanged(Node::Changes::ModifierAdded |
@@ -7,8 +7,15 @@
  **/
 #include <BabelWiresLib/TypeSystem/type.hpp>
 
+#include <atomic>
+
+namespace {
+    std::atomic<babelwires::Type::SerialNumber> s_nextSerialNumber = 1;
+} // namespace
+
 babelwires::Type::Type(TypeExp&& typeExpOfThis)
-    : m_typeExp(std::move(typeExpOfThis)) {}
+    : m_typeExp(std::move(typeExpOfThis))
+    , m_serialNumber(s_nextSerialNumber.fetch_add(1, std::memory_order_relaxed)) {}
 
 babelwires::Type::~Type() = default;
 
@@ -33,6 +40,10 @@ const std::vector<babelwires::Type::Tag>& babelwires::Type::getTags() const {
     return m_tags;
 }
 
+babelwires::Type::SerialNumber babelwires::Type::getSerialNumber() const {
+    return m_serialNumber;
+}
+
 bool babelwires::Type::isValidValue(const TypeSystem& typeSystem, const Value& v) const {
     ChildValueVisitor visitor = [&](const TypeSystem& typeSystem, const TypePtr& childType, const Value& childValue,
                                     const PathStep& stepToChild) {
@@ -77,6 +77,12 @@ namespace babelwires {
         /// Get the tags associated with this type.
         const std::vector<Tag>& getTags() const;
 
+        /// A number which identifies this type object and is never reused by another type, even after this one
+        /// is destroyed. Caches can use it as a key where the address of the type would not be safe.
+        using SerialNumber = std::uint64_t;
+
+        SerialNumber getSerialNumber() const;
+
       protected:
         /// Only intended for use during subclass construction.
         void addTag(Tag tag);
@@ -87,6 +93,8 @@ namespace babelwires {
 
         /// The tags associated with this type.
         std::vector<Tag> m_tags;
+
+        SerialNumber m_serialNumber;
     };
 
 } // namespace babelwires
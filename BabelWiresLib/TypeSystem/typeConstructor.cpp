@@ -25,30 +25,54 @@ babelwires::TypeConstructor::tryGetOrConstructType(const TypeSystem& typeSystem,
     return {};
 }
 
+babelwires::TypeConstructor::CacheShard& babelwires::TypeConstructor::getCacheShard(std::size_t hash) const {
+    // Use the high bits, since the low bits select buckets within the shard's map.
+    const std::uint64_t mixed = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+    return m_cacheShards[mixed >> 60];
+}
+
+babelwires::TypeConstructor::CacheStatistics babelwires::TypeConstructor::getCacheStatistics() const {
+    CacheStatistics statistics;
+    for (const CacheShard& shard : m_cacheShards) {
+        statistics.m_numConstructed += shard.m_numConstructed.load(std::memory_order_relaxed);
+        statistics.m_numCached += shard.m_numCached.load(std::memory_order_relaxed);
+        statistics.m_numExpired += shard.m_numExpired.load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
 babelwires::ResultT<babelwires::TypePtr>
 babelwires::TypeConstructor::getOrConstructType(const TypeSystem& typeSystem,
                                                         const TypeConstructorArguments& arguments) const {
+    const std::size_t hash = arguments.getHash();
+    CacheShard& shard = getCacheShard(hash);
+    bool isExpired = false;
     {
         // Phase 1: Try cache read-only
-        std::shared_lock lock(m_mutexForCache);
+        std::shared_lock lock(shard.m_mutex);
 
-        auto it = m_cache.find(arguments);
-        if (it != m_cache.end()) {
+        auto it = shard.m_cache.find(CacheKeyRef{hash, arguments});
+        if (it != shard.m_cache.end()) {
             if (it->second) {
                 if (TypePtr owningPtr = it->second->lock()) {
+                    shard.m_numCached.fetch_add(1, std::memory_order_relaxed);
                     return owningPtr;
                 }
+                isExpired = true;
             } else {
                 return std::unexpected(it->second.error());
             }
         }
     }
+    if (isExpired) {
+        shard.m_numExpired.fetch_add(1, std::memory_order_relaxed);
+    }
 
     // Phase 2: Resolve the arguments.
     std::vector<TypePtr> resolvedArguments;
     resolvedArguments.reserve(arguments.getTypeArguments().size());
     std::vector<std::string> unresolvedTypesString;
-    for (auto arg : arguments.getTypeArguments()) {
+    for (const auto& arg : arguments.getTypeArguments()) {
         if (const TypePtr argAsType = arg.tryResolve(typeSystem)) {
             resolvedArguments.emplace_back(argAsType);
         } else {
@@ -60,28 +84,32 @@ babelwires::TypeConstructor::getOrConstructType(const TypeSystem& typeSystem,
     {
         // Phase 3: Try the cache again with a write lock.
         // If it's still not found, construct and insert the new type.
-        std::unique_lock lock(m_mutexForCache);
+        std::unique_lock lock(shard.m_mutex);
 
-        auto it = m_cache.emplace(std::pair{arguments, PerTypeStorage()});
-        if (!it.second) {
+        auto it = shard.m_cache.find(CacheKeyRef{hash, arguments});
+        if (it == shard.m_cache.end()) {
+            it = shard.m_cache.emplace(CacheKey{hash, arguments}, PerTypeStorage()).first;
+        } else {
             // There's an entry now. See if it's usable.
-            if (it.first->second) {
-                if (TypePtr owningPtr = it.first->second->lock()) {
+            if (it->second) {
+                if (TypePtr owningPtr = it->second->lock()) {
+                    shard.m_numCached.fetch_add(1, std::memory_order_relaxed);
                     return owningPtr;
                 }
             } else {
-                return it.first->second.error();
+                return it->second.error();
             }
         }
         // Still not found.
         // Only construct the type if the arity is correct.
         if (resolvedArguments.size() == arguments.getTypeArguments().size()) {
+            shard.m_numConstructed.fetch_add(1, std::memory_order_relaxed);
             auto result = constructType(typeSystem, std::move(newTypeExp), arguments, resolvedArguments);
             if (result) {
                 assert(*result && "Returning a null pointer from a TypeConstructor is not permitted");
-                it.first->second = *result;
+                it->second = *result;
             } else {
-                it.first->second = std::unexpected(result.error());
+                it->second = std::unexpected(result.error());
             }
             return result;
         } else {
@@ -92,7 +120,7 @@ babelwires::TypeConstructor::getOrConstructType(const TypeSystem& typeSystem,
                 error << sep << refString;
                 sep = ", ";
             }
-            it.first->second = error;
+            it->second = error;
             return error;
         }
     }
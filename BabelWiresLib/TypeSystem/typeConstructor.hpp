@@ -17,6 +17,8 @@
 #include <BaseLib/Result/result.hpp>
 #include <BaseLib/Utilities/downcastable.hpp>
 
+#include <array>
+#include <atomic>
 #include <shared_mutex>
 
 namespace babelwires {
@@ -41,6 +43,18 @@ namespace babelwires {
         /// This is supplied by the TYPE_CONSTRUCTOR macro.
         virtual TypeConstructorId getTypeConstructorId() const = 0;
 
+        /// Information about the effectiveness of the cache.
+        struct CacheStatistics {
+            /// The number of calls to constructType.
+            std::uint64_t m_numConstructed = 0;
+            /// The number of requests satisfied by a live type in the cache.
+            std::uint64_t m_numCached = 0;
+            /// The number of requests which found an entry whose type had been destroyed.
+            std::uint64_t m_numExpired = 0;
+        };
+
+        CacheStatistics getCacheStatistics() const;
+
       protected:
         /// Construct the new type, return an existing type (if the constructor is just a pure wrapper)
         /// or return an error if it cannot be constructed.
@@ -53,15 +67,54 @@ namespace babelwires {
                                                     const std::vector<TypePtr>& resolvedTypeArguments) const = 0;
 
       private:
-        /// A mutex which ensures thread-safe access to the cache.
-        /// Use a shared-only lock on the assumption that the majority of simultaneous queries are not for the
-        // same TypeExp.
-        mutable std::shared_mutex m_mutexForCache;
-
         using PerTypeStorage = ResultT<WeakTypePtr>;
 
+        /// The arguments are hashed once per request and the hash is kept with the entry.
+        struct CacheKey {
+            std::size_t m_hash;
+            TypeConstructorArguments m_arguments;
+        };
+
+        /// Allows lookup without copying the arguments.
+        struct CacheKeyRef {
+            std::size_t m_hash;
+            const TypeConstructorArguments& m_arguments;
+        };
+
+        struct CacheKeyHash {
+            using is_transparent = void;
+            std::size_t operator()(const CacheKey& key) const { return key.m_hash; }
+            std::size_t operator()(const CacheKeyRef& key) const { return key.m_hash; }
+        };
+
+        struct CacheKeyEqual {
+            using is_transparent = void;
+            template <typename A, typename B> bool operator()(const A& a, const B& b) const {
+                return (a.m_hash == b.m_hash) && (a.m_arguments == b.m_arguments);
+            }
+        };
+
         /// A cache which stops the system ending up with multiple copies of the same constructed type.
-        mutable std::unordered_map<TypeConstructorArguments, PerTypeStorage> m_cache;
+        /// The cache is split into shards, each with its own mutex, so simultaneous queries for different types
+        /// rarely touch the same lock. Shards are aligned to cache lines, so they do not share them either.
+        struct alignas(64) CacheShard {
+            /// Use a shared-only lock for reads on the assumption that the majority of simultaneous queries are
+            /// for types which already exist.
+            std::shared_mutex m_mutex;
+            std::unordered_map<CacheKey, PerTypeStorage, CacheKeyHash, CacheKeyEqual> m_cache;
+
+            /// The counts for the statistics are kept per shard, so counting does not make queries contend.
+            std::atomic<std::uint64_t> m_numConstructed = 0;
+            std::atomic<std::uint64_t> m_numCached = 0;
+            std::atomic<std::uint64_t> m_numExpired = 0;
+        };
+
+        static constexpr unsigned int s_numCacheShards = 16;
+
+        CacheShard& getCacheShard(std::size_t hash) const;
+
+      private:
+        mutable std::array<CacheShard, s_numCacheShards> m_cacheShards;
     };
 
     // ConstructedType is obsolete now that all Types carry their own TypeExp.
@@ -16,12 +16,164 @@
 #include <BaseLib/Serialization/deserializer.hpp>
 #include <BaseLib/Serialization/serializer.hpp>
 
+#include <array>
 #include <bitset>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
 
 namespace {
     constexpr char defaultStateString[] = "[]";
+
+    /// Unlike operator==, an identifier without a discriminator is not considered equal to one with a discriminator.
+    template <typename IDENTIFIER> bool isSameIdentifier(const IDENTIFIER& a, const IDENTIFIER& b) {
+        return (a == b) && (a.getDiscriminator() == b.getDiscriminator());
+    }
 } // namespace
 
+struct babelwires::TypeExp::Node {
+    Storage m_storage;
+    std::size_t m_hash;
+    /// A canonical node contains only identifiers with discriminators and values which cannot contain
+    /// identifiers. Two distinct canonical nodes are never equal.
+    bool m_isCanonical;
+};
+
+/// Nodes are deduplicated using exact equality (in particular, discriminators must match).
+/// Entries are removed by the deleter of the nodes, so the table only holds live nodes.
+/// The table is sharded by hash, so threads constructing and destroying unrelated TypeExps rarely contend.
+class babelwires::TypeExp::InternTable {
+  public:
+    /// The table is deliberately leaked, so it outlives all static TypeExps.
+    static InternTable& get() {
+        static InternTable* const s_table = new InternTable;
+        return *s_table;
+    }
+
+    std::shared_ptr<const Node> intern(Storage storage) {
+        if (std::holds_alternative<std::monostate>(storage)) {
+            return {};
+        }
+        const std::size_t hash = computeHash(storage);
+        Shard& shard = getShard(hash);
+        std::lock_guard lock(shard.m_mutex);
+        const auto range = shard.m_nodes.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (isExactlyEqual(it->second.first->m_storage, storage)) {
+                // The node may be in the process of being deleted.
+                if (auto node = it->second.second.lock()) {
+                    return node;
+                }
+            }
+        }
+        const bool isCanonical = computeIsCanonical(storage);
+        std::shared_ptr<const Node> node(new Node{std::move(storage), hash, isCanonical}, [](const Node* node) {
+            InternTable::get().remove(node);
+            // Deleting the node can release child nodes, so this is done outside the lock.
+            delete node;
+        });
+        shard.m_nodes.emplace(hash, std::pair<const Node*, std::weak_ptr<const Node>>{node.get(), node});
+        return node;
+    }
+
+    static std::size_t computeHash(const Storage& storage) {
+        std::size_t hash = 0x123456789;
+        // I wonder if the construction of std::hash objects creates pointless overhead here?
+        struct VisitorMethods {
+            void operator()(std::monostate) { hash::mixInto(m_currentHash, 0x11122233); }
+            void operator()(const RegisteredTypeId& typeId) { hash::mixInto(m_currentHash, typeId); }
+            void operator()(const ConstructedTypeData& higherOrderData) {
+                hash::mixInto(m_currentHash, std::get<0>(higherOrderData), std::get<1>(higherOrderData));
+            }
+            std::size_t& m_currentHash;
+        } visitorMethods{hash};
+        std::visit(visitorMethods, storage);
+        return hash;
+    }
+
+  private:
+    struct Shard {
+        std::mutex m_mutex;
+        std::unordered_multimap<std::size_t, std::pair<const Node*, std::weak_ptr<const Node>>> m_nodes;
+    };
+
+    static constexpr unsigned int c_log2NumShards = 6;
+
+    Shard& getShard(std::size_t hash) {
+        // The hash is not well mixed, so scramble it (Fibonacci hashing) and take the high bits. This also keeps the
+        // choice of shard independent of the choice of bucket within the shard's map.
+        const std::size_t scrambled = hash * static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+        return m_shards[scrambled >> (std::numeric_limits<std::size_t>::digits - c_log2NumShards)];
+    }
+
+    void remove(const Node* node) {
+        Shard& shard = getShard(node->m_hash);
+        std::lock_guard lock(shard.m_mutex);
+        const auto range = shard.m_nodes.equal_range(node->m_hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.first == node) {
+                shard.m_nodes.erase(it);
+                return;
+            }
+        }
+    }
+
+    static bool isExactlyEqual(const Storage& a, const Storage& b) {
+        if (a.index() != b.index()) {
+            return false;
+        }
+        if (const auto* const typeIdA = std::get_if<RegisteredTypeId>(&a)) {
+            return isSameIdentifier(*typeIdA, std::get<RegisteredTypeId>(b));
+        }
+        const auto& [constructorIdA, argumentsA] = std::get<ConstructedTypeData>(a);
+        const auto& [constructorIdB, argumentsB] = std::get<ConstructedTypeData>(b);
+        if (!isSameIdentifier(constructorIdA, constructorIdB)) {
+            return false;
+        }
+        const auto& typeArgumentsA = argumentsA.getTypeArguments();
+        const auto& typeArgumentsB = argumentsB.getTypeArguments();
+        if (!std::equal(typeArgumentsA.begin(), typeArgumentsA.end(), typeArgumentsB.begin(), typeArgumentsB.end(),
+                        [](const TypeExp& argA, const TypeExp& argB) { return argA.m_node == argB.m_node; })) {
+            return false;
+        }
+        const auto& valueArgumentsA = argumentsA.getValueArguments();
+        const auto& valueArgumentsB = argumentsB.getValueArguments();
+        return std::equal(valueArgumentsA.begin(), valueArgumentsA.end(), valueArgumentsB.begin(),
+                          valueArgumentsB.end(), [](const ValueHolder& argA, const ValueHolder& argB) {
+                              if (argA.getUnsafe() == argB.getUnsafe()) {
+                                  return true;
+                              }
+                              // Value equality may not respect discriminators, so only share equal copies of
+                              // values without identifiers.
+                              return !argA->getAsEditableValue().canContainIdentifiers() && (argA == argB);
+                          });
+    }
+
+    static bool computeIsCanonical(const Storage& storage) {
+        if (const auto* const typeId = std::get_if<RegisteredTypeId>(&storage)) {
+            return typeId->getDiscriminator() != 0;
+        }
+        const auto& [constructorId, arguments] = std::get<ConstructedTypeData>(storage);
+        if (constructorId.getDiscriminator() == 0) {
+            return false;
+        }
+        for (const auto& typeArgument : arguments.getTypeArguments()) {
+            if (typeArgument.m_node && !typeArgument.m_node->m_isCanonical) {
+                return false;
+            }
+        }
+        for (const auto& valueArgument : arguments.getValueArguments()) {
+            if (valueArgument->getAsEditableValue().canContainIdentifiers()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    std::array<Shard, 1 << c_log2NumShards> m_shards;
+};
+
 std::size_t babelwires::TypeConstructorArguments::getHash() const {
     // Arbitrary value.
     std::size_t hash = 0x80235AA2;
@@ -42,10 +194,35 @@ bool babelwires::TypeConstructorArguments::equals(const TypeConstructorArguments
 babelwires::TypeExp::TypeExp() = default;
 
 babelwires::TypeExp::TypeExp(RegisteredTypeId typeId)
-    : m_storage(typeId) {}
+    : m_node(InternTable::get().intern(typeId)) {}
 
 babelwires::TypeExp::TypeExp(TypeConstructorId typeConstructorId, TypeConstructorArguments arguments)
-    : m_storage(ConstructedTypeData{typeConstructorId, std::move(arguments)}) {}
+    : m_node(InternTable::get().intern(ConstructedTypeData{typeConstructorId, std::move(arguments)})) {}
+
+const babelwires::TypeExp::Storage& babelwires::TypeExp::getStorage() const {
+    static const Storage s_monostate;
+    return m_node ? m_node->m_storage : s_monostate;
+}
+
+void babelwires::TypeExp::setStorage(Storage storage) {
+    m_node = InternTable::get().intern(std::move(storage));
+}
+
+bool babelwires::TypeExp::equals(const TypeExp& a, const TypeExp& b) {
+    if (a.m_node == b.m_node) {
+        return true;
+    }
+    if (!a.m_node || !b.m_node) {
+        return false;
+    }
+    if (a.m_node->m_isCanonical && b.m_node->m_isCanonical) {
+        return false;
+    }
+    if (a.m_node->m_hash != b.m_node->m_hash) {
+        return false;
+    }
+    return a.m_node->m_storage == b.m_node->m_storage;
+}
 
 babelwires::TypePtr babelwires::TypeExp::tryResolve(const TypeSystem& typeSystem) const {
     struct VisitorMethods {
@@ -61,7 +238,7 @@ babelwires::TypePtr babelwires::TypeExp::tryResolve(const TypeSystem& typeSystem
         }
         const TypeSystem& m_typeSystem;
     } visitorMethods{typeSystem};
-    return std::visit(visitorMethods, m_storage);
+    return std::visit(visitorMethods, getStorage());
 }
 
 babelwires::ResultT<babelwires::TypePtr> babelwires::TypeExp::resolve(const TypeSystem& typeSystem) const {
@@ -85,7 +262,7 @@ babelwires::ResultT<babelwires::TypePtr> babelwires::TypeExp::resolve(const Type
         }
         const TypeSystem& m_typeSystem;
     } visitorMethods{typeSystem};
-    return std::visit(visitorMethods, m_storage);
+    return std::visit(visitorMethods, getStorage());
 }
 
 babelwires::TypePtr babelwires::TypeExp::assertResolve(const TypeSystem& typeSystem) const {
@@ -119,7 +296,7 @@ std::string babelwires::TypeExp::toStringHelper(babelwires::IdentifierRegistry::
         }
         babelwires::IdentifierRegistry::ReadAccess& m_identifierRegistry;
     } visitorMethods{identifierRegistry};
-    const std::string str = std::visit(visitorMethods, m_storage);
+    const std::string str = std::visit(visitorMethods, getStorage());
     if (!str.empty()) {
         return str;
     } else {
@@ -149,7 +326,7 @@ void babelwires::TypeExp::serializeContents(Serializer& serializer) const {
         }
         Serializer& m_serializer;
     } visitorMethods{serializer};
-    std::visit(visitorMethods, m_storage);
+    std::visit(visitorMethods, getStorage());
 }
 
 babelwires::Result babelwires::TypeExp::deserializeContents(Deserializer& deserializer) {
@@ -161,7 +338,7 @@ babelwires::Result babelwires::TypeExp::deserializeContents(Deserializer& deseri
     if (typeIdResult && typeConstructorIdResult) {
         return Error() << "TypeExp cannot have both typeId and typeConstructorId";
     } else if (typeIdResult) {
-        m_storage = typeId;
+        setStorage(typeId);
     } else if (typeConstructorIdResult) {
         std::vector<TypeExp> typeArguments;
         std::vector<ValueHolder> valueArguments;
@@ -179,15 +356,16 @@ babelwires::Result babelwires::TypeExp::deserializeContents(Deserializer& deseri
                 DO_OR_ERROR(valueIt->advance());
             }
         }
-        m_storage = ConstructedTypeData{typeConstructorId, {std::move(typeArguments), std::move(valueArguments)}};
+        setStorage(ConstructedTypeData{typeConstructorId, {std::move(typeArguments), std::move(valueArguments)}});
     } else {
-        m_storage = {};
+        setStorage({});
     }
     return {};
 }
 
 void babelwires::TypeExp::visitIdentifiers(IdentifierVisitor& visitor) {
-    // Note: The visitor needs to access the actual stored data, so be careful to avoid copies.
+    // Nodes are shared, so the visitor modifies a copy, which is then interned.
+    // Note: Within the copy, the visitor needs to access the actual stored data, so be careful to avoid copies.
     struct VisitorMethods {
         void operator()(std::monostate) {}
         void operator()(RegisteredTypeId& typeId) { m_visitor(typeId); }
@@ -205,26 +383,18 @@ void babelwires::TypeExp::visitIdentifiers(IdentifierVisitor& visitor) {
         }
         IdentifierVisitor& m_visitor;
     } visitorMethods{visitor};
-    return std::visit(visitorMethods, m_storage);
+    Storage storage = getStorage();
+    std::visit(visitorMethods, storage);
+    setStorage(std::move(storage));
 }
 
 void babelwires::TypeExp::visitFilePaths(FilePathVisitor& visitor) {}
 
 std::size_t babelwires::TypeExp::getHash() const {
-    std::size_t hash = 0x123456789;
-    // I wonder if the construction of std::hash objects creates pointless overhead here?
-    struct VisitorMethods {
-        void operator()(std::monostate) { hash::mixInto(m_currentHash, 0x11122233); }
-        void operator()(const RegisteredTypeId& typeId) { hash::mixInto(m_currentHash, typeId); }
-        void operator()(const ConstructedTypeData& higherOrderData) {
-            hash::mixInto(m_currentHash, std::get<0>(higherOrderData), std::get<1>(higherOrderData));
-        }
-        std::size_t& m_currentHash;
-    } visitorMethods{hash};
-    std::visit(visitorMethods, m_storage);
-    return hash;
+    static const std::size_t s_monostateHash = InternTable::computeHash(std::monostate());
+    return m_node ? m_node->m_hash : s_monostateHash;
 }
 
 babelwires::TypeExp::operator bool() const {
-    return !std::holds_alternative<std::monostate>(m_storage);
+    return m_node != nullptr;
 }
@@ -18,6 +18,7 @@
 #include <BaseLib/Result/result.hpp>
 #include <BaseLib/Serialization/serializable.hpp>
 
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -104,10 +105,11 @@ namespace babelwires {
         void visitIdentifiers(IdentifierVisitor& visitor) override;
         void visitFilePaths(FilePathVisitor& visitor) override;
 
-        friend bool operator==(const TypeExp& a, const TypeExp& b) { return a.m_storage == b.m_storage; }
-        friend bool operator!=(const TypeExp& a, const TypeExp& b) { return a.m_storage != b.m_storage; }
+        friend bool operator==(const TypeExp& a, const TypeExp& b) { return equals(a, b); }
+        friend bool operator!=(const TypeExp& a, const TypeExp& b) { return !equals(a, b); }
 
         /// Get a hash which can be used with std::hash.
+        /// The hash is computed once, when the TypeExp is constructed.
         std::size_t getHash() const;
 
         /// Does the TypeExp contain some data (other than the trivial std::monostate default state)?
@@ -120,6 +122,10 @@ namespace babelwires {
         /// Returns a parsed type and a position just beyond that type.
         static std::tuple<babelwires::TypeExp, std::string_view::size_type> parseHelper(std::string_view str);
 
+        /// Usually a pointer comparison. A structural comparison is only needed when identifiers without
+        /// discriminators are involved, since they compare equal to identifiers with any discriminator.
+        static bool equals(const TypeExp& a, const TypeExp& b);
+
       public:
         /// Visit each of the cases of the TypeExp.
         /// Warning: Be very careful with this, because you can assume very little about how a constructor uses its
@@ -134,12 +140,23 @@ namespace babelwires {
         static R visit(Visitor& visitor, const TypeExp& a, const TypeExp& b);
 
       private:
-        // TODO More compact storage.
         using ConstructedTypeData = std::tuple<TypeConstructorId, TypeConstructorArguments>;
         using Storage = std::variant<std::monostate, RegisteredTypeId, ConstructedTypeData>;
 
+        /// The immutable contents of a TypeExp, which are shared by all TypeExps with exactly the same contents.
+        struct Node;
+
+        /// The global table of nodes.
+        class InternTable;
+
+        const Storage& getStorage() const;
+
+        /// Replace the contents of this TypeExp by an interned node carrying the storage.
+        void setStorage(Storage storage);
+
       private:
-        Storage m_storage;
+        /// Null for the default (std::monostate) state.
+        std::shared_ptr<const Node> m_node;
     };
 } // namespace babelwires
 
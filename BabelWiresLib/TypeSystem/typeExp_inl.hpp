@@ -42,7 +42,7 @@ R babelwires::TypeExp::visit(Visitor& visitor) const {
         }
         Visitor& visitor;
     } visitorMethods{visitor};
-    return std::visit(visitorMethods, m_storage);
+    return std::visit(visitorMethods, getStorage());
 }
 
 template <typename Visitor, typename R>
@@ -62,5 +62,5 @@ R babelwires::TypeExp::visit(Visitor& visitor, const TypeExp& a, const TypeExp&
         }
         Visitor& visitor;
     } visitorMethods{visitor};
-    return std::visit(visitorMethods, a.m_storage, b.m_storage);
+    return std::visit(visitorMethods, a.getStorage(), b.getStorage());
 }
\ No newline at end of file
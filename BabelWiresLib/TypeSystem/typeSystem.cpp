@@ -9,7 +9,11 @@
 
 #include <BabelWiresLib/TypeSystem/subtypeUtils.hpp>
 
+#include <BaseLib/Hash/hash.hpp>
+
 #include <algorithm>
+#include <mutex>
+
 namespace {
     void insertTypeId(babelwires::TypeSystem::TypeIdSet& typeIds, const babelwires::RegisteredTypeId& typeId) {
         auto it = std::upper_bound(typeIds.begin(), typeIds.end(), typeId);
@@ -17,7 +21,11 @@ namespace {
     }
 } // namespace
 
-babelwires::TypeSystem::TypeSystem() = default;
+babelwires::TypeSystem::TypeSystem(std::size_t maximumNumSubtypeCacheEntries)
+    : m_maximumNumSubtypeCacheEntries(maximumNumSubtypeCacheEntries) {
+    // Both directions of a comparison are cached together.
+    assert((maximumNumSubtypeCacheEntries >= 2) && "The subtype cache needs room for at least two entries");
+}
 babelwires::TypeSystem::~TypeSystem() = default;
 
 babelwires::TypePtr babelwires::TypeSystem::tryGetRegisteredTypeById(RegisteredTypeId id) const {
@@ -68,11 +76,72 @@ babelwires::TypeSystem::addTypeConstructorInternal(TypeConstructorId typeId, Ver
     return std::get<0>(addResult.first->second).get();
 }
 
+std::size_t babelwires::TypeSystem::SubtypeCacheKeyHash::operator()(const SubtypeCacheKey& key) const {
+    return hash::mixtureOf(std::get<0>(key), std::get<1>(key));
+}
+
 babelwires::SubtypeOrder babelwires::TypeSystem::compareSubtype(const Type& typeA, const Type& typeB) const {
-    // TODO Thread-safe cache here.
     if (&typeA == &typeB) {
         return SubtypeOrder::IsEquivalent;
     }
+    const SubtypeCacheKey key{typeA.getSerialNumber(), typeB.getSerialNumber()};
+    {
+        std::shared_lock lock(m_mutexForSubtypeCache);
+        const auto it = m_subtypeCache.find(key);
+        if (it != m_subtypeCache.end()) {
+            m_numSubtypeCacheHits.fetch_add(1, std::memory_order_relaxed);
+            SubtypeCacheEntry& entry = m_subtypeCacheEntries[it->second];
+            entry.m_isReferenced.store(true, std::memory_order_relaxed);
+            return entry.m_order;
+        }
+    }
+    m_numSubtypeCacheMisses.fetch_add(1, std::memory_order_relaxed);
+    const SubtypeOrder result = compareSubtypeUncached(typeA, typeB);
+    {
+        std::unique_lock lock(m_mutexForSubtypeCache);
+        addToSubtypeCache(key, result);
+        // The reverse comparison is determined by this one.
+        addToSubtypeCache(SubtypeCacheKey{std::get<1>(key), std::get<0>(key)}, reverseSubtypeOrder(result));
+    }
+    return result;
+}
+
+void babelwires::TypeSystem::addToSubtypeCache(const SubtypeCacheKey& key, SubtypeOrder order) const {
+    // Another thread may have added the entry while the lock was not held.
+    if (m_subtypeCache.find(key) != m_subtypeCache.end()) {
+        return;
+    }
+    std::size_t index;
+    if (m_subtypeCacheEntries.size() < m_maximumNumSubtypeCacheEntries) {
+        index = m_subtypeCacheEntries.size();
+        m_subtypeCacheEntries.emplace_back();
+    } else {
+        // Clear the referenced flags of entries until one is found which was not already clear.
+        while (m_subtypeCacheEntries[m_subtypeCacheHand].m_isReferenced.exchange(false, std::memory_order_relaxed)) {
+            m_subtypeCacheHand = (m_subtypeCacheHand + 1) % m_subtypeCacheEntries.size();
+        }
+        index = m_subtypeCacheHand;
+        m_subtypeCacheHand = (m_subtypeCacheHand + 1) % m_subtypeCacheEntries.size();
+        m_subtypeCache.erase(m_subtypeCacheEntries[index].m_key);
+    }
+    SubtypeCacheEntry& entry = m_subtypeCacheEntries[index];
+    entry.m_key = key;
+    entry.m_order = order;
+    entry.m_isReferenced.store(false, std::memory_order_relaxed);
+    m_subtypeCache.emplace(key, index);
+}
+
+babelwires::TypeSystem::SubtypeCacheStatistics babelwires::TypeSystem::getSubtypeCacheStatistics() const {
+    SubtypeCacheStatistics statistics;
+    statistics.m_numHits = m_numSubtypeCacheHits.load(std::memory_order_relaxed);
+    statistics.m_numMisses = m_numSubtypeCacheMisses.load(std::memory_order_relaxed);
+    std::shared_lock lock(m_mutexForSubtypeCache);
+    statistics.m_numEntries = m_subtypeCache.size();
+    statistics.m_maximumNumEntries = m_maximumNumSubtypeCacheEntries;
+    return statistics;
+}
+
+babelwires::SubtypeOrder babelwires::TypeSystem::compareSubtypeUncached(const Type& typeA, const Type& typeB) const {
     if (const auto resultFromA = typeA.compareSubtypeHelper(*this, typeB)) {
         return *resultFromA;
     } else if (const auto resultFromB = typeB.compareSubtypeHelper(*this, typeA)) {
@@ -16,10 +16,17 @@
 
 #include <BaseLib/Identifiers/identifier.hpp>
 
+#include <atomic>
+#include <deque>
+#include <shared_mutex>
+
 namespace babelwires {
     class BABELWIRESLIB_API TypeSystem {
       public:
-        TypeSystem();
+        /// The default capacity of the cache used by compareSubtype.
+        static constexpr std::size_t c_defaultMaximumNumSubtypeCacheEntries = 1 << 14;
+
+        explicit TypeSystem(std::size_t maximumNumSubtypeCacheEntries = c_defaultMaximumNumSubtypeCacheEntries);
         virtual ~TypeSystem();
 
         template <typename TYPE, typename... ARGS,
@@ -72,6 +79,16 @@ namespace babelwires {
         /// Do the two types have some values in common?
         bool isRelatedType(const Type& typeA, const Type& typeB) const;
 
+        /// Information about the effectiveness of the cache used by compareSubtype.
+        struct SubtypeCacheStatistics {
+            std::uint64_t m_numHits = 0;
+            std::uint64_t m_numMisses = 0;
+            std::size_t m_numEntries = 0;
+            std::size_t m_maximumNumEntries = 0;
+        };
+
+        SubtypeCacheStatistics getSubtypeCacheStatistics() const;
+
         using TypeIdSet = std::vector<RegisteredTypeId>;
 
         TypeIdSet getAllRegisteredTypes() const;
@@ -97,6 +114,49 @@ namespace babelwires {
 
         /// Fast look-up of tagged types.
         std::unordered_map<Type::Tag, std::vector<RegisteredTypeId>> m_taggedRegisteredTypes;
+
+      private:
+        SubtypeOrder compareSubtypeUncached(const Type& typeA, const Type& typeB) const;
+
+      private:
+        /// Types are identified by their serial numbers, so entries cannot be confused by a new type which
+        /// happens to occupy the memory of an expired constructed type.
+        using SubtypeCacheKey = std::tuple<Type::SerialNumber, Type::SerialNumber>;
+
+        struct SubtypeCacheKeyHash {
+            std::size_t operator()(const SubtypeCacheKey& key) const;
+        };
+
+        /// Constructed types come and go during editing, and their serial numbers are never reused, so the cache has
+        /// a fixed capacity. When it is full, an entry is replaced using the clock algorithm: Entries which have been
+        /// found since the hand last passed them are spared.
+        struct SubtypeCacheEntry {
+            SubtypeCacheKey m_key;
+            SubtypeOrder m_order;
+            /// Set by readers, which only hold a shared lock.
+            std::atomic<bool> m_isReferenced = false;
+        };
+
+        /// Add an entry unless it is already present, evicting an old one if the cache is full.
+        /// The unique lock must be held.
+        void addToSubtypeCache(const SubtypeCacheKey& key, SubtypeOrder order) const;
+
+        /// compareSubtype can recurse, so the mutex is not held while a comparison is computed.
+        mutable std::shared_mutex m_mutexForSubtypeCache;
+
+        const std::size_t m_maximumNumSubtypeCacheEntries;
+
+        /// Memoizes the results of compareSubtype. A deque, so entries do not move as it grows.
+        mutable std::deque<SubtypeCacheEntry> m_subtypeCacheEntries;
+
+        /// The index of each entry in m_subtypeCacheEntries.
+        mutable std::unordered_map<SubtypeCacheKey, std::size_t, SubtypeCacheKeyHash> m_subtypeCache;
+
+        /// The next entry the clock algorithm considers for eviction.
+        mutable std::size_t m_subtypeCacheHand = 0;
+
+        mutable std::atomic<std::uint64_t> m_numSubtypeCacheHits = 0;
+        mutable std::atomic<std::uint64_t> m_numSubtypeCacheMisses = 0;
     };
 
 } // namespace babelwires
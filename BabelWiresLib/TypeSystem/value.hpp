@@ -12,13 +12,17 @@
 #include <BaseLib/Identifiers/identifier.hpp>
 #include <BaseLib/Utilities/downcastable.hpp>
 
+#include <memory>
+
 namespace babelwires {
     class Type;
     class EditableValue;
 
     /// A Value is an abstract class for objects which carry a single, usually simple value.
     /// Value lifetimes are usually managed by the ValueHolder container.
-    class BABELWIRESLIB_API Value : public Cloneable {
+    /// A value owned by a ValueHolder is immutable once it is shared, so the ownership of its weak_from_this
+    /// pointer can be used to identify it.
+    class BABELWIRESLIB_API Value : public Cloneable, public std::enable_shared_from_this<Value> {
       public:
         DOWNCASTABLE_BASE(Value);
         CLONEABLE_ABSTRACT(Value);
@@ -9,6 +9,29 @@
 
 #include <BabelWiresLib/Types/Enum/enumValue.hpp>
 
+#include <algorithm>
+#include <bit>
+
+namespace {
+    /// Multipliers with well-mixed bits. Identifier codes have their low bits clear, so slots and buckets are
+    /// taken from the high bits of the products.
+    constexpr std::uint64_t c_bucketMultiplier = 0x9e3779b97f4a7c15;
+    constexpr std::uint64_t c_displacementMultiplier = 0xbf58476d1ce4e5b9;
+    constexpr std::uint64_t c_slotMultiplier = 0x94d049bb133111eb;
+
+    /// Give up (and use the unordered_map) if a bucket cannot be placed after this many displacements.
+    /// This only happens when values differ only by discriminator.
+    constexpr std::uint32_t c_maxDisplacement = 1 << 12;
+
+    std::size_t getBucket(std::uint64_t code, unsigned int bucketShift) {
+        return (code * c_bucketMultiplier) >> bucketShift;
+    }
+
+    std::size_t getSlot(std::uint64_t code, std::uint32_t displacement, unsigned int slotShift) {
+        return ((code ^ (displacement * c_displacementMultiplier)) * c_slotMultiplier) >> slotShift;
+    }
+} // namespace
+
 babelwires::EnumType::EnumType(TypeExp&& typeExpOfThis, ValueSet values, unsigned int indexOfDefaultValue)
     : Type(std::move(typeExpOfThis))
     , m_values(std::move(values))
@@ -21,6 +44,76 @@ babelwires::EnumType::EnumType(TypeExp&& typeExpOfThis, ValueSet values, unsigne
         assert((m_valueToIndex.find(m_values[i]) == m_valueToIndex.end()) && "Enum has duplicate value");
         m_valueToIndex.insert({m_values[i], i});
     }
+    buildPerfectHash();
+}
+
+void babelwires::EnumType::buildPerfectHash() {
+    // Hash-and-displace: Values are first hashed into buckets of about two values each. Then each bucket,
+    // largest first, is given a displacement which sends all its values to unused slots.
+    const std::size_t numSlots = std::bit_ceil(std::max<std::size_t>(2 * m_values.size(), 2));
+    const std::size_t numBuckets = std::bit_ceil(std::max<std::size_t>(m_values.size() / 2, 1));
+    const unsigned int slotShift = 64 - std::countr_zero(numSlots);
+    // Shifting by 64 is not allowed, so a single bucket is handled by ignoring the bucket hash.
+    const unsigned int bucketShift = 64 - std::countr_zero(numBuckets);
+
+    std::vector<std::vector<int>> buckets(numBuckets);
+    for (unsigned int i = 0; i < m_values.size(); ++i) {
+        buckets[(numBuckets == 1) ? 0 : getBucket(m_values[i].toCode(), bucketShift)].emplace_back(i);
+    }
+    std::vector<std::size_t> bucketOrder(numBuckets);
+    for (std::size_t b = 0; b < numBuckets; ++b) {
+        bucketOrder[b] = b;
+    }
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(),
+                     [&buckets](std::size_t a, std::size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    std::vector<int> slots(numSlots, -1);
+    std::vector<std::uint32_t> displacements(numBuckets, 0);
+    std::vector<std::size_t> candidateSlots;
+    for (std::size_t b : bucketOrder) {
+        const std::vector<int>& bucket = buckets[b];
+        if (bucket.empty()) {
+            break;
+        }
+        std::uint32_t displacement = 0;
+        for (; displacement < c_maxDisplacement; ++displacement) {
+            candidateSlots.clear();
+            for (int index : bucket) {
+                const std::size_t slot = getSlot(m_values[index].toCode(), displacement, slotShift);
+                if ((slots[slot] != -1) ||
+                    (std::find(candidateSlots.begin(), candidateSlots.end(), slot) != candidateSlots.end())) {
+                    break;
+                }
+                candidateSlots.emplace_back(slot);
+            }
+            if (candidateSlots.size() == bucket.size()) {
+                break;
+            }
+        }
+        if (displacement == c_maxDisplacement) {
+            return;
+        }
+        displacements[b] = displacement;
+        for (std::size_t i = 0; i < bucket.size(); ++i) {
+            slots[candidateSlots[i]] = bucket[i];
+        }
+    }
+    m_perfectHashSlots = std::move(slots);
+    m_perfectHashDisplacements = std::move(displacements);
+    m_perfectHashSlotShift = slotShift;
+    m_perfectHashBucketShift = bucketShift;
+}
+
+int babelwires::EnumType::lookUpPerfectHash(ShortId id) const {
+    const std::uint64_t code = id.toCode();
+    const std::size_t bucket =
+        (m_perfectHashDisplacements.size() == 1) ? 0 : getBucket(code, m_perfectHashBucketShift);
+    const int index = m_perfectHashSlots[getSlot(code, m_perfectHashDisplacements[bucket], m_perfectHashSlotShift)];
+    // The comparison confirms the text and resolves the discriminator.
+    if ((index != -1) && (m_values[index] == id)) {
+        return index;
+    }
+    return -1;
 }
 
 const babelwires::EnumType::ValueSet& babelwires::EnumType::getValueSet() const {
@@ -32,6 +125,9 @@ unsigned int babelwires::EnumType::getIndexOfDefaultValue() const {
 }
 
 int babelwires::EnumType::tryGetIndexFromIdentifier(babelwires::ShortId id) const {
+    if (!m_perfectHashSlots.empty()) {
+        return lookUpPerfectHash(id);
+    }
     const auto it = m_valueToIndex.find(id);
     if (it != m_valueToIndex.end()) {
         return it->second;
@@ -40,10 +136,25 @@ int babelwires::EnumType::tryGetIndexFromIdentifier(babelwires::ShortId id) cons
 }
 
 unsigned int babelwires::EnumType::getIndexFromIdentifier(babelwires::ShortId id) const {
-    const ValueSet& values = getValueSet();
-    const auto it = m_valueToIndex.find(id);
-    assert((it != m_valueToIndex.end()) && "id not found in enum");
-    return it->second;
+    const int index = tryGetIndexFromIdentifier(id);
+    assert((index != -1) && "id not found in enum");
+    return index;
+}
+
+void babelwires::EnumType::getIndicesFromIdentifiers(std::span<const ShortId> ids,
+                                                     std::span<unsigned int> indicesOut) const {
+    assert((ids.size() == indicesOut.size()) && "The input and output must have the same size");
+    if (!m_perfectHashSlots.empty()) {
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            const int index = lookUpPerfectHash(ids[i]);
+            assert((index != -1) && "id not found in enum");
+            indicesOut[i] = index;
+        }
+    } else {
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            indicesOut[i] = getIndexFromIdentifier(ids[i]);
+        }
+    }
 }
 
 babelwires::ShortId babelwires::EnumType::getIdentifierFromIndex(unsigned int index) const {
@@ -53,13 +164,8 @@ babelwires::ShortId babelwires::EnumType::getIdentifierFromIndex(unsigned int in
 }
 
 bool babelwires::EnumType::isAValue(const babelwires::ShortId& id) const {
-    const ValueSet& values = getValueSet();
-    const auto it = m_valueToIndex.find(id);
-    if (it == m_valueToIndex.end()) {
-        return false;
-    }
     // TODO DISCRIMINATORS
-    return true;
+    return tryGetIndexFromIdentifier(id) != -1;
 }
 
 bool babelwires::EnumType::visitValue(const TypeSystem& typeSystem, const Value& v,
@@ -10,6 +10,7 @@
 #include <BabelWiresLib/babelWiresLibExport.hpp>
 #include <BabelWiresLib/TypeSystem/type.hpp>
 
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -46,6 +47,9 @@ namespace babelwires {
         /// Return the index within ValueSet of the given id, or -1.
         int tryGetIndexFromIdentifier(ShortId id) const;
 
+        /// Get the indices within ValueSet of each of the ids. The ids must all be values of the enum.
+        void getIndicesFromIdentifiers(std::span<const ShortId> ids, std::span<unsigned int> indicesOut) const;
+
         /// Get the identifier within ValueSet at the given index.
         ShortId getIdentifierFromIndex(unsigned int index) const;
 
@@ -64,6 +68,14 @@ namespace babelwires {
 
         std::string valueToString(const TypeSystem& typeSystem, const ValueHolder& v) const override;
 
+      private:
+        /// Try to build a perfect hash of the codes of the values.
+        /// If that fails, the perfect hash is left empty and m_valueToIndex is used instead.
+        void buildPerfectHash();
+
+        /// Return the index of the id using the perfect hash, or -1.
+        int lookUpPerfectHash(ShortId id) const;
+
       private:
         /// The enum values in their intended order.
         ValueSet m_values;
@@ -72,5 +84,13 @@ namespace babelwires {
         /// Supports faster lookup for identifier-based queries.
         std::unordered_map<ShortId, int> m_valueToIndex;
         unsigned int m_indexOfDefaultValue;
+
+        /// Since the values are fixed at construction, identifier-based queries can use a collision-free
+        /// hash of the identifier code. Each slot holds an index into m_values, or -1.
+        std::vector<int> m_perfectHashSlots;
+        /// Per-bucket displacements which make the hash collision-free.
+        std::vector<std::uint32_t> m_perfectHashDisplacements;
+        unsigned int m_perfectHashSlotShift = 0;
+        unsigned int m_perfectHashBucketShift = 0;
     };
 } // namespace babelwires
@@ -12,9 +12,16 @@
 #include <BabelWiresLib/Types/Generic/genericValue.hpp>
 #include <BabelWiresLib/Types/Generic/typeVariableType.hpp>
 
+#include <BaseLib/Hash/hash.hpp>
 #include <BaseLib/Identifiers/registeredIdentifier.hpp>
 
+#include <mutex>
+
 namespace {
+    /// The cache of instantiations is cleared when it reaches this size, so it cannot keep an unbounded number of
+    /// constructed types alive.
+    constexpr std::size_t s_maxNumInstantiations = 64;
+
     /// Calculate how many generic type levels this type has.
     unsigned int calculateGenericTypeHeight(const babelwires::TypeExp& wrappedType) {
         struct Visitor {
@@ -95,6 +102,15 @@ bool babelwires::GenericType::visitValue(const TypeSystem& typeSystem, const Val
     if (m_numVariables != genericValue->getTypeAssignments().size()) {
         return false;
     }
+    if (genericValue->getActualWrappedType() == m_wrappedType) {
+        // No variables have been instantiated.
+        return true;
+    }
+    if (const auto instantiation = tryGetInstantiation(genericValue->getTypeAssignments())) {
+        if (genericValue->getActualWrappedType() == instantiation->m_actualWrappedType) {
+            return true;
+        }
+    }
     return genericValue->isActualVersionOf(m_wrappedType->getTypeExp());
 }
 
@@ -182,5 +198,39 @@ void babelwires::GenericType::setTypeVariableAssignmentAndInstantiate(
     }
     GenericValue& mutableGenericValue = genericValue.copyContentsAndGetNonConst().as<GenericValue>();
     mutableGenericValue.getTypeAssignments() = typeVariableAssignments;
+    if (auto instantiation = tryGetInstantiation(typeVariableAssignments)) {
+        mutableGenericValue.setInstantiation(std::move(instantiation->m_actualWrappedType),
+                                             std::move(instantiation->m_defaultValue));
+        return;
+    }
     mutableGenericValue.instantiate(typeSystem, m_wrappedType->getTypeExp());
+    {
+        std::unique_lock lock(m_mutexForInstantiations);
+        if (m_instantiations.size() >= s_maxNumInstantiations) {
+            m_instantiations.clear();
+        }
+        // The value is shared with the cache, but ValueHolders ensure it is copied before it is modified.
+        m_instantiations.try_emplace(typeVariableAssignments, Instantiation{mutableGenericValue.getActualWrappedType(),
+                                                                            mutableGenericValue.getValue()});
+    }
+}
+
+std::optional<babelwires::GenericType::Instantiation>
+babelwires::GenericType::tryGetInstantiation(const std::vector<TypeExp>& typeVariableAssignments) const {
+    std::shared_lock lock(m_mutexForInstantiations);
+    const auto it = m_instantiations.find(typeVariableAssignments);
+    if (it != m_instantiations.end()) {
+        return it->second;
+    }
+    return {};
+}
+
+std::size_t
+babelwires::GenericType::TypeAssignmentsHash::operator()(const std::vector<TypeExp>& typeVariableAssignments) const {
+    // Arbitrary value.
+    std::size_t hash = 0x5EC4D21B;
+    for (const auto& assignment : typeVariableAssignments) {
+        hash::mixInto(hash, assignment);
+    }
+    return hash;
 }
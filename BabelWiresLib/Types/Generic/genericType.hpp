@@ -9,6 +9,10 @@
 
 #include <BabelWiresLib/babelWiresLibExport.hpp>
 #include <BabelWiresLib/TypeSystem/compoundType.hpp>
+#include <BabelWiresLib/TypeSystem/valueHolder.hpp>
+
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace babelwires {
 
@@ -32,6 +36,8 @@ namespace babelwires {
 
         /// Instantiate the type variables using the given type type assignment.
         /// The number of type variable assignments must not greater than the number of variables in this GenericType.
+        /// Instantiations are memoized, so values with the same assignment share the instantiated type and
+        /// the default value of that type.
         void setTypeVariableAssignmentAndInstantiate(const TypeSystem& typeSystem, ValueHolder& genericValue,
                                                      const std::vector<TypeExp>& typeVariableAssignments) const;
 
@@ -61,10 +67,27 @@ namespace babelwires {
                                                          const Type& other) const override;
         std::string valueToString(const TypeSystem& typeSystem, const ValueHolder& v) const override;
 
+      private:
+        /// The instantiated type and its default value.
+        struct Instantiation {
+            TypePtr m_actualWrappedType;
+            ValueHolder m_defaultValue;
+        };
+
+        /// Returns an empty optional if the assignment has not been instantiated yet.
+        std::optional<Instantiation> tryGetInstantiation(const std::vector<TypeExp>& typeVariableAssignments) const;
+
+        struct TypeAssignmentsHash {
+            std::size_t operator()(const std::vector<TypeExp>& typeVariableAssignments) const;
+        };
+
       private:
         TypePtr m_wrappedType;
         unsigned int m_numVariables;
         // The maximum number of nested generic types in the wrapped type.
         unsigned int m_genericTypeHeight;
+
+        mutable std::shared_mutex m_mutexForInstantiations;
+        mutable std::unordered_map<std::vector<TypeExp>, Instantiation, TypeAssignmentsHash> m_instantiations;
     };
 } // namespace babelwires
@@ -114,6 +114,11 @@ void babelwires::GenericValue::instantiate(const TypeSystem& typeSystem, const T
     m_wrappedValue = m_actualWrappedType->createValue(typeSystem);
 }
 
+void babelwires::GenericValue::setInstantiation(TypePtr actualWrappedType, ValueHolder wrappedValue) {
+    m_actualWrappedType = std::move(actualWrappedType);
+    m_wrappedValue = std::move(wrappedValue);
+}
+
 bool babelwires::GenericValue::isActualVersionOf(const TypeExp& wrappedType) const {
     struct Visitor {
         Visitor(const GenericValue& genericValue, unsigned int level = 0)
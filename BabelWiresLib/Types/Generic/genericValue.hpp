@@ -30,6 +30,9 @@ namespace babelwires {
         /// Update the typeVariableAssignments
         void instantiate(const TypeSystem& typeSystem, const TypeExp& wrappedTypeExp);
 
+        /// Use an instantiation which has already been computed for the current type assignments.
+        void setInstantiation(TypePtr actualWrappedType, ValueHolder wrappedValue);
+
         const ValueHolder& getValue() const;
         ValueHolder& getValue();
 
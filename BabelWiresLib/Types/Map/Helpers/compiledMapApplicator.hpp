@@ -0,0 +1,180 @@
+/**
+ * Converts MapValue to a native C++ function, using a representation chosen to suit the source type.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BabelWiresLib/Types/Map/Helpers/mapApplicatorFallbackHelper.hpp>
+#include <BabelWiresLib/Types/Map/Helpers/valueAdapter.hpp>
+#include <BabelWiresLib/Types/Map/MapEntries/oneToOneMapEntryData.hpp>
+#include <BabelWiresLib/Types/Map/mapValue.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace babelwires {
+    /// Converts MapValue to a native C++ function. The map is compiled once, into a representation chosen by the
+    /// source type and the entries:
+    /// * Integral sources whose entries span a small range use a dense table.
+    /// * Otherwise, maps with few entries use a sorted array.
+    /// * Otherwise, a std::unordered_map is used.
+    /// This is intended for processors which apply the same map to many values, such as every event in a track.
+    /// NOTE: In the cases where the MapValue allows an AllToSame fallback, T and U must be the same.
+    template <typename T, typename U> class CompiledMapApplicator {
+      public:
+        enum class Representation { DenseTable, SortedArray, HashTable };
+
+        /// Dense tables are used when the entries of an integral source span a range no bigger than this.
+        static constexpr std::uint64_t s_maxDenseTableSize = 1024;
+
+        /// Sorted arrays are used when there are no more than this many entries.
+        static constexpr std::size_t s_maxSortedArraySize = 32;
+
+        CompiledMapApplicator(const MapValue& mapValue, const ValueAdapter<T>& sourceAdapter,
+                              const ValueAdapter<U>& targetAdapter)
+            : m_fallbackHelper(mapValue, targetAdapter) {
+            std::vector<std::pair<T, U>> entries;
+            entries.reserve(mapValue.getNumMapEntries() - 1);
+            for (unsigned int i = 0; i < mapValue.getNumMapEntries() - 1; ++i) {
+                const MapEntryData& entryData = mapValue.getMapEntry(i);
+                switch (entryData.getKind()) {
+                    case MapEntryData::Kind::One21: {
+                        const auto& maplet = static_cast<const OneToOneMapEntryData&>(entryData);
+                        entries.emplace_back(sourceAdapter(*maplet.getSourceValue()),
+                                             targetAdapter(*maplet.getTargetValue()));
+                        break;
+                    }
+                    default:
+                        assert(false && "Unexpected kind of map entry");
+                }
+            }
+            // Later entries take precedence, as they do in the other applicators.
+            std::stable_sort(entries.begin(), entries.end(),
+                             [](const auto& a, const auto& b) { return a.first < b.first; });
+            auto last = std::unique(entries.rbegin(), entries.rend(),
+                                    [](const auto& a, const auto& b) { return a.first == b.first; });
+            entries.erase(entries.begin(), last.base());
+
+            if constexpr (std::is_integral_v<T>) {
+                if (!entries.empty()) {
+                    const T min = entries.front().first;
+                    const T max = entries.back().first;
+                    const std::uint64_t tableSize =
+                        static_cast<std::uint64_t>(max) - static_cast<std::uint64_t>(min) + 1;
+                    if ((tableSize != 0) && (tableSize <= s_maxDenseTableSize)) {
+                        m_representation = Representation::DenseTable;
+                        m_tableMin = min;
+                        m_table.reserve(tableSize);
+                        for (std::uint64_t i = 0; i < tableSize; ++i) {
+                            m_table.emplace_back(m_fallbackHelper.getFallback(static_cast<T>(min + i)));
+                        }
+                        for (auto& [source, target] : entries) {
+                            m_table[static_cast<std::uint64_t>(source - min)] = std::move(target);
+                        }
+                        return;
+                    }
+                }
+            }
+            if (entries.size() <= s_maxSortedArraySize) {
+                m_representation = Representation::SortedArray;
+                m_sortedSources.reserve(entries.size());
+                m_table.reserve(entries.size());
+                for (auto& [source, target] : entries) {
+                    m_sortedSources.emplace_back(std::move(source));
+                    m_table.emplace_back(std::move(target));
+                }
+            } else {
+                m_representation = Representation::HashTable;
+                m_map.reserve(entries.size());
+                for (auto& [source, target] : entries) {
+                    m_map.emplace(std::move(source), std::move(target));
+                }
+            }
+        }
+
+      public:
+        U operator[](const T& t) const {
+            switch (m_representation) {
+                case Representation::DenseTable:
+                    return applyDense(t);
+                case Representation::SortedArray:
+                    return applySorted(t);
+                case Representation::HashTable:
+                default:
+                    return applyHashed(t);
+            }
+        }
+
+        /// Apply the map to each element of in, writing the results to the corresponding element of out.
+        /// The choice of representation is made once for the whole batch rather than per element.
+        void apply(std::span<const T> in, std::span<U> out) const {
+            assert((in.size() == out.size()) && "The input and output of a batch apply must have the same size");
+            switch (m_representation) {
+                case Representation::DenseTable:
+                    std::transform(in.begin(), in.end(), out.begin(), [this](const T& t) { return applyDense(t); });
+                    break;
+                case Representation::SortedArray:
+                    std::transform(in.begin(), in.end(), out.begin(), [this](const T& t) { return applySorted(t); });
+                    break;
+                case Representation::HashTable:
+                    std::transform(in.begin(), in.end(), out.begin(), [this](const T& t) { return applyHashed(t); });
+                    break;
+            }
+        }
+
+        Representation getRepresentation() const { return m_representation; }
+
+      private:
+        U applyDense(const T& t) const {
+            if constexpr (std::is_integral_v<T>) {
+                // Values below the minimum wrap to large offsets, so a single comparison checks both bounds.
+                const std::uint64_t offset = static_cast<std::uint64_t>(t) - static_cast<std::uint64_t>(m_tableMin);
+                if (offset < m_table.size()) {
+                    return m_table[offset];
+                }
+                return m_fallbackHelper.getFallback(t);
+            } else {
+                assert(false && "Only integral sources can use a dense table");
+                return m_fallbackHelper.getFallback(t);
+            }
+        }
+
+        U applySorted(const T& t) const {
+            const auto it = std::lower_bound(m_sortedSources.begin(), m_sortedSources.end(), t);
+            if ((it != m_sortedSources.end()) && (*it == t)) {
+                return m_table[it - m_sortedSources.begin()];
+            }
+            return m_fallbackHelper.getFallback(t);
+        }
+
+        U applyHashed(const T& t) const {
+            const auto it = m_map.find(t);
+            if (it != m_map.end()) {
+                return it->second;
+            }
+            return m_fallbackHelper.getFallback(t);
+        }
+
+      private:
+        MapApplicatorFallbackHelper<T, U> m_fallbackHelper;
+        Representation m_representation = Representation::SortedArray;
+
+        /// The targets of the dense table, or of the sorted array (in parallel with m_sortedSources).
+        std::vector<U> m_table;
+
+        /// The source corresponding to m_table[0] when using a dense table.
+        T m_tableMin{};
+
+        /// The sources of the sorted array, in increasing order.
+        std::vector<T> m_sortedSources;
+
+        std::unordered_map<T, U> m_map;
+    };
+} // namespace babelwires
@@ -0,0 +1,10 @@
+/**
+ * Converts IntValues, RationalValues and StringValues to native C++ values.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <BabelWiresLib/Types/Map/Helpers/scalarValueAdapters.hpp>
+
+// This empty file ensures the header is included in the library.
@@ -0,0 +1,36 @@
+/**
+ * Converts IntValues, RationalValues and StringValues to native C++ values.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BabelWiresLib/babelWiresLibExport.hpp>
+#include <BabelWiresLib/Types/Int/intValue.hpp>
+#include <BabelWiresLib/Types/Rational/rationalValue.hpp>
+#include <BabelWiresLib/Types/String/stringValue.hpp>
+
+namespace babelwires {
+    /// Convert an IntValue to the integer it carries.
+    struct BABELWIRESLIB_API IntToNativeValueAdapter {
+        IntValue::NativeType operator() (const Value& value) const {
+            return value.as<IntValue>().get();
+        }
+    };
+
+    /// Convert a RationalValue to the rational it carries.
+    struct BABELWIRESLIB_API RationalToNativeValueAdapter {
+        Rational operator() (const Value& value) const {
+            return value.as<RationalValue>().get();
+        }
+    };
+
+    /// Convert a StringValue to the string it carries.
+    struct BABELWIRESLIB_API StringToNativeValueAdapter {
+        std::string operator() (const Value& value) const {
+            return value.as<StringValue>().get();
+        }
+    };
+} // namespace babelwires
@@ -32,6 +32,7 @@ babelwires::RecordType::RecordType(TypeExp&& typeExpOfThis, const TypeSystem& ty
     : CompoundType(std::move(typeExpOfThis)) {
     m_fields.reserve(fields.size());
     addFields(typeSystem, m_fields, m_optionalFieldIds, fields);
+    initializeFieldIndices();
 }
 
 babelwires::RecordType::RecordType(TypeExp&& typeExpOfThis, const TypeSystem& typeSystem, const RecordType& parent,
@@ -41,6 +42,7 @@ babelwires::RecordType::RecordType(TypeExp&& typeExpOfThis, const TypeSystem& ty
     m_fields = parent.m_fields;
     m_optionalFieldIds = parent.m_optionalFieldIds;
     addFields(typeSystem, m_fields, m_optionalFieldIds, additionalFields);
+    initializeFieldIndices();
 }
 
 babelwires::RecordType::RecordType(TypeExp&& typeExp, std::vector<Field> fields)
@@ -52,6 +54,18 @@ babelwires::RecordType::RecordType(TypeExp&& typeExp, std::vector<Field> fields)
             m_optionalFieldIds.emplace_back(f.m_identifier);
         }
     }
+    initializeFieldIndices();
+}
+
+void babelwires::RecordType::initializeFieldIndices() {
+    m_fieldIndexFromId.reserve(m_fields.size());
+    for (unsigned int i = 0; i < m_fields.size(); ++i) {
+        m_fieldIndexFromId.emplace(m_fields[i].m_identifier, i);
+    }
+    if (!m_optionalFieldIds.empty()) {
+        // Any unique allocation will do.
+        m_activeFieldIndexKey = std::make_shared<int>(0);
+    }
 }
 
 std::string babelwires::RecordType::getFlavour() const {
@@ -59,10 +73,9 @@ std::string babelwires::RecordType::getFlavour() const {
 }
 
 const babelwires::RecordType::Field* babelwires::RecordType::tryGetField(ShortId fieldId) const {
-    for (const auto& f : m_fields) {
-        if (f.m_identifier == fieldId) {
-            return &f;
-        }
+    const auto it = m_fieldIndexFromId.find(fieldId);
+    if (it != m_fieldIndexFromId.end()) {
+        return &m_fields[it->second];
     }
     return nullptr;
 }
@@ -194,24 +207,54 @@ bool babelwires::RecordType::visitValue(const TypeSystem& typeSystem, const Valu
     return true;
 }
 
+const babelwires::RecordType::ActiveFieldIndex*
+babelwires::RecordType::getActiveFieldIndex(const RecordValue& recordValue) const {
+    assert(m_activeFieldIndexKey && "Only records with optionals need an index");
+    if (const ActiveFieldIndex* const index = recordValue.tryGetActiveFieldIndex(m_activeFieldIndexKey.get())) {
+        return index;
+    }
+    auto newIndex = std::make_unique<ActiveFieldIndex>();
+    newIndex->m_key = m_activeFieldIndexKey;
+    newIndex->m_childIndexFromFieldIndex.resize(m_fields.size(), -1);
+    newIndex->m_fieldIndexFromChildIndex.reserve(m_fields.size());
+    for (unsigned int i = 0; i < m_fields.size(); ++i) {
+        const Field& f = m_fields[i];
+        if ((f.m_optionality == Optionality::alwaysActive) || recordValue.tryGetValue(f.m_identifier)) {
+            newIndex->m_childIndexFromFieldIndex[i] = newIndex->m_fieldIndexFromChildIndex.size();
+            newIndex->m_fieldIndexFromChildIndex.emplace_back(i);
+        }
+    }
+    return recordValue.trySetActiveFieldIndex(std::move(newIndex));
+}
+
 unsigned int babelwires::RecordType::getNumChildren(const ValueHolder& compoundValue) const {
     // Although the value might have additional children, it is being queried here through the lens of _this_ type.
+    if (m_optionalFieldIds.empty()) {
+        return m_fields.size();
+    }
+    if (const ActiveFieldIndex* const index = getActiveFieldIndex(compoundValue->as<RecordValue>())) {
+        return index->m_fieldIndexFromChildIndex.size();
+    }
     return m_fields.size() - m_optionalFieldIds.size() + getNumActiveFields(compoundValue);
 }
 
 const babelwires::RecordType::Field& babelwires::RecordType::getFieldFromChildIndex(const ValueHolder& compoundValue,
                                                                                     unsigned int i) const {
-    unsigned int j = 0;
-    if (m_optionalFieldIds.size() == 0) {
+    if (m_optionalFieldIds.empty()) {
+        assert((i < m_fields.size()) && "Child index out of range");
         return m_fields[i];
-    } else {
-        for (const auto& f : m_fields) {
-            if ((f.m_optionality == Optionality::alwaysActive) || isActivated(compoundValue, f.m_identifier)) {
-                if (i == j) {
-                    return f;
-                }
-                ++j;
+    }
+    if (const ActiveFieldIndex* const index = getActiveFieldIndex(compoundValue->as<RecordValue>())) {
+        assert((i < index->m_fieldIndexFromChildIndex.size()) && "Child index out of range");
+        return m_fields[index->m_fieldIndexFromChildIndex[i]];
+    }
+    unsigned int j = 0;
+    for (const auto& f : m_fields) {
+        if ((f.m_optionality == Optionality::alwaysActive) || isActivated(compoundValue, f.m_identifier)) {
+            if (i == j) {
+                return f;
             }
+            ++j;
         }
     }
     assert(false && "Child index out of range");
@@ -239,6 +282,16 @@ int babelwires::RecordType::getChildIndexFromStep(const ValueHolder& compoundVal
         return -1;
     }
     const ShortId id = *step.asField();
+    const auto it = m_fieldIndexFromId.find(id);
+    if (it == m_fieldIndexFromId.end()) {
+        return -1;
+    }
+    if (m_optionalFieldIds.empty()) {
+        return it->second;
+    }
+    if (const ActiveFieldIndex* const index = getActiveFieldIndex(compoundValue->as<RecordValue>())) {
+        return index->m_childIndexFromFieldIndex[it->second];
+    }
     int index = 0;
     for (const auto& f : m_fields) {
         if ((f.m_optionality == Optionality::alwaysActive) || isActivated(compoundValue, f.m_identifier)) {
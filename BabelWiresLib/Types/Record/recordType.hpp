@@ -13,9 +13,12 @@
 #include <BaseLib/Result/result.hpp>
 
 #include <map>
+#include <unordered_map>
 
 namespace babelwires {
 
+    class RecordValue;
+
     /// RecordType carries a sequence of Fields (some of which are optional and can be inactive).
     class BABELWIRESLIB_API RecordType : public CompoundType {
       public:
@@ -108,15 +111,45 @@ namespace babelwires {
         std::string valueToString(const TypeSystem& typeSystem, const ValueHolder& v) const override;
 
       private:
+        friend RecordValue;
+
+        /// Maps between child indices and field indices of a particular RecordType, for the fields active in
+        /// a RecordValue. It is computed lazily and cached in the value, which discards it whenever its set of
+        /// fields changes.
+        struct ActiveFieldIndex {
+            /// Identifies the RecordType for which this was computed. Holding a reference ensures the
+            /// key cannot be reused by another type.
+            std::shared_ptr<const void> m_key;
+            /// For each child index, the index of its field in the type.
+            std::vector<unsigned int> m_fieldIndexFromChildIndex;
+            /// For each field in the type, its child index, or -1 if it is not active.
+            std::vector<int> m_childIndexFromFieldIndex;
+        };
+
+        /// Called by the constructors once m_fields is populated.
+        void initializeFieldIndices();
+
         const Field* tryGetField(ShortId fieldId) const;
         const Field& getField(ShortId fieldId) const;
         const Field& getFieldFromChildIndex(const ValueHolder& compoundValue, unsigned int i) const;
 
+        /// Get a table mapping between child indices and fields for the value.
+        /// This is cached in the value, so access to children is O(1) when the record has optionals.
+        /// Returns nullptr if the value has already cached a table for a different type, in which case
+        /// the caller has to fall back to a scan.
+        const ActiveFieldIndex* getActiveFieldIndex(const RecordValue& recordValue) const;
+
       private:
         /// The inactive fields, sorted by activeIndex;
         std::vector<Field> m_fields;
 
         /// Those fields which are optional.
         std::vector<ShortId> m_optionalFieldIds;
+
+        /// The index of each field in m_fields.
+        std::unordered_map<ShortId, unsigned int> m_fieldIndexFromId;
+
+        /// Identifies this type in the ActiveFieldIndex tables cached in RecordValues.
+        std::shared_ptr<const void> m_activeFieldIndexKey;
     };
 } // namespace babelwires
@@ -7,6 +7,28 @@
  **/
 #include <BabelWiresLib/Types/Record/recordValue.hpp>
 
+babelwires::RecordValue::RecordValue(const RecordValue& other)
+    : Value(other)
+    , m_fieldValues(other.m_fieldValues) {
+    // The fields are the same, so the index remains valid for the copy.
+    if (const ActiveFieldIndex* const index = other.m_activeFieldIndex.load(std::memory_order_acquire)) {
+        m_activeFieldIndex.store(new ActiveFieldIndex(*index), std::memory_order_relaxed);
+    }
+}
+
+babelwires::RecordValue& babelwires::RecordValue::operator=(const RecordValue& other) {
+    if (this != &other) {
+        Value::operator=(other);
+        m_fieldValues = other.m_fieldValues;
+        clearActiveFieldIndex();
+    }
+    return *this;
+}
+
+babelwires::RecordValue::~RecordValue() {
+    clearActiveFieldIndex();
+}
+
 babelwires::ValueHolder& babelwires::RecordValue::getValue(ShortId fieldId) {
     auto it = m_fieldValues.find(fieldId);
     assert((it != m_fieldValues.end()) && "Field not found in RecordValue");
@@ -36,13 +58,38 @@ const babelwires::ValueHolder* babelwires::RecordValue::tryGetValue(ShortId fiel
 }
 
 void babelwires::RecordValue::setValue(ShortId fieldId, ValueHolder newValue) {
-    m_fieldValues.insert({fieldId, newValue});
+    if (m_fieldValues.insert({fieldId, newValue}).second) {
+        clearActiveFieldIndex();
+    }
 }
 
 void babelwires::RecordValue::removeValue(ShortId fieldId) {
     auto it = m_fieldValues.find(fieldId);
     assert((it != m_fieldValues.end()) && "Fields not found in RecordValue");
     m_fieldValues.erase(it);
+    clearActiveFieldIndex();
+}
+
+const babelwires::RecordValue::ActiveFieldIndex* babelwires::RecordValue::tryGetActiveFieldIndex(const void* key) const {
+    const ActiveFieldIndex* const index = m_activeFieldIndex.load(std::memory_order_acquire);
+    if (index && (index->m_key.get() == key)) {
+        return index;
+    }
+    return nullptr;
+}
+
+const babelwires::RecordValue::ActiveFieldIndex*
+babelwires::RecordValue::trySetActiveFieldIndex(std::unique_ptr<ActiveFieldIndex> index) const {
+    const ActiveFieldIndex* expected = nullptr;
+    if (m_activeFieldIndex.compare_exchange_strong(expected, index.get(), std::memory_order_acq_rel)) {
+        return index.release();
+    }
+    // Another reader published first. That's fine if it computed the same thing.
+    return (expected->m_key == index->m_key) ? expected : nullptr;
+}
+
+void babelwires::RecordValue::clearActiveFieldIndex() {
+    delete m_activeFieldIndex.exchange(nullptr, std::memory_order_acq_rel);
 }
 
 std::size_t babelwires::RecordValue::getHash() const {
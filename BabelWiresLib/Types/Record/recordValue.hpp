@@ -13,6 +13,7 @@
 #include <BabelWiresLib/TypeSystem/valueHolder.hpp>
 #include <BabelWiresLib/Types/Record/recordType.hpp>
 
+#include <atomic>
 #include <vector>
 
 namespace babelwires {
@@ -22,6 +23,11 @@ namespace babelwires {
         DOWNCASTABLE(RecordValue, Value);
         CLONEABLE(RecordValue);
 
+        RecordValue() = default;
+        RecordValue(const RecordValue& other);
+        RecordValue& operator=(const RecordValue& other);
+        ~RecordValue();
+
         ValueHolder& getValue(ShortId fieldId);
         const ValueHolder& getValue(ShortId fieldId) const;
 
@@ -34,8 +40,27 @@ namespace babelwires {
         std::size_t getHash() const override;
         bool operator==(const Value& other) const override;
 
+      private:
+        friend RecordType;
+
+        using ActiveFieldIndex = RecordType::ActiveFieldIndex;
+
+        /// Return the cached index if it was computed with the given key.
+        const ActiveFieldIndex* tryGetActiveFieldIndex(const void* key) const;
+
+        /// Try to cache the index. If another index is already cached, this returns nullptr.
+        /// This can be called on a shared value, since publication is atomic.
+        const ActiveFieldIndex* trySetActiveFieldIndex(std::unique_ptr<ActiveFieldIndex> index) const;
+
+        /// Called when the set of fields changes.
+        void clearActiveFieldIndex();
+
       private:
         std::unordered_map<ShortId, ValueHolder> m_fieldValues;
+
+        /// Owned. Since values are immutable once shared, this is only ever published once, but that
+        /// can happen concurrently from multiple readers.
+        mutable std::atomic<const ActiveFieldIndex*> m_activeFieldIndex = nullptr;
     };
 
 } // namespace babelwires
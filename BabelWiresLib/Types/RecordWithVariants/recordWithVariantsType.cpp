@@ -20,34 +20,52 @@ babelwires::RecordWithVariantsType::RecordWithVariantsType(TypeExp&& typeExpOfTh
     , m_defaultTag(m_tags[defaultTagIndex]) {
     assert((m_tags.size() > 0) && "Empty tags set not allowed");
     assert(defaultTagIndex < m_tags.size());
-    m_tagToVariantCache.reserve(m_tags.size());
-    m_fields.reserve(fields.size());
-    for (const auto& t : m_tags) {
-        // It's allowed for a tag not to have any associated fields.
-        // Ensure that it has an entry in the cache anyway.
-        m_tagToVariantCache[t] = {};
+    m_tagIndexFromTag.reserve(m_tags.size());
+    for (unsigned int i = 0; i < m_tags.size(); ++i) {
+        m_tagIndexFromTag.emplace(m_tags[i], i);
     }
+    m_fields.reserve(fields.size());
     for (const auto& f : fields) {
         m_fields.emplace_back(Field{f.m_identifier, f.m_type.assertResolve(typeSystem), std::move(f.m_tags)});
     }
-    for (const auto& f : m_fields) {
+    // It's allowed for a tag not to have any associated fields, in which case its variant is empty.
+    m_variants.resize(m_tags.size());
+    for (auto& variant : m_variants) {
+        variant.m_hasField.resize(m_fields.size(), false);
+    }
+    auto addFieldToVariant = [this](unsigned int fieldIndex, Variant& variant) {
+        const Field& f = m_fields[fieldIndex];
+        if (!variant.m_hasField[fieldIndex]) {
+            variant.m_hasField[fieldIndex] = true;
+            variant.m_childIndexFromFieldId.emplace(f.m_identifier, variant.m_fields.size());
+            // m_fields is private and there is no API for manipulating it after construction, so this should be
+            // safe.
+            variant.m_fields.emplace_back(&f);
+        }
+    };
+    for (unsigned int i = 0; i < m_fields.size(); ++i) {
+        const Field& f = m_fields[i];
         if (f.m_tags.empty()) {
             // Empty means this field is in every variant.
-            for (const auto& t : m_tags) {
-                m_tagToVariantCache[t].emplace_back(&f);
+            for (auto& variant : m_variants) {
+                addFieldToVariant(i, variant);
             }
         } else {
             for (const auto& t : f.m_tags) {
-                const auto it = std::find(m_tags.begin(), m_tags.end(), t);
-                assert((it != m_tags.end()) && "Field uses tag which is not in the tag set.");
-                // m_fields is private and there is no API for manipulating it after construction, so this should be
-                // safe.
-                m_tagToVariantCache[t].emplace_back(&f);
+                const auto it = m_tagIndexFromTag.find(t);
+                assert((it != m_tagIndexFromTag.end()) && "Field uses tag which is not in the tag set.");
+                addFieldToVariant(i, m_variants[it->second]);
             }
         }
     }
 }
 
+const babelwires::RecordWithVariantsType::Variant& babelwires::RecordWithVariantsType::getVariant(ShortId tag) const {
+    const auto it = m_tagIndexFromTag.find(tag);
+    assert((it != m_tagIndexFromTag.end()) && "RecordWithVariant has unrecognized tag");
+    return m_variants[it->second];
+}
+
 std::string babelwires::RecordWithVariantsType::getFlavour() const {
     return "variant";
 }
@@ -57,13 +75,13 @@ const babelwires::RecordWithVariantsType::Tags& babelwires::RecordWithVariantsTy
 }
 
 bool babelwires::RecordWithVariantsType::isTag(ShortId tag) const {
-    return std::find(m_tags.begin(), m_tags.end(), tag) != m_tags.end();
+    return m_tagIndexFromTag.find(tag) != m_tagIndexFromTag.end();
 }
 
 unsigned int babelwires::RecordWithVariantsType::getIndexOfTag(ShortId tag) const {
-    assert(isTag(tag) && "getIndexOfTag called with tag which is not a tag of this type");
-    const auto it = std::find(m_tags.begin(), m_tags.end(), tag);
-    return std::distance(m_tags.begin(), it);
+    const auto it = m_tagIndexFromTag.find(tag);
+    assert((it != m_tagIndexFromTag.end()) && "getIndexOfTag called with tag which is not a tag of this type");
+    return it->second;
 }
 
 void babelwires::RecordWithVariantsType::assertSelectTag(const TypeSystem& typeSystem, ValueHolder& value,
@@ -97,11 +115,13 @@ babelwires::ShortId babelwires::RecordWithVariantsType::getSelectedTag(const Val
 babelwires::RecordWithVariantsType::FieldChanges
 babelwires::RecordWithVariantsType::getFieldChanges(ShortId currentTag, ShortId proposedTag) const {
     assert(isTag(proposedTag) && "proposed tag is not a tag of this type");
+    const Variant& currentVariant = getVariant(currentTag);
+    const Variant& proposedVariant = getVariant(proposedTag);
     FieldChanges fieldChanges;
+    // Fields in both variants are carried over unchanged.
     for (unsigned int i = 0; i < m_fields.size(); ++i) {
-        const Field& f = m_fields[i];
-        const bool isCurrent = (std::find(f.m_tags.begin(), f.m_tags.end(), currentTag) != f.m_tags.end());
-        const bool isProposed = (std::find(f.m_tags.begin(), f.m_tags.end(), proposedTag) != f.m_tags.end());
+        const bool isCurrent = currentVariant.m_hasField[i];
+        const bool isProposed = proposedVariant.m_hasField[i];
         if (isCurrent && !isProposed) {
             fieldChanges.m_fieldsRemoved.emplace_back(i);
         } else if (!isCurrent && isProposed) {
@@ -124,29 +144,22 @@ babelwires::RecordWithVariantsType::getFieldsRemovedByChangeOfBranch(const Value
 }
 
 unsigned int babelwires::RecordWithVariantsType::getNumChildren(const ValueHolder& compoundValue) const {
-    const ShortId tag = getSelectedTag(compoundValue);
-    const auto it = m_tagToVariantCache.find(tag);
-    assert(it != m_tagToVariantCache.end());
-    return it->second.size();
+    return getVariant(getSelectedTag(compoundValue)).m_fields.size();
 }
 
 std::tuple<const babelwires::ValueHolder*, babelwires::PathStep, const babelwires::TypePtr&>
 babelwires::RecordWithVariantsType::getChild(const ValueHolder& compoundValue, unsigned int i) const {
-    const ShortId tag = getSelectedTag(compoundValue);
-    const auto it = m_tagToVariantCache.find(tag);
-    assert(it != m_tagToVariantCache.end());
+    const Variant& variant = getVariant(getSelectedTag(compoundValue));
     const auto& recordValue = compoundValue->as<RecordWithVariantsValue>();
-    const Field& f = *it->second[i];
+    const Field& f = *variant.m_fields[i];
     return {&recordValue.getValue(f.m_identifier), PathStep{f.m_identifier}, f.m_type};
 }
 
 std::tuple<babelwires::ValueHolder*, babelwires::PathStep, const babelwires::TypePtr&>
 babelwires::RecordWithVariantsType::getChildNonConst(ValueHolder& compoundValue, unsigned int i) const {
-    const ShortId tag = getSelectedTag(compoundValue);
-    const auto it = m_tagToVariantCache.find(tag);
-    assert(it != m_tagToVariantCache.end());
+    const Variant& variant = getVariant(getSelectedTag(compoundValue));
     RecordWithVariantsValue& recordValue = compoundValue.copyContentsAndGetNonConst().as<RecordWithVariantsValue>();
-    const Field& f = *it->second[i];
+    const Field& f = *variant.m_fields[i];
     return {&recordValue.getValue(f.m_identifier), PathStep{f.m_identifier}, f.m_type};
 }
 
@@ -156,21 +169,17 @@ int babelwires::RecordWithVariantsType::getChildIndexFromStep(const ValueHolder&
         return -1;
     }
     const ShortId stepId = *step.asField();
-    const ShortId tag = getSelectedTag(compoundValue);
-    const auto it = m_tagToVariantCache.find(tag);
-    assert(it != m_tagToVariantCache.end());
-    for (unsigned int i = 0; i < it->second.size(); ++i) {
-        const Field& f = *it->second[i];
-        if (f.m_identifier == stepId) {
-            return i;
-        }
+    const Variant& variant = getVariant(getSelectedTag(compoundValue));
+    const auto it = variant.m_childIndexFromFieldId.find(stepId);
+    if (it != variant.m_childIndexFromFieldId.end()) {
+        return it->second;
     }
     return -1;
 }
 
 babelwires::NewValueHolder babelwires::RecordWithVariantsType::createValue(const TypeSystem& typeSystem) const {
     auto newValue = babelwires::ValueHolder::makeValue<RecordWithVariantsValue>(m_defaultTag);
-    for (const auto* f : m_tagToVariantCache.find(m_defaultTag)->second) {
+    for (const auto* f : getVariant(m_defaultTag).m_fields) {
         newValue.m_nonConstReference.setValue(f->m_identifier, f->m_type->createValue(typeSystem));
     }
     return std::move(newValue);
@@ -182,11 +191,11 @@ bool babelwires::RecordWithVariantsType::visitValue(const TypeSystem& typeSystem
     if (!recordValue) {
         return false;
     }
-    const ShortId tag = recordValue->getTag();
-    if (!isTag(tag)) {
+    const auto tagIt = m_tagIndexFromTag.find(recordValue->getTag());
+    if (tagIt == m_tagIndexFromTag.end()) {
         return false;
     }
-    for (const auto* f : m_tagToVariantCache.find(tag)->second) {
+    for (const auto* f : m_variants[tagIt->second].m_fields) {
         const ValueHolder* const value = recordValue->tryGetValue(f->m_identifier);
         if (!value) {
             return false;
@@ -292,8 +301,8 @@ babelwires::RecordWithVariantsType::compareSubtypeHelper(const TypeSystem& typeS
     auto otherIt = otherTags.begin();
     while ((thisIt < tags.end()) && (otherIt < otherTags.end())) {
         if (*thisIt == *otherIt) {
-            std::vector<const Field*> thisFields = m_tagToVariantCache.find(*thisIt)->second;
-            std::vector<const Field*> otherFields = otherRecord->m_tagToVariantCache.find(*otherIt)->second;
+            std::vector<const Field*> thisFields = getVariant(*thisIt).m_fields;
+            std::vector<const Field*> otherFields = otherRecord->getVariant(*otherIt).m_fields;
 
             const SubtypeOrder fieldComparison = sortAndCompareFieldSets(typeSystem, thisFields, otherFields);
             if (updateAndCheckDisjoint(currentOrder, fieldComparison)) {
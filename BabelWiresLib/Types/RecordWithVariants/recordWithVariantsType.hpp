@@ -12,6 +12,8 @@
 
 #include <BaseLib/Result/result.hpp>
 
+#include <unordered_map>
+
 namespace babelwires {
 
     /// RecordWithVariantsType is like a RecordType but has a number of variants.
@@ -112,9 +114,24 @@ namespace babelwires {
         // Keep private: see constructor.
         std::vector<Field> m_fields;
 
-        /// Caches what fields are available in each variant
-        /// Points into the m_fields struct.
-        std::unordered_map<ShortId, std::vector<const Field*>> m_tagToVariantCache;
+        /// What fields are available in a variant, precomputed so child access does not need to search.
+        struct Variant {
+            /// The fields in child order. Points into the m_fields struct.
+            std::vector<const Field*> m_fields;
+            /// The child index of each of the fields.
+            std::unordered_map<ShortId, unsigned int> m_childIndexFromFieldId;
+            /// Indexed in parallel with the m_fields of the type, this says whether the variant contains the field.
+            std::vector<bool> m_hasField;
+        };
+
+        /// Asserts that the tag is a tag of this type.
+        const Variant& getVariant(ShortId tag) const;
+
+        /// The variant of each tag, indexed in parallel with m_tags.
+        std::vector<Variant> m_variants;
+
+        /// Fast look-up of the index of a tag.
+        std::unordered_map<ShortId, unsigned int> m_tagIndexFromTag;
     };
 
 } // namespace babelwires
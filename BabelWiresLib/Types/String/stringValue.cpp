@@ -11,24 +11,46 @@
 
 #include <BaseLib/Serialization/serializer.hpp>
 #include <BaseLib/Serialization/deserializer.hpp>
+#include <BaseLib/Result/resultDSL.hpp>
+
+namespace {
+    std::size_t getStringHash(std::string_view string) {
+        return std::hash<std::string_view>()(string);
+    }
+} // namespace
 
 babelwires::StringValue::StringValue() = default;
-babelwires::StringValue::StringValue(std::string value) : m_value(std::move(value)) {}
+
+babelwires::StringValue::StringValue(std::string value) {
+    set(std::move(value));
+}
 
 std::string babelwires::StringValue::get() const {
-    return m_value;
+    return std::string(getView());
+}
+
+std::string_view babelwires::StringValue::getView() const {
+    return m_buffer ? std::string_view(m_buffer->m_string) : std::string_view();
 }
 
 void babelwires::StringValue::set(std::string value) {
-    m_value = std::move(value);
+    if (value.empty()) {
+        m_buffer.reset();
+    } else if (!m_buffer || (m_buffer->m_string != value)) {
+        const std::size_t hash = getStringHash(value);
+        m_buffer = std::make_shared<const SharedString>(SharedString{std::move(value), hash});
+    }
 }
 
 void babelwires::StringValue::serializeContents(Serializer& serializer) const {
-    serializer.serializeValue("value", m_value);
+    serializer.serializeValue("value", getView());
 }
 
 babelwires::Result babelwires::StringValue::deserializeContents(Deserializer& deserializer) {
-    return deserializer.deserializeValue("value", m_value);
+    std::string value;
+    DO_OR_ERROR(deserializer.deserializeValue("value", value));
+    set(std::move(value));
+    return {};
 }
 
 void babelwires::StringValue::visitIdentifiers(IdentifierVisitor& visitor) {
@@ -48,14 +70,23 @@ bool babelwires::StringValue::canContainFilePaths() const {
 }
 
 std::size_t babelwires::StringValue::getHash() const {
-    return std::hash<std::string>()(m_value);
+    return m_buffer ? m_buffer->m_hash : getStringHash({});
 }
 
 bool babelwires::StringValue::operator==(const Value& other) const {
     const StringValue* otherValue = other.tryAs<StringValue>();
-    return otherValue && (m_value == otherValue->m_value);
+    if (!otherValue) {
+        return false;
+    }
+    if (m_buffer == otherValue->m_buffer) {
+        return true;
+    }
+    if (!m_buffer || !otherValue->m_buffer || (m_buffer->m_hash != otherValue->m_buffer->m_hash)) {
+        return false;
+    }
+    return m_buffer->m_string == otherValue->m_buffer->m_string;
 }
 
 std::string babelwires::StringValue::toString() const {
-    return m_value;
+    return get();
 }
@@ -10,6 +10,9 @@
 #include <BabelWiresLib/babelWiresLibExport.hpp>
 #include <BabelWiresLib/TypeSystem/editableValue.hpp>
 
+#include <memory>
+#include <string_view>
+
 namespace babelwires {
 
     class BABELWIRESLIB_API StringValue : public AlwaysEditableValue {
@@ -21,7 +24,14 @@ namespace babelwires {
         StringValue();
         StringValue(std::string value);
 
+        /// Get a copy of the string.
         std::string get() const;
+
+        /// Get a view of the string without copying it.
+        /// The view is valid until this value is modified or destroyed.
+        std::string_view getView() const;
+
+        /// Set the string. If the contents are unchanged, the existing buffer is kept.
         void set(std::string value);
 
         void serializeContents(Serializer& serializer) const override;
@@ -35,7 +45,16 @@ namespace babelwires {
         std::string toString() const override;
 
       private:
-        std::string m_value;
+        /// The character data is immutable once created, so copies of a StringValue (e.g. when
+        /// a compound value containing it is cloned) can share it.
+        struct SharedString {
+            std::string m_string;
+            /// Computed once, when the buffer is created.
+            std::size_t m_hash;
+        };
+
+        /// Null when the string is empty.
+        std::shared_ptr<const SharedString> m_buffer;
     };
 
 } // namespace babelwires
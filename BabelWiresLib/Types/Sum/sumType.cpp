@@ -10,6 +10,16 @@
 #include <BabelWiresLib/TypeSystem/subtypeUtils.hpp>
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
 
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+namespace {
+    /// When a shard is full, entries for values which no longer exist are discarded. If none are, the shard is
+    /// cleared.
+    constexpr std::size_t c_maximumNumIndexCacheEntriesPerShard = 1 << 11;
+} // namespace
+
 babelwires::SumType::SumType(TypeExp&& typeExpOfThis, const TypeSystem& typeSystem, SummandTypeExps summands, unsigned int indexOfDefaultSummand)
     : Type(std::move(typeExpOfThis))
     , m_indexOfDefaultSummand(indexOfDefaultSummand) {
@@ -31,7 +41,39 @@ babelwires::NewValueHolder babelwires::SumType::createValue(const TypeSystem& ty
     return m_summands[m_indexOfDefaultSummand]->createValue(typeSystem);
 }
 
+babelwires::SumType::IndexCacheShard& babelwires::SumType::getIndexCacheShard(const Value* v) const {
+    // The address only selects the shard. Fibonacci hashing spreads its bits into the top bits used to select it.
+    const std::uint64_t mixed = reinterpret_cast<std::uintptr_t>(v) * 0x9E3779B97F4A7C15ull;
+    return m_indexCacheShards[mixed >> (std::numeric_limits<std::uint64_t>::digits - c_log2NumIndexCacheShards)];
+}
+
 int babelwires::SumType::getIndexOfValue(const TypeSystem& typeSystem, const Value& v) const {
+    // Values which are not owned by a ValueHolder can be modified, so their index is not cached.
+    std::weak_ptr<const Value> identity = v.weak_from_this();
+    if (identity.expired()) {
+        return getIndexOfValueUncached(typeSystem, v);
+    }
+    IndexCacheShard& shard = getIndexCacheShard(&v);
+    {
+        std::shared_lock lock(shard.m_mutex);
+        const auto it = shard.m_entries.find(identity);
+        if (it != shard.m_entries.end()) {
+            return it->second;
+        }
+    }
+    const int index = getIndexOfValueUncached(typeSystem, v);
+    std::unique_lock lock(shard.m_mutex);
+    if (shard.m_entries.size() >= c_maximumNumIndexCacheEntriesPerShard) {
+        std::erase_if(shard.m_entries, [](const auto& entry) { return entry.first.expired(); });
+        if (shard.m_entries.size() >= c_maximumNumIndexCacheEntriesPerShard) {
+            shard.m_entries.clear();
+        }
+    }
+    shard.m_entries.insert_or_assign(std::move(identity), index);
+    return index;
+}
+
+int babelwires::SumType::getIndexOfValueUncached(const TypeSystem& typeSystem, const Value& v) const {
     const auto it = std::find_if(m_summands.cbegin(), m_summands.cend(), [&typeSystem, &v](const TypePtr& summand) {
         return summand->isValidValue(typeSystem, v);
     });
@@ -10,6 +10,11 @@
 #include <BabelWiresLib/babelWiresLibExport.hpp>
 #include <BabelWiresLib/TypeSystem/type.hpp>
 
+#include <array>
+#include <memory>
+#include <map>
+#include <shared_mutex>
+
 namespace babelwires {
 
     /// SumType is the type which allows any value of any of a number of other types.
@@ -35,6 +40,8 @@ namespace babelwires {
 
         /// Return the index of the first summand of which v is a valid value.
         /// Returns -1 if the value is not valid.
+        /// The index of a value owned by a ValueHolder is cached, so it is only computed once for that value.
+        /// Such a value must not be modified after its index has been queried.
         int getIndexOfValue(const TypeSystem& typeSystem, const Value& v) const;
 
         bool visitValue(const TypeSystem& typeSystem, const Value& v, ChildValueVisitor& visitor) const override;
@@ -60,8 +67,25 @@ namespace babelwires {
         /// testing As a supertype of Bs.
         static SubtypeOrder opCombine(SubtypeOrder subTest, SubtypeOrder superTest);
 
+      private:
+        /// Find the index by checking the summands in turn.
+        int getIndexOfValueUncached(const TypeSystem& typeSystem, const Value& v) const;
+
+        /// The cache is split into shards with their own mutex, to reduce contention.
+        struct alignas(64) IndexCacheShard {
+            std::shared_mutex m_mutex;
+            /// Keyed by the ownership of the value, which cannot be reused while the key exists.
+            std::map<std::weak_ptr<const Value>, int, std::owner_less<>> m_entries;
+        };
+
+        static constexpr unsigned int c_log2NumIndexCacheShards = 3;
+
+        IndexCacheShard& getIndexCacheShard(const Value* v) const;
+
       private:
         Summands m_summands;
         unsigned int m_indexOfDefaultSummand;
+
+        mutable std::array<IndexCacheShard, 1 << c_log2NumIndexCacheShards> m_indexCacheShards;
     };
 } // namespace babelwires
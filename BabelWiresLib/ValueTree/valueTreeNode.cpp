@@ -18,11 +18,18 @@
 
 #include <BaseLib/Result/error.hpp>
 
+#include <atomic>
 #include <map>
 
+namespace {
+    /// Shared by all trees, so generations are never reused.
+    std::atomic<std::uint64_t> s_nextStructureGeneration = 1;
+} // namespace
+
 babelwires::ValueTreeNode::ValueTreeNode(TypePtr typePtr, ValueHolder value)
     : m_typePtr(std::move(typePtr))
-    , m_value(std::move(value)) {}
+    , m_value(std::move(value))
+    , m_structureGeneration(s_nextStructureGeneration++) {}
 
 babelwires::ValueTreeNode::~ValueTreeNode() = default;
 
@@ -71,21 +78,38 @@ std::size_t babelwires::ValueTreeNode::getHash() const {
 babelwires::ValueTreeNode* babelwires::ValueTreeNode::getChild(int i) {
     assert((i >= 0) && "Negative child index");
     assert((i < getNumChildren()) && "Child index out of range");
-    const auto it = m_children.find1(i);
-    if (it != m_children.end()) {
-        return it.getValue().get();
-    }
-    return nullptr;
+    return m_childrenByIndex[i].getValue().get();
 }
 
 const babelwires::ValueTreeNode* babelwires::ValueTreeNode::getChild(int i) const {
     assert((i >= 0) && "Negative child index");
     assert((i < getNumChildren()) && "Child index out of range");
-    const auto it = m_children.find1(i);
-    if (it != m_children.end()) {
-        return it.getValue().get();
+    return m_childrenByIndex[i].getValue().get();
+}
+
+const babelwires::PathStep& babelwires::ValueTreeNode::getStepToChildAtIndex(int i) const {
+    assert((i >= 0) && "Negative child index");
+    assert((i < getNumChildren()) && "Child index out of range");
+    return m_childrenByIndex[i].getKey0();
+}
+
+void babelwires::ValueTreeNode::updateChildrenByIndex() {
+    m_childrenByIndex.assign(m_children.size(), m_children.end());
+    for (auto it = m_children.begin(); it != m_children.end(); ++it) {
+        assert((it.getKey1() < m_childrenByIndex.size()) && "Child indices are not contiguous");
+        m_childrenByIndex[it.getKey1()] = it;
+    }
+}
+
+std::uint64_t babelwires::ValueTreeNode::getStructureGeneration() const {
+    return m_structureGeneration;
+}
+
+void babelwires::ValueTreeNode::updateStructureGeneration() {
+    const std::uint64_t newGeneration = s_nextStructureGeneration++;
+    for (ValueTreeNode* current = this; current; current = current->m_owner) {
+        current->m_structureGeneration = newGeneration;
     }
-    return nullptr;
 }
 
 namespace {
@@ -214,6 +238,7 @@ void babelwires::ValueTreeNode::initializeChildren(const TypeSystem& typeSystem)
         child->initializeChildren(typeSystem);
         m_children.insert_or_assign(step, i, std::move(child));
     }
+    updateChildrenByIndex();
 }
 
 void babelwires::ValueTreeNode::reconcileChangesAndSynchronizeChildren(const TypeSystem& typeSystem,
@@ -273,7 +298,7 @@ void babelwires::ValueTreeNode::reconcileChangesAndSynchronizeChildren(const Typ
                     // This ensures the UI updates the connectivity of the node, since a type variable may have been
                     // assigned, allowing connections at compound nodes, or reset, disallowing them.
                     // This is more blunt than it needs to be, but type changes are probably rare.
-                    setChanged(Changes::StructureChanged);
+                    changes = changes | Changes::StructureChanged;
                 }
                 temp->reconcileChangesAndSynchronizeChildren(typeSystem, *otherIt->second.m_value);
                 newChildMap.insert_or_assign(otherIt->first, otherIt->second.m_index, std::move(temp));
@@ -289,6 +314,10 @@ void babelwires::ValueTreeNode::reconcileChangesAndSynchronizeChildren(const Typ
             ++otherIt;
         }
         m_children.swap(newChildMap);
+        updateChildrenByIndex();
+        if (isNonzero(changes & Changes::StructureChanged)) {
+            updateStructureGeneration();
+        }
 
         if (compound->areDifferentNonRecursively(value, other)) {
             changes = changes | Changes::ValueChanged;
@@ -17,6 +17,9 @@
 #include <BabelWiresLib/TypeSystem/typeExp.hpp>
 #include <BabelWiresLib/TypeSystem/valueHolder.hpp>
 
+#include <cstdint>
+#include <vector>
+
 namespace babelwires {
     class Type;
     class ValueTreeRoot;
@@ -56,6 +59,13 @@ namespace babelwires {
         /// Clear the change flags of this node and all its children.
         void clearChanges();
 
+        /// A number which changes whenever nodes are added to or removed from the subtree at this node.
+        /// Numbers are drawn from a counter shared by all trees, so they are never reused: a node which was created, or
+        /// whose subtree changed, after a number was obtained from its tree reports a larger number.
+        /// This means a pointer to a node remains valid as long as the tree reports the number it had when the pointer
+        /// was obtained.
+        std::uint64_t getStructureGeneration() const;
+
         /// Get a hash of the value.
         /// Note: The hash is not required to distinguish the contents of values of different types.
         std::size_t getHash() const;
@@ -96,6 +106,9 @@ namespace babelwires {
         /// Asserts that the given value is a child of this node. 
         PathStep getStepToChild(const ValueTreeNode* child) const;
 
+        /// Get the step which leads to the i-th child. Asserts that i is in range.
+        const PathStep& getStepToChildAtIndex(int i) const;
+
         /// Returns nullptr if the step does not lead to a child.
         ValueTreeNode* tryGetChildFromStep(const PathStep& step);
 
@@ -136,7 +149,14 @@ namespace babelwires {
         void reconcileChangesAndSynchronizeChildren(const TypeSystem& typeSystem, const ValueHolder& other,
                                                     const Path& path, unsigned int pathIndex);
 
+        /// Must be called whenever the set of children changes.
+        void updateChildrenByIndex();
+
       protected:
+        /// Must be called whenever the set of children changes, so this node and its ancestors get a new structure
+        /// generation.
+        void updateStructureGeneration();
+
         /// Set the isChanged flag and that of all parents.
         void setChanged(Changes changes);
 
@@ -160,8 +180,13 @@ namespace babelwires {
         ValueTreeNode* m_owner = nullptr;
         Changes m_changes = Changes::SomethingChanged;
 
+        std::uint64_t m_structureGeneration;
+
         using ChildMap = MultiKeyMap<PathStep, unsigned int, std::unique_ptr<ValueTreeChild>>;
         ChildMap m_children;
+
+        /// Allows the children to be accessed by index without hash look-ups.
+        std::vector<ChildMap::iterator> m_childrenByIndex;
     };
 
     DEFINE_ENUM_FLAG_OPERATORS(ValueTreeNode::Changes);
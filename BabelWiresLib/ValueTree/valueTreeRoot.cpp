@@ -31,6 +31,8 @@ babelwires::ValueTreeRoot::ValueTreeRoot(ComplexConstructorArguments&& arguments
     : ValueTreeNode(std::move(arguments.m_typePtr), std::move(arguments.m_value))
     , m_typeSystem(arguments.m_typeSystem) {
         initializeChildren(arguments.m_typeSystem);
+        // The root's generation must not be older than those of the nodes created beneath it.
+        updateStructureGeneration();
     }
 
 babelwires::ValueTreeRoot::ValueTreeRoot(const TypeSystem& typeSystem, TypePtr typePtr)
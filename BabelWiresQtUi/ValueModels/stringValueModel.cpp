@@ -19,11 +19,11 @@ QWidget* babelwires::StringValueModel::createEditor(QWidget* parent) const {
 
 void babelwires::StringValueModel::setEditorData(QWidget* editor) const {
     const StringValue& v = getValue()->as<StringValue>();
-    const std::string& value = v.get();
+    const std::string_view value = v.getView();
 
     auto lineEditor = qobject_cast<LineEditValueEditor*>(editor);
     assert(lineEditor && "Unexpected editor");
-    lineEditor->setText(value.c_str());
+    lineEditor->setText(QString::fromUtf8(value.data(), value.size()));
 }
 
 babelwires::ValueHolder babelwires::StringValueModel::createValueFromEditorIfDifferent(QWidget* editor) const {
@@ -32,7 +32,7 @@ babelwires::ValueHolder babelwires::StringValueModel::createValueFromEditorIfDif
     const std::string newValue = lineEditor->text().toStdString();
 
     const StringValue& v = getValue()->as<StringValue>();
-    const std::string currentValue = v.get();
+    const std::string_view currentValue = v.getView();
     
     if (newValue != currentValue) {
         return ValueHolder::makeValue<babelwires::StringValue>(newValue);
@@ -38,7 +38,17 @@ namespace babelwires {
             assert(servicePtr && "Service not registered");
             return *static_cast<const T*>(servicePtr);
         }
-        
+
+        /// Get a registered service of type T (const), or nullptr if it is not registered.
+        /// This is for optional services.
+        template <typename T> const T* tryGet() const {
+            const std::uint32_t serviceId = getServiceId<T>();
+            if (serviceId < m_services.size()) {
+                return static_cast<const T*>(m_services[serviceId]);
+            }
+            return nullptr;
+        }
+
         /// Register a service of type T. The caller must ensure the service outlives this Context.
         template <typename T> void registerService(T& service) {
             const std::uint32_t serviceId = getServiceId<T>();
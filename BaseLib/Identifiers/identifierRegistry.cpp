@@ -7,15 +7,111 @@
  **/
 #include <BaseLib/Identifiers/identifierRegistry.hpp>
 
+#include <BaseLib/Hash/hash.hpp>
 #include <BaseLib/Log/debugLogger.hpp>
 #include <BaseLib/Serialization/deserializableClassScope.hpp>
 #include <BaseLib/Serialization/deserializer.hpp>
 #include <BaseLib/Serialization/serializer.hpp>
 
+#include <bit>
+
+namespace {
+    /// Resolved identifiers are distinguished by their discriminators, which std::hash ignores.
+    std::uint64_t getHashIncludingDiscriminator(babelwires::LongId identifier) {
+        return babelwires::hash::mixtureOf(identifier, identifier.getDiscriminator());
+    }
+
+    bool isSameResolvedIdentifier(babelwires::LongId a, babelwires::LongId b) {
+        return (a == b) && (a.getDiscriminator() == b.getDiscriminator());
+    }
+
+    constexpr unsigned int c_log2MinNumSlots = 4;
+
+#ifndef NDEBUG
+    /// The number of ReadAccess objects in existence, so illegal swaps of the singleton can be caught.
+    std::atomic<int> g_numReadAccesses = 0;
+#endif
+} // namespace
+
 babelwires::IdentifierRegistry::IdentifierRegistry() = default;
-babelwires::IdentifierRegistry::IdentifierRegistry(IdentifierRegistry&&) = default;
-babelwires::IdentifierRegistry::~IdentifierRegistry() = default;
-babelwires::IdentifierRegistry& babelwires::IdentifierRegistry::operator=(IdentifierRegistry&&) = default;
+
+babelwires::IdentifierRegistry::IdentifierRegistry(IdentifierRegistry&& other)
+    : m_uuidToInstanceDataMap(std::move(other.m_uuidToInstanceDataMap))
+    , m_instanceDatasFromIdentifier(std::move(other.m_instanceDatasFromIdentifier))
+    , m_lookupTables(std::move(other.m_lookupTables))
+    , m_retiredInstanceDatas(std::move(other.m_retiredInstanceDatas))
+    , m_lookupTable(other.m_lookupTable.exchange(nullptr)) {}
+
+babelwires::IdentifierRegistry::~IdentifierRegistry() {
+    assert((s_singletonInstance.load(std::memory_order_acquire) != this) &&
+           "The singleton instance cannot be destroyed while it is in use");
+}
+
+babelwires::IdentifierRegistry& babelwires::IdentifierRegistry::operator=(IdentifierRegistry&& other) {
+    m_uuidToInstanceDataMap = std::move(other.m_uuidToInstanceDataMap);
+    m_instanceDatasFromIdentifier = std::move(other.m_instanceDatasFromIdentifier);
+    m_lookupTables = std::move(other.m_lookupTables);
+    m_retiredInstanceDatas = std::move(other.m_retiredInstanceDatas);
+    m_lookupTable = other.m_lookupTable.exchange(nullptr);
+    return *this;
+}
+
+babelwires::IdentifierRegistry::LookupTable::LookupTable(unsigned int log2NumSlots)
+    : m_slots(std::size_t(1) << log2NumSlots)
+    , m_shift(64 - log2NumSlots) {}
+
+std::size_t babelwires::IdentifierRegistry::LookupTable::getFirstSlot(LongId identifier) const {
+    // Fibonacci hashing, so the quality of the low bits of the hash does not matter.
+    return (getHashIncludingDiscriminator(identifier) * 0x9e3779b97f4a7c15ull) >> m_shift;
+}
+
+void babelwires::IdentifierRegistry::publishInstanceData(const InstanceData* instanceData) {
+    assert((instanceData->m_identifier.getDiscriminator() != 0) && "Only resolved identifiers can be published");
+    LookupTable* table = m_lookupTables.empty() ? nullptr : m_lookupTables.back().get();
+    // The map already contains the instanceData, so this keeps the table at most half full.
+    if (!table || (2 * m_uuidToInstanceDataMap.size() > table->m_slots.size())) {
+        const unsigned int log2NumSlots =
+            table ? std::countr_zero(table->m_slots.size()) + 1 : c_log2MinNumSlots;
+        auto newTable = std::make_unique<LookupTable>(log2NumSlots);
+        if (table) {
+            const std::size_t mask = newTable->m_slots.size() - 1;
+            for (const auto& slot : table->m_slots) {
+                if (const InstanceData* const data = slot.load(std::memory_order_relaxed)) {
+                    std::size_t i = newTable->getFirstSlot(data->m_identifier);
+                    while (newTable->m_slots[i].load(std::memory_order_relaxed)) {
+                        i = (i + 1) & mask;
+                    }
+                    newTable->m_slots[i].store(data, std::memory_order_relaxed);
+                }
+            }
+        }
+        table = newTable.get();
+        m_lookupTables.emplace_back(std::move(newTable));
+        m_lookupTable.store(table, std::memory_order_release);
+    }
+    const std::size_t mask = table->m_slots.size() - 1;
+    std::size_t i = table->getFirstSlot(instanceData->m_identifier);
+    while (const InstanceData* const data = table->m_slots[i].load(std::memory_order_relaxed)) {
+        if (isSameResolvedIdentifier(data->m_identifier, instanceData->m_identifier)) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    table->m_slots[i].store(instanceData, std::memory_order_release);
+}
+
+void babelwires::IdentifierRegistry::replaceInstanceData(std::unique_ptr<InstanceData>& instanceData,
+                                                         std::unique_ptr<InstanceData> replacement) {
+    Data& data = m_instanceDatasFromIdentifier[instanceData->m_identifier.withoutDiscriminator()];
+    const ShortId::Discriminator discriminator = instanceData->m_identifier.getDiscriminator();
+    assert((data.m_instanceDatas[discriminator - 1] == instanceData.get()) && "Inconsistent identifier data");
+    data.m_instanceDatas[discriminator - 1] = replacement.get();
+    publishInstanceData(replacement.get());
+    const InstanceData* const retired = instanceData.get();
+    m_retiredInstanceDatas.emplace_back(std::move(instanceData));
+    assert((m_retiredInstanceDatas.back().get() == retired) && "Replaced data must outlive concurrent readers");
+    instanceData = std::move(replacement);
+}
 
 babelwires::IdentifierRegistry::InstanceData::InstanceData()
     : m_identifier("Invald")
@@ -66,6 +162,7 @@ babelwires::LongId babelwires::IdentifierRegistry::addLongIdWithMetadata(babelwi
         data.m_instanceDatas.emplace_back(uit->second.get());
         identifier.setDiscriminator(newDiscriminator);
         uit->second->m_identifier = identifier;
+        publishInstanceData(uit->second.get());
     } else {
         InstanceData& instanceData = *it->second;
         if (authority != Authority::isAuthoritative) {
@@ -78,11 +175,16 @@ babelwires::LongId babelwires::IdentifierRegistry::addLongIdWithMetadata(babelwi
                      ((instanceData.m_identifier == identifier) && instanceData.m_fieldName == name))) &&
                    "Uuid is registered twice from code with inconsistent data");
             logDebug() << "Authoritatively updating Identifier " << identifier << " as \"" << name << "\"";
-            instanceData.m_fieldName = name;
-            instanceData.m_authority = authority;
             // TODO Warn when identifier has changed in a file, and we register subsequently.
             // Some kind of versioning will be required to support this.
             identifier = instanceData.m_identifier;
+            if (instanceData.m_fieldName != name) {
+                replaceInstanceData(it->second,
+                                    std::make_unique<InstanceData>(name, uuid, instanceData.m_identifier, authority));
+            } else {
+                // Readers never look at the authority.
+                instanceData.m_authority = authority;
+            }
         }
     }
 
@@ -103,15 +205,20 @@ babelwires::ShortId babelwires::IdentifierRegistry::addShortIdWithMetadata(babel
 
 const babelwires::IdentifierRegistry::InstanceData*
 babelwires::IdentifierRegistry::getInstanceData(LongId identifier) const {
-    const babelwires::ShortId::Discriminator index = identifier.getDiscriminator();
-    if (index > 0) {
-        const auto& it = m_instanceDatasFromIdentifier.find(identifier.withoutDiscriminator());
-        if (it != m_instanceDatasFromIdentifier.end()) {
-            const Data& data = it->second;
-            if (index <= data.m_instanceDatas.size()) {
-                return data.m_instanceDatas[index - 1];
-            }
+    if (identifier.getDiscriminator() == 0) {
+        return nullptr;
+    }
+    const LookupTable* const table = m_lookupTable.load(std::memory_order_acquire);
+    if (!table) {
+        return nullptr;
+    }
+    const std::size_t mask = table->m_slots.size() - 1;
+    std::size_t i = table->getFirstSlot(identifier);
+    while (const InstanceData* const data = table->m_slots[i].load(std::memory_order_acquire)) {
+        if (isSameResolvedIdentifier(data->m_identifier, identifier)) {
+            return data;
         }
+        i = (i + 1) & mask;
     }
     return nullptr;
 }
@@ -134,25 +241,26 @@ std::string babelwires::IdentifierRegistry::getName(LongId identifier) const {
 }
 
 std::shared_mutex babelwires::IdentifierRegistry::s_mutex;
-babelwires::IdentifierRegistry* babelwires::IdentifierRegistry::s_singletonInstance;
+std::atomic<babelwires::IdentifierRegistry*> babelwires::IdentifierRegistry::s_singletonInstance = nullptr;
 
-babelwires::IdentifierRegistry::ReadAccess::ReadAccess(std::shared_mutex* mutex, const IdentifierRegistry* registry)
-    : m_mutex(mutex)
-    , m_registry(registry) {
-    m_mutex->lock_shared();
+babelwires::IdentifierRegistry::ReadAccess::ReadAccess(const IdentifierRegistry* registry)
+    : m_registry(registry) {
+#ifndef NDEBUG
+    ++g_numReadAccesses;
+#endif
 }
 
-babelwires::IdentifierRegistry::ReadAccess::ReadAccess(ReadAccess&& other)
-    : m_mutex(other.m_mutex)
-    , m_registry(other.m_registry) {
-    other.m_mutex = nullptr;
-    other.m_registry = nullptr;
+babelwires::IdentifierRegistry::ReadAccess::ReadAccess(const ReadAccess& other)
+    : m_registry(other.m_registry) {
+#ifndef NDEBUG
+    ++g_numReadAccesses;
+#endif
 }
 
 babelwires::IdentifierRegistry::ReadAccess::~ReadAccess() {
-    if (m_mutex) {
-        m_mutex->unlock_shared();
-    }
+#ifndef NDEBUG
+    --g_numReadAccesses;
+#endif
 }
 
 babelwires::IdentifierRegistry::WriteAccess::WriteAccess(std::shared_mutex* mutex, IdentifierRegistry* registry)
@@ -176,33 +284,38 @@ babelwires::IdentifierRegistry::WriteAccess::~WriteAccess() {
 
 babelwires::IdentifierRegistry* babelwires::IdentifierRegistry::swapInstance(babelwires::IdentifierRegistry* reg) {
     std::lock_guard guard(s_mutex);
-    babelwires::IdentifierRegistry* old = s_singletonInstance;
-    s_singletonInstance = reg;
-    return old;
+    assert((g_numReadAccesses == 0) && "The singleton instance cannot be swapped while reads are in flight");
+    return s_singletonInstance.exchange(reg, std::memory_order_acq_rel);
 }
 
 babelwires::IdentifierRegistry::const_iterator babelwires::IdentifierRegistry::begin() const {
-    return const_iterator(m_uuidToInstanceDataMap.begin());
+    return const_iterator(m_lookupTable.load(std::memory_order_acquire));
 }
 
 babelwires::IdentifierRegistry::const_iterator babelwires::IdentifierRegistry::end() const {
-    return const_iterator(m_uuidToInstanceDataMap.end());
+    return const_iterator(nullptr);
 }
 
 babelwires::IdentifierRegistry::ReadAccess babelwires::IdentifierRegistry::read() {
-    assert(s_singletonInstance && "No IdentifierRegistry instance is currently set as the singleton instance");
-    return ReadAccess(&s_mutex, s_singletonInstance);
+    const IdentifierRegistry* const instance = s_singletonInstance.load(std::memory_order_acquire);
+    assert(instance && "No IdentifierRegistry instance is currently set as the singleton instance");
+    return ReadAccess(instance);
 }
 
 babelwires::IdentifierRegistry::WriteAccess babelwires::IdentifierRegistry::write() {
-    assert(s_singletonInstance && "No IdentifierRegistry instance is currently set as the singleton instance");
-    return WriteAccess(&s_mutex, s_singletonInstance);
+    IdentifierRegistry* const instance = s_singletonInstance.load(std::memory_order_acquire);
+    assert(instance && "No IdentifierRegistry instance is currently set as the singleton instance");
+    return WriteAccess(&s_mutex, instance);
 }
 
 void babelwires::IdentifierRegistry::serializeContents(Serializer& serializer) const {
     std::vector<const InstanceData*> contents;
-    for (const auto& [_, v] : m_uuidToInstanceDataMap) {
-        contents.emplace_back(v.get());
+    if (const LookupTable* const table = m_lookupTable.load(std::memory_order_acquire)) {
+        for (const auto& slot : table->m_slots) {
+            if (const InstanceData* const data = slot.load(std::memory_order_acquire)) {
+                contents.emplace_back(data);
+            }
+        }
     }
     if (contents.empty()) {
         return;
@@ -250,6 +363,7 @@ babelwires::Result babelwires::IdentifierRegistry::deserializeContents(Deseriali
                            << "\"";
         }
         data.m_instanceDatas[discriminator - 1] = uit->second.get();
+        publishInstanceData(uit->second.get());
         DO_OR_ERROR(it.advance());
     }
     return {};
@@ -262,7 +376,24 @@ babelwires::IdentifierRegistryScope::~IdentifierRegistryScope() {
     babelwires::IdentifierRegistry::swapInstance(m_previousInstance);
 }
 
+void babelwires::IdentifierRegistry::const_iterator::skipEmptySlots() {
+    if (!m_table) {
+        return;
+    }
+    while (m_index < m_table->m_slots.size()) {
+        m_instanceData = m_table->m_slots[m_index].load(std::memory_order_acquire);
+        if (m_instanceData) {
+            return;
+        }
+        ++m_index;
+    }
+    // The end.
+    m_table = nullptr;
+    m_index = 0;
+    m_instanceData = nullptr;
+}
+
 babelwires::IdentifierRegistry::const_iterator::ValueType
 babelwires::IdentifierRegistry::const_iterator::operator*() const {
-    return {m_it->second->m_identifier, &m_it->second->m_fieldName, &m_it->second->m_uuid};
+    return {m_instanceData->m_identifier, &m_instanceData->m_fieldName, &m_instanceData->m_uuid};
 }
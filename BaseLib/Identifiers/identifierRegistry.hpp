@@ -14,11 +14,13 @@
 #include <BaseLib/Serialization/serializable.hpp>
 #include <BaseLib/uuid.hpp>
 
+#include <atomic>
 #include <memory>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace babelwires {
 
@@ -27,6 +29,9 @@ namespace babelwires {
     /// Singletons are usually a mistake and for the most part, "dependency injection" has been used to provide
     /// the project with its dependencies. However, passing the registry through to every use of Path was
     /// just too painful, so a singleton was adopted in this case.
+    ///
+    /// Reading is lock-free, since names are looked up from many threads on hot paths. Writers are serialized by
+    /// WriteAccess, and never modify or free data that a concurrent reader could be using.
     class BASELIB_API IdentifierRegistry : public Serializable {
       public:
         SERIALIZABLE(IdentifierRegistry, "identifierMetadata", void, 1);
@@ -87,11 +92,13 @@ namespace babelwires {
         // Singleton stuff:
 
         /// Access the contents of the singleton instance within the scope of this object.
-        /// This holds a lock, so ensure its lifetime is minimal.
+        /// This does not take a lock, so it can run concurrently with writes. Data obtained through it reflects the
+        /// registry at some point during the read. It remains valid until the registry is destroyed, since
+        /// writers retire data rather than freeing it.
         class BASELIB_API ReadAccess {
           public:
-            ReadAccess(std::shared_mutex* mutex, const IdentifierRegistry* registry);
-            ReadAccess(ReadAccess&& other);
+            ReadAccess(const IdentifierRegistry* registry);
+            ReadAccess(const ReadAccess& other);
             ~ReadAccess();
             const IdentifierRegistry* operator->() const { return m_registry; }
             // TODO Would prefer to avoid this, since it allows callers to keep the reference.
@@ -99,7 +106,6 @@ namespace babelwires {
             const IdentifierRegistry& operator*() const { return *m_registry; }
 
           private:
-            std::shared_mutex* m_mutex;
             const IdentifierRegistry* m_registry;
         };
 
@@ -118,6 +124,9 @@ namespace babelwires {
         };
 
         /// Swap the singleton instance with the provided object.
+        /// Since readers do not take a lock, this is only legal when no reads are in flight: The data of the old
+        /// instance must remain alive while anything obtained through a ReadAccess is in use.
+        /// In debug builds, this asserts that no ReadAccess exists.
         static IdentifierRegistry* swapInstance(IdentifierRegistry* reg);
 
         /// Gain read access to the registry.
@@ -147,13 +156,35 @@ namespace babelwires {
             Authority m_authority;
         };
 
-        ///
+        /// Lock-free.
         const InstanceData* getInstanceData(LongId identifier) const;
 
       private:
         friend const_iterator;
 
+        /// An open-addressing hash table from resolved identifiers to their instance data, which can be read without
+        /// a lock. A writer only ever fills an empty slot, or points a slot at a replacement for the same identifier.
+        /// The table is never more than half full, so probing always terminates.
+        struct LookupTable {
+            explicit LookupTable(unsigned int log2NumSlots);
+
+            /// The slot at which probing for the identifier starts.
+            std::size_t getFirstSlot(LongId identifier) const;
+
+            std::vector<std::atomic<const InstanceData*>> m_slots;
+            unsigned int m_shift;
+        };
+
+        /// Make the instanceData findable by readers, replacing any existing data for the same identifier.
+        /// The instanceData must not be modified afterwards.
+        void publishInstanceData(const InstanceData* instanceData);
+
+        /// Replace the InstanceData by a modified copy, so readers of the original are not affected.
+        /// The original is retired, so it stays alive until the registry is destroyed.
+        void replaceInstanceData(std::unique_ptr<InstanceData>& instanceData, std::unique_ptr<InstanceData> replacement);
+
         /// Look up the instance data associated with a uuid.
+        /// Only used by writers.
         std::unordered_map<Uuid, std::unique_ptr<InstanceData>> m_uuidToInstanceDataMap;
 
         struct Data {
@@ -161,13 +192,22 @@ namespace babelwires {
         };
 
         /// For each identifier, we can index associated data.
+        /// Only used by writers.
         std::unordered_map<LongId, Data> m_instanceDatasFromIdentifier;
 
+        /// The current table is the last. Earlier tables, and InstanceData which has been replaced, may still be in
+        /// use by readers, so they are retired rather than deleted.
+        std::vector<std::unique_ptr<LookupTable>> m_lookupTables;
+        std::vector<std::unique_ptr<InstanceData>> m_retiredInstanceDatas;
+
+        /// The table readers use.
+        std::atomic<const LookupTable*> m_lookupTable = nullptr;
+
       private:
         /// Lifetime of this is managed externally.
-        static IdentifierRegistry* s_singletonInstance;
+        static std::atomic<IdentifierRegistry*> s_singletonInstance;
 
-        /// A mutex that controls access to the singleton's contents.
+        /// A mutex which serializes writes to the singleton's contents.
         static std::shared_mutex s_mutex;
     };
 
@@ -184,24 +224,35 @@ namespace babelwires {
 
 } // namespace babelwires
 
+/// Iterates over the table which was current when iteration began, so it is safe to use concurrently with writes.
 class BASELIB_API babelwires::IdentifierRegistry::const_iterator {
   public:
-    using InnerIterator = decltype(babelwires::IdentifierRegistry::m_uuidToInstanceDataMap)::const_iterator;
     using ValueType = IdentifierRegistry::ValueType;
 
-    const_iterator(InnerIterator it)
-        : m_it(it) {}
+    /// A null table means the end.
+    const_iterator(const LookupTable* table)
+        : m_table(table) {
+        skipEmptySlots();
+    }
 
     ValueType operator*() const;
 
-    bool operator==(const const_iterator& other) const { return m_it == other.m_it; }
-    bool operator!=(const const_iterator& other) const { return m_it != other.m_it; }
+    bool operator==(const const_iterator& other) const {
+        return (m_table == other.m_table) && (m_index == other.m_index);
+    }
+    bool operator!=(const const_iterator& other) const { return !(*this == other); }
 
     const_iterator& operator++() {
-        ++m_it;
+        ++m_index;
+        skipEmptySlots();
         return *this;
     }
 
   private:
-    InnerIterator m_it;
+    void skipEmptySlots();
+
+  private:
+    const LookupTable* m_table;
+    std::size_t m_index = 0;
+    const InstanceData* m_instanceData = nullptr;
 };
@@ -7,6 +7,9 @@
  **/
 #pragma once
 
+#include <limits>
+#include <type_traits>
+
 namespace babelwires {
 
     template <typename T> T gcd(T a, T b) {
@@ -23,4 +26,33 @@ namespace babelwires {
         return temp ? (a / temp * b) : 0;
     }
 
+    /// Set result to a + b and return true, or return false if the result would overflow.
+    template <typename T> bool addWithoutOverflow(T a, T b, T& result) {
+        static_assert(std::is_signed_v<T>);
+        if (((b > 0) && (a > std::numeric_limits<T>::max() - b)) ||
+            ((b < 0) && (a < std::numeric_limits<T>::min() - b))) {
+            return false;
+        }
+        result = a + b;
+        return true;
+    }
+
+    /// Set result to a * b and return true, or return false if the result would overflow.
+    template <typename T> bool multiplyWithoutOverflow(T a, T b, T& result) {
+        static_assert(std::is_signed_v<T>);
+        if (a > 0) {
+            if (((b > 0) && (a > std::numeric_limits<T>::max() / b)) ||
+                ((b <= 0) && (b < std::numeric_limits<T>::min() / a))) {
+                return false;
+            }
+        } else if (a < 0) {
+            if (((b > 0) && (a < std::numeric_limits<T>::min() / b)) ||
+                ((b < 0) && (a < std::numeric_limits<T>::max() / b))) {
+                return false;
+            }
+        }
+        result = a * b;
+        return true;
+    }
+
 } // namespace babelwires
\ No newline at end of file
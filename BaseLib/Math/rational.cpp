@@ -19,7 +19,7 @@ void babelwires::Rational::setComponents(BigType numerator, BigType denominator)
     
     // Handle sign
     BigType sign = 1;
-    if ((numerator * denominator) < 0) {
+    if ((numerator < 0) != (denominator < 0)) {
         sign = -1;
     }
     numerator = (numerator < 0) ? -numerator : numerator;
@@ -113,6 +113,11 @@ babelwires::Rational babelwires::Rational::operator/(const Rational& other) cons
 }
 
 babelwires::Rational& babelwires::Rational::operator+=(const Rational& other) {
+    if (m_denominator == other.m_denominator) {
+        // Fast path: The numerators can be added directly.
+        setComponents(static_cast<BigType>(m_numerator) + other.m_numerator, m_denominator);
+        return *this;
+    }
     BigType numerator = (static_cast<BigType>(m_numerator) * other.m_denominator) + (static_cast<BigType>(m_denominator) * other.m_numerator);
     BigType denominator = static_cast<BigType>(m_denominator) * other.m_denominator;
     setComponents(numerator, denominator);
@@ -72,6 +72,8 @@ namespace babelwires {
         std::tuple<int, Rational> divmod(Rational x) const;
 
       private:
+        friend class Rational64;
+
         using BigType = std::int64_t;
         void setComponents(BigType numerator, BigType denominator);
 
@@ -0,0 +1,383 @@
+/**
+ * Rational64 is a rational number with 64-bit components, for values which would overflow Rational.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <BaseLib/Math/rational64.hpp>
+
+#include <BaseLib/Hash/hash.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+    using ComponentType = babelwires::Rational64::ComponentType;
+
+    constexpr ComponentType c_maxComponent = std::numeric_limits<ComponentType>::max();
+
+    /// Returns the largest q such that q * d <= n. d must be positive.
+    ComponentType floorDivide(ComponentType n, ComponentType d) {
+        const ComponentType q = n / d;
+        return ((n % d) < 0) ? q - 1 : q;
+    }
+
+    /// Returns n - (floorDivide(n, d) * d), computed without the multiplication, which can overflow.
+    ComponentType floorRemainder(ComponentType n, ComponentType d) {
+        const ComponentType r = n % d;
+        return (r < 0) ? r + d : r;
+    }
+
+    /// Exact comparison of an/ad < bn/bd, which cannot overflow. Denominators must be positive.
+    /// The fractional parts are compared by comparing their reciprocals, as in a continued fraction expansion.
+    bool isLessThan(ComponentType an, ComponentType ad, ComponentType bn, ComponentType bd) {
+        while (true) {
+            const ComponentType qa = floorDivide(an, ad);
+            const ComponentType qb = floorDivide(bn, bd);
+            if (qa != qb) {
+                return qa < qb;
+            }
+            const ComponentType ra = floorRemainder(an, ad);
+            const ComponentType rb = floorRemainder(bn, bd);
+            if ((ra == 0) || (rb == 0)) {
+                return (ra == 0) && (rb != 0);
+            }
+            // ra/ad < rb/bd iff bd/rb < ad/ra
+            an = bd;
+            bn = ad;
+            ad = rb;
+            bd = ra;
+        }
+    }
+
+    /// Returns the least common multiple of the denominators of start and the values, or 0 if it would overflow.
+    ComponentType getCommonDenominator(const babelwires::Rational64& start,
+                                       std::span<const babelwires::Rational> values) {
+        ComponentType commonDenominator = start.getDenominator();
+        for (const babelwires::Rational& value : values) {
+            const ComponentType denominator = value.getDenominator();
+            // Usually the common denominator is already a multiple, so the gcd can be skipped.
+            if ((commonDenominator % denominator) != 0) {
+                const ComponentType g = babelwires::gcd(commonDenominator, denominator);
+                if (!babelwires::multiplyWithoutOverflow(commonDenominator, denominator / g, commonDenominator)) {
+                    return 0;
+                }
+            }
+        }
+        return commonDenominator;
+    }
+
+    /// Accumulates a sum without reducing to lowest terms after every step.
+    /// While the denominator of the next value divides the current denominator, adding is just a multiply-add.
+    class Accumulator {
+      public:
+        explicit Accumulator(const babelwires::Rational64& start)
+            : m_numerator(start.getNumerator())
+            , m_denominator(start.getDenominator()) {}
+
+        void add(ComponentType numerator, ComponentType denominator) {
+            if (!tryAdd(numerator, denominator)) {
+                // Reducing may make room.
+                reduce();
+                if (!tryAdd(numerator, denominator)) {
+                    const babelwires::Rational64 result = get() + babelwires::Rational64(numerator, denominator);
+                    m_numerator = result.getNumerator();
+                    m_denominator = result.getDenominator();
+                }
+            }
+        }
+
+        babelwires::Rational64 get() const { return babelwires::Rational64(m_numerator, m_denominator); }
+
+      private:
+        bool tryAdd(ComponentType numerator, ComponentType denominator) {
+            if ((m_denominator % denominator) == 0) {
+                ComponentType scaledNumerator;
+                return babelwires::multiplyWithoutOverflow(numerator, m_denominator / denominator, scaledNumerator) &&
+                       babelwires::addWithoutOverflow(m_numerator, scaledNumerator, m_numerator);
+            }
+            const ComponentType g = babelwires::gcd(m_denominator, denominator);
+            ComponentType newDenominator;
+            ComponentType thisNumerator;
+            ComponentType otherNumerator;
+            ComponentType newNumerator;
+            if (babelwires::multiplyWithoutOverflow(m_denominator, denominator / g, newDenominator) &&
+                babelwires::multiplyWithoutOverflow(m_numerator, denominator / g, thisNumerator) &&
+                babelwires::multiplyWithoutOverflow(numerator, m_denominator / g, otherNumerator) &&
+                babelwires::addWithoutOverflow(thisNumerator, otherNumerator, newNumerator)) {
+                m_numerator = newNumerator;
+                m_denominator = newDenominator;
+                return true;
+            }
+            return false;
+        }
+
+        void reduce() {
+            const babelwires::Rational64 reduced = get();
+            m_numerator = reduced.getNumerator();
+            m_denominator = reduced.getDenominator();
+        }
+
+      private:
+        ComponentType m_numerator;
+        ComponentType m_denominator;
+    };
+} // namespace
+
+babelwires::Rational64::Rational64(ComponentType numerator, ComponentType denominator) {
+    assert(denominator != 0);
+    if (!trySetComponents(numerator, denominator)) {
+        *this = approximate(static_cast<long double>(numerator) / static_cast<long double>(denominator));
+    }
+}
+
+babelwires::Rational64::Rational64(const Rational& rational)
+    : m_numerator(rational.getNumerator())
+    , m_denominator(rational.getDenominator()) {}
+
+bool babelwires::Rational64::trySetComponents(ComponentType numerator, ComponentType denominator) {
+    assert(denominator != 0);
+    // Excluding the minimum value means components can always be negated.
+    constexpr ComponentType minComponent = std::numeric_limits<ComponentType>::min();
+    if ((numerator == minComponent) || (denominator == minComponent)) {
+        return false;
+    }
+    if (denominator < 0) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    if (numerator == 0) {
+        m_numerator = 0;
+        m_denominator = 1;
+        return true;
+    }
+    const ComponentType g = gcd((numerator < 0) ? -numerator : numerator, denominator);
+    m_numerator = numerator / g;
+    m_denominator = denominator / g;
+    return true;
+}
+
+babelwires::Rational64 babelwires::Rational64::approximate(long double value) {
+    const bool isNegative = (value < 0);
+    long double remaining = isNegative ? -value : value;
+    if (!(remaining < static_cast<long double>(c_maxComponent))) {
+        return isNegative ? -c_maxComponent : c_maxComponent;
+    }
+    // Continued fraction convergents, stopping before a component would overflow.
+    ComponentType p0 = 0, q0 = 1;
+    ComponentType p1 = 1, q1 = 0;
+    // A long double cannot support more terms than this.
+    for (int i = 0; i < 128; ++i) {
+        const long double a = std::floor(remaining);
+        if (!(a < static_cast<long double>(c_maxComponent))) {
+            break;
+        }
+        const ComponentType integerPart = static_cast<ComponentType>(a);
+        ComponentType p, q;
+        if (!multiplyWithoutOverflow(integerPart, p1, p) || !addWithoutOverflow(p, p0, p) ||
+            !multiplyWithoutOverflow(integerPart, q1, q) || !addWithoutOverflow(q, q0, q)) {
+            break;
+        }
+        p0 = p1;
+        q0 = q1;
+        p1 = p;
+        q1 = q;
+        const long double fractionalPart = remaining - a;
+        if (fractionalPart <= 0) {
+            break;
+        }
+        remaining = 1 / fractionalPart;
+    }
+    Rational64 result;
+    result.trySetComponents(isNegative ? -p1 : p1, q1);
+    return result;
+}
+
+babelwires::Rational babelwires::Rational64::toRational() const {
+    Rational result;
+    result.setComponents(m_numerator, m_denominator);
+    return result;
+}
+
+babelwires::Rational64 babelwires::Rational64::operator*(const Rational64& other) const {
+    // Cancelling first keeps the intermediates small, and means the result is already in lowest terms.
+    const ComponentType g1 = gcd((m_numerator < 0) ? -m_numerator : m_numerator, other.m_denominator);
+    const ComponentType g2 = gcd((other.m_numerator < 0) ? -other.m_numerator : other.m_numerator, m_denominator);
+    ComponentType numerator;
+    ComponentType denominator;
+    Rational64 result;
+    if (multiplyWithoutOverflow(m_numerator / g1, other.m_numerator / g2, numerator) &&
+        multiplyWithoutOverflow(m_denominator / g2, other.m_denominator / g1, denominator) &&
+        result.trySetComponents(numerator, denominator)) {
+        return result;
+    }
+    return approximate((static_cast<long double>(m_numerator) / m_denominator) *
+                       (static_cast<long double>(other.m_numerator) / other.m_denominator));
+}
+
+babelwires::Rational64 babelwires::Rational64::operator/(const Rational64& other) const {
+    assert((other.m_numerator != 0) && "Division by zero");
+    Rational64 reciprocal;
+    reciprocal.m_numerator = (other.m_numerator < 0) ? -other.m_denominator : other.m_denominator;
+    reciprocal.m_denominator = (other.m_numerator < 0) ? -other.m_numerator : other.m_numerator;
+    return *this * reciprocal;
+}
+
+babelwires::Rational64& babelwires::Rational64::operator+=(const Rational64& other) {
+    if (m_denominator == other.m_denominator) {
+        // Fast path: The numerators can be added directly.
+        ComponentType numerator;
+        if (addWithoutOverflow(m_numerator, other.m_numerator, numerator) &&
+            trySetComponents(numerator, m_denominator)) {
+            return *this;
+        }
+    } else {
+        const ComponentType g = gcd(m_denominator, other.m_denominator);
+        ComponentType thisNumerator;
+        ComponentType otherNumerator;
+        ComponentType numerator;
+        ComponentType denominator;
+        if (multiplyWithoutOverflow(m_numerator, other.m_denominator / g, thisNumerator) &&
+            multiplyWithoutOverflow(other.m_numerator, m_denominator / g, otherNumerator) &&
+            addWithoutOverflow(thisNumerator, otherNumerator, numerator) &&
+            multiplyWithoutOverflow(m_denominator, other.m_denominator / g, denominator) &&
+            trySetComponents(numerator, denominator)) {
+            return *this;
+        }
+    }
+    *this = approximate((static_cast<long double>(m_numerator) / m_denominator) +
+                        (static_cast<long double>(other.m_numerator) / other.m_denominator));
+    return *this;
+}
+
+babelwires::Rational64 babelwires::Rational64::operator+(const Rational64& other) const {
+    Rational64 tmp = *this;
+    tmp += other;
+    return tmp;
+}
+
+babelwires::Rational64 babelwires::Rational64::operator-() const {
+    Rational64 result;
+    result.m_numerator = -m_numerator;
+    result.m_denominator = m_denominator;
+    return result;
+}
+
+babelwires::Rational64& babelwires::Rational64::operator-=(const Rational64& other) {
+    *this += -other;
+    return *this;
+}
+
+babelwires::Rational64 babelwires::Rational64::operator-(const Rational64& other) const {
+    Rational64 tmp = *this;
+    tmp -= other;
+    return tmp;
+}
+
+bool babelwires::Rational64::operator==(const Rational64& other) const {
+    return (other.m_numerator == m_numerator) && (other.m_denominator == m_denominator);
+}
+
+bool babelwires::Rational64::operator!=(const Rational64& other) const {
+    return !(*this == other);
+}
+
+bool babelwires::Rational64::operator<(const Rational64& other) const {
+    if (m_denominator == other.m_denominator) {
+        return m_numerator < other.m_numerator;
+    }
+    ComponentType lhs;
+    ComponentType rhs;
+    if (multiplyWithoutOverflow(m_numerator, other.m_denominator, lhs) &&
+        multiplyWithoutOverflow(other.m_numerator, m_denominator, rhs)) {
+        return lhs < rhs;
+    }
+    return isLessThan(m_numerator, m_denominator, other.m_numerator, other.m_denominator);
+}
+
+bool babelwires::Rational64::operator>(const Rational64& other) const {
+    return other < *this;
+}
+
+bool babelwires::Rational64::operator<=(const Rational64& other) const {
+    return !(other < *this);
+}
+
+bool babelwires::Rational64::operator>=(const Rational64& other) const {
+    return !(*this < other);
+}
+
+std::string babelwires::Rational64::toString() const {
+    std::ostringstream result;
+    if (m_denominator == 1) {
+        result << m_numerator;
+    } else if (std::abs(m_numerator) < m_denominator) {
+        result << m_numerator << "/" << m_denominator;
+    } else {
+        result << (m_numerator / m_denominator) << " " << (std::abs(m_numerator) % m_denominator) << "/"
+               << m_denominator;
+    }
+    return result.str();
+}
+
+std::ostream& babelwires::operator<<(std::ostream& os, const babelwires::Rational64& r) {
+    return os << r.toString();
+}
+
+std::size_t babelwires::Rational64::getHash() const {
+    return hash::mixtureOf(m_numerator, m_denominator);
+}
+
+babelwires::Rational64 babelwires::rationalBatch::sum(std::span<const Rational> values) {
+    Accumulator accumulator(0);
+    for (const Rational& value : values) {
+        accumulator.add(value.getNumerator(), value.getDenominator());
+    }
+    return accumulator.get();
+}
+
+void babelwires::rationalBatch::exclusivePrefixSum(std::span<const Rational> values, std::span<Rational64> out,
+                                                   Rational64 start) {
+    assert((values.size() == out.size()) && "The input and output must have the same size");
+    std::size_t i = 0;
+    // Accumulate the numerators over a common denominator, so each step is just a multiply-add and each output
+    // is reduced once.
+    if (const ComponentType commonDenominator = getCommonDenominator(start, values)) {
+        ComponentType numerator;
+        if (multiplyWithoutOverflow(start.getNumerator(), commonDenominator / start.getDenominator(), numerator)) {
+            for (; i < values.size(); ++i) {
+                out[i] = Rational64(numerator, commonDenominator);
+                ComponentType scaledNumerator;
+                if (!multiplyWithoutOverflow(static_cast<ComponentType>(values[i].getNumerator()),
+                                             commonDenominator / values[i].getDenominator(), scaledNumerator) ||
+                    !addWithoutOverflow(numerator, scaledNumerator, numerator)) {
+                    break;
+                }
+            }
+            if (i == values.size()) {
+                return;
+            }
+            // The sum has outgrown the common denominator, so continue from the last exact value.
+            start = out[i];
+        }
+    }
+    Accumulator accumulator(start);
+    for (; i < values.size(); ++i) {
+        out[i] = accumulator.get();
+        accumulator.add(values[i].getNumerator(), values[i].getDenominator());
+    }
+}
+
+void babelwires::rationalBatch::scale(std::span<const Rational> values, Rational factor, std::span<Rational> out) {
+    assert((values.size() == out.size()) && "The input and output must have the same size");
+    if (factor == Rational(1)) {
+        std::copy(values.begin(), values.end(), out.begin());
+        return;
+    }
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        out[i] = values[i] * factor;
+    }
+}
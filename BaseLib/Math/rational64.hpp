@@ -0,0 +1,109 @@
+/**
+ * Rational64 is a rational number with 64-bit components, for values which would overflow Rational.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BaseLib/baseLibExport.hpp>
+
+#include <BaseLib/Math/rational.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+
+namespace babelwires {
+
+    /// A rational number with 64-bit components.
+    /// This is intended for accumulations, such as the times of events along a long timeline, which can overflow
+    /// the 32-bit components of Rational.
+    /// Intermediate results are overflow-checked, so results are exact whenever they are representable.
+    class BASELIB_API Rational64 {
+      public:
+        using ComponentType = std::int64_t;
+
+        /// The minimum value of ComponentType is not supported, since it cannot be negated.
+        constexpr Rational64(ComponentType numerator = 0)
+            : m_numerator(numerator)
+            , m_denominator(1) {
+            assert((numerator != std::numeric_limits<ComponentType>::min()) && "Numerator cannot be negated");
+        }
+        Rational64(ComponentType numerator, ComponentType denominator);
+
+        /// Every Rational is exactly representable.
+        Rational64(const Rational& rational);
+
+        ComponentType getNumerator() const { return m_numerator; }
+        ComponentType getDenominator() const { return m_denominator; }
+
+        /// Convert to a Rational. This approximates if the result is not representable.
+        Rational toRational() const;
+
+        /// These approximate if the result is not representable.
+        Rational64 operator*(const Rational64& other) const;
+        Rational64 operator/(const Rational64& other) const;
+        Rational64 operator+(const Rational64& other) const;
+        Rational64 operator-(const Rational64& other) const;
+        Rational64& operator+=(const Rational64& other);
+        Rational64& operator-=(const Rational64& other);
+
+        Rational64 operator-() const;
+
+        /// Comparisons are always exact.
+        bool operator<=(const Rational64& other) const;
+        bool operator<(const Rational64& other) const;
+        bool operator>=(const Rational64& other) const;
+        bool operator>(const Rational64& other) const;
+        bool operator==(const Rational64& other) const;
+        bool operator!=(const Rational64& other) const;
+
+        /// A printable string, in the same format as Rational::toString.
+        std::string toString() const;
+
+        /// Get a hash value for the rational.
+        std::size_t getHash() const;
+
+      private:
+        /// The denominator must be non-zero. The components need not be in lowest terms.
+        /// Returns false if the components cannot be normalized without overflow.
+        bool trySetComponents(ComponentType numerator, ComponentType denominator);
+
+        /// Used when an exact result would overflow.
+        static Rational64 approximate(long double value);
+
+      private:
+        ComponentType m_numerator;
+        ComponentType m_denominator;
+    };
+
+    /// n/d
+    BASELIB_API std::ostream& operator<<(std::ostream& os, const babelwires::Rational64& r);
+
+    /// Batch kernels for the hot arithmetic loops of processors which handle many events.
+    /// These avoid normalizing after every step when the denominators of the values are compatible, as they
+    /// usually are for musical durations.
+    namespace rationalBatch {
+        /// The sum of the values.
+        BASELIB_API Rational64 sum(std::span<const Rational> values);
+
+        /// Set each element of out to start plus the sum of the values before the corresponding element of values.
+        /// For example, if values are the durations of consecutive events, out receives their start times.
+        BASELIB_API void exclusivePrefixSum(std::span<const Rational> values, std::span<Rational64> out,
+                                            Rational64 start = 0);
+
+        /// Set each element of out to the corresponding element of values multiplied by factor.
+        BASELIB_API void scale(std::span<const Rational> values, Rational factor, std::span<Rational> out);
+    } // namespace rationalBatch
+
+} // namespace babelwires
+
+namespace std {
+    template <> struct hash<babelwires::Rational64> {
+        inline std::size_t operator()(const babelwires::Rational64& rat) const { return rat.getHash(); }
+    };
+} // namespace std
@@ -0,0 +1,126 @@
+/**
+ * A pool of worker threads which can be shared by the parts of the system which do work in parallel.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <BaseLib/Threading/threadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
+
+struct babelwires::ThreadPool::Job {
+    Job(std::size_t numIndices, const std::function<void(std::size_t)>& function)
+        : m_numIndices(numIndices)
+        , m_function(function) {}
+
+    const std::size_t m_numIndices;
+    const std::function<void(std::size_t)>& m_function;
+    std::atomic<std::size_t> m_nextIndex = 0;
+    std::atomic<std::size_t> m_numFinished = 0;
+
+    /// Guards m_exception and is used to signal completion.
+    std::mutex m_mutex;
+    std::condition_variable m_isFinished;
+    std::exception_ptr m_exception;
+};
+
+babelwires::ThreadPool::ThreadPool(unsigned int numWorkers) {
+    m_workers.reserve(numWorkers);
+    for (unsigned int i = 0; i < numWorkers; ++i) {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+babelwires::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_jobAvailable.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+unsigned int babelwires::ThreadPool::getDefaultNumWorkers() {
+    const unsigned int hardwareConcurrency = std::thread::hardware_concurrency();
+    return (hardwareConcurrency > 1) ? hardwareConcurrency - 1 : 0;
+}
+
+void babelwires::ThreadPool::parallelFor(std::size_t numIndices,
+                                         const std::function<void(std::size_t)>& function) const {
+    if ((numIndices <= 1) || m_workers.empty()) {
+        for (std::size_t i = 0; i < numIndices; ++i) {
+            function(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>(numIndices, function);
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.emplace_back(job);
+    }
+    m_jobAvailable.notify_all();
+
+    runIndices(*job);
+    removeJob(job);
+
+    // Wait for the indices claimed by workers.
+    {
+        std::unique_lock lock(job->m_mutex);
+        job->m_isFinished.wait(lock, [&job]() { return job->m_numFinished == job->m_numIndices; });
+    }
+    if (job->m_exception) {
+        std::rethrow_exception(job->m_exception);
+    }
+}
+
+void babelwires::ThreadPool::runIndices(Job& job) {
+    std::size_t index;
+    while ((index = job.m_nextIndex.fetch_add(1)) < job.m_numIndices) {
+        try {
+            job.m_function(index);
+        } catch (...) {
+            std::lock_guard lock(job.m_mutex);
+            if (!job.m_exception) {
+                job.m_exception = std::current_exception();
+            }
+        }
+        if (job.m_numFinished.fetch_add(1) + 1 == job.m_numIndices) {
+            // Take the lock so the notification cannot be missed by a caller about to wait.
+            std::lock_guard lock(job.m_mutex);
+            job.m_isFinished.notify_all();
+        }
+    }
+}
+
+void babelwires::ThreadPool::removeJob(const std::shared_ptr<Job>& job) const {
+    std::lock_guard lock(m_mutex);
+    const auto it = std::find(m_jobs.begin(), m_jobs.end(), job);
+    if (it != m_jobs.end()) {
+        m_jobs.erase(it);
+    }
+}
+
+void babelwires::ThreadPool::workerLoop() const {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_jobAvailable.wait(lock, [this]() { return m_isStopping || !m_jobs.empty(); });
+            if (m_jobs.empty()) {
+                assert(m_isStopping);
+                return;
+            }
+            job = m_jobs.back();
+        }
+        runIndices(*job);
+        // The job has no unclaimed indices left.
+        removeJob(job);
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * A pool of worker threads which can be shared by the parts of the system which do work in parallel.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BaseLib/baseLibExport.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace babelwires {
+
+    /// A pool of worker threads, intended to be registered in the Context as a service.
+    ///
+    /// Work is offered to the pool as a range of indices. Idle workers and the calling thread claim indices one at a
+    /// time, so threads which finish early take over the remaining work rather than waiting.
+    /// Because the calling thread takes part, parallelFor can be called from within a task without risk of deadlock,
+    /// and a pool with no workers simply does all the work on the calling thread.
+    class BASELIB_API ThreadPool {
+      public:
+        /// Construct a pool with the given number of worker threads.
+        explicit ThreadPool(unsigned int numWorkers = getDefaultNumWorkers());
+        ~ThreadPool();
+
+        /// One fewer than the hardware concurrency, since the calling thread also does work.
+        static unsigned int getDefaultNumWorkers();
+
+        unsigned int getNumWorkers() const { return static_cast<unsigned int>(m_workers.size()); }
+
+        /// Call the function once for each index in [0, numIndices), possibly concurrently.
+        /// This returns once all the calls have finished. If any calls throw, one of the exceptions is rethrown here.
+        void parallelFor(std::size_t numIndices, const std::function<void(std::size_t)>& function) const;
+
+      public:
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+      private:
+        struct Job;
+
+        void workerLoop() const;
+
+        /// Claim and run indices of the job until there are none left.
+        static void runIndices(Job& job);
+
+        /// Stop offering the job to workers.
+        void removeJob(const std::shared_ptr<Job>& job) const;
+
+      private:
+        std::vector<std::thread> m_workers;
+
+        mutable std::mutex m_mutex;
+        mutable std::condition_variable m_jobAvailable;
+        /// Jobs which may still have unclaimed indices. Workers prefer the most recent, which keeps nested work local.
+        mutable std::vector<std::shared_ptr<Job>> m_jobs;
+        bool m_isStopping = false;
+    };
+
+} // namespace babelwires
@@ -30,6 +30,10 @@ babelwires::ShortId testDomain::TestParallelProcessor::getCommonArrayId() {
     return BW_SHORT_ID("array", "array", "0eed9f2e-c22a-4b9b-a1f7-c8b02f9a86ed");
 }
 
+bool testDomain::TestParallelProcessor::isOutputCacheable() const {
+    return true;
+}
+
 babelwires::Result testDomain::TestParallelProcessor::processEntry(babelwires::UserLogger& userLogger,
                                                      const babelwires::ValueTreeNode& input,
                                                      const babelwires::ValueTreeNode& inputEntry,
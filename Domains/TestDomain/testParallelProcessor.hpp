@@ -43,6 +43,9 @@ namespace testDomain {
 
         static babelwires::ShortId getCommonArrayId();
 
+        /// The output depends only on the input.
+        bool isOutputCacheable() const override;
+
         babelwires::Result processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
                           const babelwires::ValueTreeNode& inputEntry,
                           babelwires::ValueTreeNode& outputEntry) const override;
@@ -12,7 +12,9 @@
 testUtils::TestEnvironment::TestEnvironment()
     // Try to ensure the tests are deterministic by fixing the random seed.
     : m_randomService(0x123456789abcdeful)
-    , m_projectContext(m_deserializationReg, m_randomService, m_sourceFileFormatReg, m_targetFileFormatReg,
+    // A small pool is enough to exercise the parallel code.
+    , m_threadPool(2)
+    , m_projectContext(m_deserializationReg, m_randomService, m_threadPool, m_sourceFileFormatReg, m_targetFileFormatReg,
                        m_processorReg, m_typeSystem)
     , m_project(m_projectContext, m_log) {
 
@@ -39,12 +41,14 @@ testUtils::TestEnvironment::TestEnvironment()
 
 testUtils::TestEnvironment::TestContext::TestContext(babelwires::DeserializationRegistry& deserializationReg,
                                                babelwires::RandomService& randomService,
+                                               babelwires::ThreadPool& threadPool,
                                                babelwires::SourceFileFormatRegistry& sourceFileFormatReg,
                                                babelwires::TargetFileFormatRegistry& targetFileFormatReg,
                                                babelwires::ProcessorFactoryRegistry& processorReg,
                                                babelwires::TypeSystem& typeSystem) {
     registerService<babelwires::DeserializationRegistry>(deserializationReg);
     registerService<babelwires::RandomService>(randomService);
+    registerService<babelwires::ThreadPool>(threadPool);
     registerService<babelwires::SourceFileFormatRegistry>(sourceFileFormatReg);
     registerService<babelwires::TargetFileFormatRegistry>(targetFileFormatReg);
     registerService<babelwires::ProcessorFactoryRegistry>(processorReg);
@@ -11,6 +11,7 @@
 #include <BaseLib/Context/context.hpp>
 #include <BaseLib/Random/randomService.hpp>
 #include <BaseLib/Serialization/deserializationRegistry.hpp>
+#include <BaseLib/Threading/threadPool.hpp>
 
 namespace testUtils {
     struct TestEnvironment {
@@ -21,6 +22,7 @@ namespace testUtils {
         babelwires::ProcessorFactoryRegistry m_processorReg;
         babelwires::DeserializationRegistry m_deserializationReg;
         babelwires::RandomService m_randomService;
+        babelwires::ThreadPool m_threadPool;
         babelwires::TypeSystem m_typeSystem;
 
         /// A Context subclass that registers services in its constructor,
@@ -28,6 +30,7 @@ namespace testUtils {
         struct TestContext : babelwires::Context {
             TestContext(babelwires::DeserializationRegistry& deserializationReg,
                                babelwires::RandomService& randomService,
+                               babelwires::ThreadPool& threadPool,
                                babelwires::SourceFileFormatRegistry& sourceFileFormatReg,
                                babelwires::TargetFileFormatRegistry& targetFileFormatReg,
                                babelwires::ProcessorFactoryRegistry& processorReg, 
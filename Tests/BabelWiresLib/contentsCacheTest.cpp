@@ -512,6 +512,255 @@ TEST(ContentsCacheTest, inputAndOutputDifferentFeatures) {
     }
 }
 
+namespace {
+    /// Check that the cache has the same rows as a cache freshly built from the same data.
+    void checkSameRowsAsRebuiltCache(babelwires::EditTree& editTree, const babelwires::ContentsCache& cache,
+                                     const babelwires::ValueTreeNode* input, const babelwires::ValueTreeNode* output) {
+        babelwires::ContentsCache rebuiltCache(editTree);
+        rebuiltCache.setValueTrees("Test", input, output);
+        ASSERT_EQ(cache.getNumRows(), rebuiltCache.getNumRows());
+        for (int i = 0; i < cache.getNumRows(); ++i) {
+            const babelwires::ContentsCacheEntry* const entry = cache.getEntry(i);
+            const babelwires::ContentsCacheEntry* const rebuiltEntry = rebuiltCache.getEntry(i);
+            EXPECT_EQ(entry->getLabel(), rebuiltEntry->getLabel());
+            EXPECT_EQ(entry->getInput(), rebuiltEntry->getInput());
+            EXPECT_EQ(entry->getOutput(), rebuiltEntry->getOutput());
+            EXPECT_EQ(entry->getPath(), rebuiltEntry->getPath());
+            EXPECT_EQ(entry->getDepth(), rebuiltEntry->getDepth());
+            EXPECT_EQ(entry->getIndent(), rebuiltEntry->getIndent());
+            EXPECT_EQ(entry->isExpandable(), rebuiltEntry->isExpandable());
+            EXPECT_EQ(entry->isExpanded(), rebuiltEntry->isExpanded());
+            EXPECT_EQ(entry->hasModifier(), rebuiltEntry->hasModifier());
+            EXPECT_EQ(entry->hasSubmodifiers(), rebuiltEntry->hasSubmodifiers());
+        }
+    }
+} // namespace
+
+TEST(ContentsCacheTest, incrementalUpdates) {
+    testUtils::TestEnvironment testEnvironment;
+
+    babelwires::EditTree editTree;
+    babelwires::ContentsCache cache(editTree);
+
+    babelwires::ValueTreeRoot inputFeature(testEnvironment.m_typeSystem,
+                                           testEnvironment.m_typeSystem.getRegisteredType<testDomain::TestComplexRecordType>());
+    babelwires::ValueTreeRoot outputFeature(testEnvironment.m_typeSystem,
+                                           testEnvironment.m_typeSystem.getRegisteredType<testDomain::TestComplexRecordType>());
+    inputFeature.setToDefault();
+    outputFeature.setToDefault();
+    editTree.setExpanded(babelwires::Path(), true);
+
+    testDomain::TestComplexRecordTypeFeatureInfo info(inputFeature);
+
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    // Expanding and collapsing.
+    editTree.setExpanded(info.m_pathToArray, true);
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    ASSERT_EQ(cache.getNumRows(), 7 + testDomain::TestSimpleArrayType::s_defaultSize);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    editTree.setExpanded(info.m_pathToSubRecord, true);
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    editTree.setExpanded(info.m_pathToSubRecord, false);
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    // Changing the structure of the features.
+    {
+        testDomain::TestComplexRecordType::Instance input(inputFeature);
+        input.getarray().setSize(testDomain::TestSimpleArrayType::s_nonDefaultSize);
+    }
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    ASSERT_EQ(cache.getNumRows(), 7 + testDomain::TestSimpleArrayType::s_nonDefaultSize);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    {
+        testDomain::TestComplexRecordType::Instance output(outputFeature);
+        output.getarray().setSize(testDomain::TestSimpleArrayType::s_nonDefaultSize + 1);
+    }
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    // Shrink and regrow the array between updates, so any array elements are new nodes.
+    {
+        testDomain::TestComplexRecordType::Instance input(inputFeature);
+        input.getarray().setSize(testDomain::TestSimpleArrayType::s_defaultSize);
+        input.getarray().setSize(testDomain::TestSimpleArrayType::s_nonDefaultSize);
+    }
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    editTree.setExpanded(info.m_pathToArray, false);
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    ASSERT_EQ(cache.getNumRows(), 7);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+}
+
+TEST(ContentsCacheTest, lazyRows) {
+    testUtils::TestEnvironment testEnvironment;
+
+    babelwires::EditTree editTree;
+    babelwires::ContentsCache cache(editTree);
+
+    babelwires::ValueTreeRoot inputFeature(testEnvironment.m_typeSystem,
+                                           testEnvironment.m_typeSystem.getRegisteredType<testDomain::TestComplexRecordType>());
+    babelwires::ValueTreeRoot outputFeature(testEnvironment.m_typeSystem,
+                                           testEnvironment.m_typeSystem.getRegisteredType<testDomain::TestComplexRecordType>());
+    inputFeature.setToDefault();
+    outputFeature.setToDefault();
+    editTree.setExpanded(babelwires::Path(), true);
+
+    // The output has more array entries than the input, so the last entries have no input.
+    constexpr unsigned int numInputEntries = testDomain::TestSimpleArrayType::s_nonDefaultSize;
+    constexpr unsigned int numOutputEntries = testDomain::TestSimpleArrayType::s_maximumSize;
+    {
+        testDomain::TestComplexRecordType::Instance input(inputFeature);
+        input.getarray().setSize(numInputEntries);
+        testDomain::TestComplexRecordType::Instance output(outputFeature);
+        output.getarray().setSize(numOutputEntries);
+    }
+
+    testDomain::TestComplexRecordTypeFeatureInfo info(inputFeature);
+    const babelwires::ValueTreeNode* const outputArray = babelwires::tryFollowPath(info.m_pathToArray, outputFeature);
+    ASSERT_NE(outputArray, nullptr);
+
+    editTree.setExpanded(info.m_pathToArray, true);
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    ASSERT_EQ(cache.getNumRows(), 7 + numOutputEntries);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    const int arrayRow = cache.getIndexOfPath(true, info.m_pathToArray);
+    ASSERT_GE(arrayRow, 0);
+    EXPECT_EQ(cache.getEntry(arrayRow)->getInput(), &info.m_array);
+
+    const auto getPathToEntry = [&info](unsigned int i) {
+        babelwires::Path pathToEntry = info.m_pathToArray;
+        pathToEntry.pushStep(babelwires::PathStep(i));
+        return pathToEntry;
+    };
+
+    for (unsigned int i = 0; i < numOutputEntries; ++i) {
+        const int row = arrayRow + 1 + i;
+        const babelwires::ContentsCacheEntry* const entry = cache.getEntry(row);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->getPath(), getPathToEntry(i));
+        EXPECT_EQ(entry->getInput(), (i < numInputEntries) ? info.m_array.getChild(i) : nullptr);
+        EXPECT_EQ(entry->getOutput(), outputArray->getChild(i));
+        EXPECT_EQ(entry->getDepth(), 2);
+        EXPECT_FALSE(entry->isExpanded());
+        checkUnmodified(entry);
+        // The same entry is returned until the cache is updated.
+        EXPECT_EQ(cache.getEntry(row), entry);
+        EXPECT_EQ(cache.getIndexOfPath(false, getPathToEntry(i)), row);
+        EXPECT_EQ(cache.getIndexOfPath(true, getPathToEntry(i)), (i < numInputEntries) ? row : -1);
+    }
+    EXPECT_EQ(cache.getIndexOfPath(false, getPathToEntry(numOutputEntries)), -1);
+
+    // Modifying a row in the middle of the array splits the runs of lazy rows around it.
+    testUtils::TestNode owner(testEnvironment.m_projectContext);
+    editTree.addModifier(createIntModifier(getPathToEntry(3), &owner));
+    cache.clearChanges();
+    cache.updateModifierCache();
+    EXPECT_FALSE(cache.isChanged(babelwires::ContentsCache::Changes::StructureChanged));
+    ASSERT_EQ(cache.getNumRows(), 7 + numOutputEntries);
+    {
+        const babelwires::ContentsCacheEntry* const entry = cache.getEntry(arrayRow);
+        EXPECT_TRUE(entry->hasSubmodifiers());
+        EXPECT_FALSE(entry->hasHiddenModifier());
+    }
+    for (unsigned int i = 0; i < numOutputEntries; ++i) {
+        const int row = arrayRow + 1 + i;
+        const babelwires::ContentsCacheEntry* const entry = cache.getEntry(row);
+        EXPECT_EQ(entry->getPath(), getPathToEntry(i));
+        EXPECT_EQ(entry->hasModifier(), (i == 3));
+        EXPECT_EQ(cache.getIndexOfPath(false, getPathToEntry(i)), row);
+    }
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    // Expanding a row before the array moves the lazy rows.
+    editTree.setExpanded(info.m_pathToSubRecord, true);
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+    EXPECT_EQ(cache.getEntry(cache.getIndexOfPath(true, info.m_pathToSubRecordInt))->getInput(),
+              &info.m_subRecordInt);
+    const int movedArrayRow = cache.getIndexOfPath(true, info.m_pathToArray);
+    ASSERT_GT(movedArrayRow, arrayRow);
+    EXPECT_EQ(cache.getEntry(movedArrayRow + 1 + numOutputEntries - 1)->getOutput(),
+              outputArray->getChild(numOutputEntries - 1));
+
+    editTree.removeModifier(editTree.findModifier(getPathToEntry(3)));
+    cache.updateModifierCache();
+    EXPECT_FALSE(cache.getEntry(movedArrayRow + 4)->hasModifier());
+    EXPECT_FALSE(cache.getEntry(movedArrayRow)->hasSubmodifiers());
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+}
+
+TEST(ContentsCacheTest, incrementalUpdatesReuseRows) {
+    testUtils::TestEnvironment testEnvironment;
+
+    babelwires::EditTree editTree;
+    babelwires::ContentsCache cache(editTree);
+
+    babelwires::ValueTreeRoot inputFeature(testEnvironment.m_typeSystem,
+                                           testEnvironment.m_typeSystem.getRegisteredType<testDomain::TestComplexRecordType>());
+    babelwires::ValueTreeRoot outputFeature(testEnvironment.m_typeSystem,
+                                           testEnvironment.m_typeSystem.getRegisteredType<testDomain::TestComplexRecordType>());
+    inputFeature.setToDefault();
+    outputFeature.setToDefault();
+
+    testDomain::TestComplexRecordTypeFeatureInfo info(inputFeature);
+    babelwires::Path pathToEntry1 = info.m_pathToArray;
+    pathToEntry1.pushStep(babelwires::PathStep(1));
+
+    // Only the root, the expanded rows and the modified rows are stored. The other fields and array entries are lazy.
+    testUtils::TestNode owner(testEnvironment.m_projectContext);
+    editTree.setExpanded(babelwires::Path(), true);
+    editTree.setExpanded(info.m_pathToSubRecord, true);
+    editTree.setExpanded(info.m_pathToArray, true);
+    editTree.addModifier(createIntModifier(info.m_pathToSubRecordInt, &owner));
+    editTree.addModifier(createIntModifier(pathToEntry1, &owner));
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    EXPECT_EQ(cache.getLastUpdateStatistics().m_numRowsStored, 5);
+    EXPECT_EQ(cache.getLastUpdateStatistics().m_numRowsBuilt, 5);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+
+    const int subRecordIntRow = cache.getIndexOfPath(true, info.m_pathToSubRecordInt);
+    ASSERT_GE(subRecordIntRow, 0);
+    EXPECT_TRUE(cache.getEntry(subRecordIntRow)->hasModifier());
+
+    // Nothing changed, so nothing is rebuilt.
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    EXPECT_EQ(cache.getLastUpdateStatistics().m_numRowsStored, 5);
+    EXPECT_EQ(cache.getLastUpdateStatistics().m_numRowsBuilt, 0);
+
+    // Resizing the array rebuilds only the rows of the array and its modified entry. The lazy siblings of the array
+    // do not prevent the rows of the root and the subrecord being reused.
+    {
+        testDomain::TestComplexRecordType::Instance input(inputFeature);
+        input.getarray().setSize(testDomain::TestSimpleArrayType::s_nonDefaultSize);
+    }
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    EXPECT_EQ(cache.getLastUpdateStatistics().m_numRowsStored, 5);
+    EXPECT_EQ(cache.getLastUpdateStatistics().m_numRowsBuilt, 2);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+    EXPECT_EQ(cache.getIndexOfPath(true, info.m_pathToSubRecordInt), subRecordIntRow);
+    EXPECT_TRUE(cache.getEntry(subRecordIntRow)->hasModifier());
+    EXPECT_TRUE(cache.getEntry(cache.getIndexOfPath(true, pathToEntry1))->hasModifier());
+
+    // Activating an optional field changes the children of the root, so all its rows are rebuilt.
+    {
+        testDomain::TestComplexRecordType::Instance input(inputFeature);
+        input.activateAndGetopInt();
+    }
+    cache.setValueTrees("Test", &inputFeature, &outputFeature);
+    EXPECT_EQ(cache.getLastUpdateStatistics().m_numRowsBuilt, 5);
+    checkSameRowsAsRebuiltCache(editTree, cache, &inputFeature, &outputFeature);
+}
+
 TEST(ContentsCacheTest, hiddenTopLevelModifiers) {
     testUtils::TestEnvironment testEnvironment;
 
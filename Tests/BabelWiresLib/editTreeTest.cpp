@@ -883,3 +883,50 @@ TEST(EditTreeTest, filteredModifierIteration) {
     ++it;
     EXPECT_EQ(it, range.end());
 }
+
+TEST(EditTreeTest, manyModifiers) {
+    babelwires::EditTree tree;
+
+    // More than can be indexed by 16 bits.
+    constexpr babelwires::ArrayIndex numModifiers = 70000;
+
+    babelwires::Path pathToArray = *babelwires::Path::deserializeFromString("aa");
+    for (babelwires::ArrayIndex i = 0; i < numModifiers; ++i) {
+        babelwires::Path path = pathToArray;
+        path.pushStep(i);
+        tree.addModifier(createModifier(path, i));
+    }
+    tree.addModifier(createModifier(*babelwires::Path::deserializeFromString("bb"), 1));
+
+    {
+        babelwires::Path path = pathToArray;
+        path.pushStep(numModifiers - 1);
+        const babelwires::Modifier* mod = tree.findModifier(path);
+        ASSERT_NE(mod, nullptr);
+        EXPECT_EQ(mod->getModifierData().m_targetPath, path);
+    }
+
+    babelwires::ArrayIndex count = 0;
+    for (const auto* mod : tree.modifierRange(pathToArray)) {
+        const babelwires::Path& targetPath = mod->getModifierData().m_targetPath;
+        EXPECT_EQ(targetPath.getLastStep(), count);
+        ++count;
+    }
+    EXPECT_EQ(count, numModifiers);
+
+    for (babelwires::ArrayIndex i = 0; i < numModifiers; i += 2) {
+        babelwires::Path path = pathToArray;
+        path.pushStep(i);
+        const babelwires::Modifier* mod = tree.findModifier(path);
+        ASSERT_NE(mod, nullptr);
+        EXPECT_NE(tree.removeModifier(mod), nullptr);
+    }
+
+    count = 0;
+    for (const auto* mod : tree.modifierRange(pathToArray)) {
+        EXPECT_EQ(mod->getModifierData().m_targetPath.getLastStep(), 2 * count + 1);
+        ++count;
+    }
+    EXPECT_EQ(count, numModifiers / 2);
+    EXPECT_NE(tree.findModifier(*babelwires::Path::deserializeFromString("bb")), nullptr);
+}
@@ -107,4 +107,53 @@ TEST(EnumTest, subEnum) {
     enumValue->set("Flerm");
     EXPECT_FALSE(testEnum->isValidValue(typeSystem, value));
     EXPECT_FALSE(testSubEnum->isValidValue(typeSystem, value));
-}
\ No newline at end of file
+}
+
+TEST(EnumTest, largeEnum) {
+    testUtils::TestLog log;
+
+    babelwires::EnumType::ValueSet values;
+    for (int i = 0; i < 200; ++i) {
+        babelwires::ShortId id("v" + std::to_string(i));
+        id.setDiscriminator(1);
+        values.emplace_back(id);
+    }
+    babelwires::EnumType bigEnum(babelwires::MediumId("BigEnm"), values, 0);
+
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(bigEnum.getIndexFromIdentifier(babelwires::ShortId("v" + std::to_string(i))), i);
+        EXPECT_EQ(bigEnum.getIdentifierFromIndex(i), values[i]);
+    }
+    EXPECT_EQ(bigEnum.tryGetIndexFromIdentifier("v200"), -1);
+    EXPECT_EQ(bigEnum.tryGetIndexFromIdentifier("Foo"), -1);
+
+    babelwires::ShortId v7("v7");
+    v7.setDiscriminator(2);
+    EXPECT_FALSE(bigEnum.isAValue(v7));
+    v7.setDiscriminator(1);
+    EXPECT_TRUE(bigEnum.isAValue(v7));
+
+    const std::vector<babelwires::ShortId> ids = {"v10", "v0", "v199", "v10"};
+    std::vector<unsigned int> indices(ids.size());
+    bigEnum.getIndicesFromIdentifiers(ids, indices);
+    EXPECT_EQ(indices, (std::vector<unsigned int>{10, 0, 199, 10}));
+}
+
+TEST(EnumTest, valuesDifferingOnlyByDiscriminator) {
+    testUtils::TestLog log;
+
+    babelwires::ShortId foo1("Foo");
+    foo1.setDiscriminator(1);
+    babelwires::ShortId foo2("Foo");
+    foo2.setDiscriminator(2);
+    babelwires::ShortId bar1("Bar");
+    bar1.setDiscriminator(1);
+    babelwires::EnumType enumType(babelwires::MediumId("FooEnm"), {bar1, foo1, foo2}, 0);
+
+    EXPECT_EQ(enumType.getIndexFromIdentifier(bar1), 0);
+    EXPECT_EQ(enumType.getIndexFromIdentifier(foo1), 1);
+    EXPECT_EQ(enumType.getIndexFromIdentifier(foo2), 2);
+    babelwires::ShortId foo3("Foo");
+    foo3.setDiscriminator(3);
+    EXPECT_FALSE(enumType.isAValue(foo3));
+}
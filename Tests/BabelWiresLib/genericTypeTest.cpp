@@ -2,6 +2,7 @@
 
 #include <BabelWiresLib/TypeSystem/valuePathUtils.hpp>
 #include <BabelWiresLib/Types/Generic/genericType.hpp>
+#include <BabelWiresLib/Types/Generic/genericValue.hpp>
 #include <BabelWiresLib/Types/Generic/typeVariableType.hpp>
 #include <BabelWiresLib/Types/String/stringType.hpp>
 
@@ -148,6 +149,37 @@ TEST(GenericTypeTest, instantiateTypeVariables) {
     checkInstantiations(typeSystem, *genericType, valueHolder, false, false);
 }
 
+TEST(GenericTypeTest, instantiationsAreShared) {
+    testUtils::TestEnvironment env;
+    babelwires::TypeSystem& typeSystem = env.m_typeSystem;
+
+    babelwires::TypePtr type = typeSystem.getRegisteredType<testDomain::TestGenericType>();
+    const babelwires::GenericType& genericType = type->as<babelwires::GenericType>();
+
+    std::vector<babelwires::TypeExp> typeAssignments(2);
+    typeAssignments[0] = babelwires::DefaultIntType::getThisIdentifier();
+
+    babelwires::ValueHolder valueHolder0 = genericType.createValue(typeSystem);
+    babelwires::ValueHolder valueHolder1 = genericType.createValue(typeSystem);
+    genericType.setTypeVariableAssignmentAndInstantiate(typeSystem, valueHolder0, typeAssignments);
+    genericType.setTypeVariableAssignmentAndInstantiate(typeSystem, valueHolder1, typeAssignments);
+
+    const auto& genericValue0 = valueHolder0->as<babelwires::GenericValue>();
+    const auto& genericValue1 = valueHolder1->as<babelwires::GenericValue>();
+    EXPECT_EQ(genericValue0.getActualWrappedType(), genericValue1.getActualWrappedType());
+    EXPECT_EQ(genericValue0.getValue().getUnsafe(), genericValue1.getValue().getUnsafe());
+    EXPECT_TRUE(genericType.isValidValue(typeSystem, *valueHolder1));
+    checkInstantiations(typeSystem, genericType, valueHolder1, true, false);
+
+    // Modifying the wrapped value of one does not affect the other.
+    babelwires::ValueHolder wrappedValue = genericValue0.getValue();
+    babelwires::GenericValue& mutableGenericValue1 =
+        valueHolder1.copyContentsAndGetNonConst().as<babelwires::GenericValue>();
+    mutableGenericValue1.getValue().copyContentsAndGetNonConst();
+    EXPECT_EQ(genericValue0.getValue().getUnsafe(), wrappedValue.getUnsafe());
+    EXPECT_NE(mutableGenericValue1.getValue().getUnsafe(), wrappedValue.getUnsafe());
+}
+
 TEST(GenericTypeTest, instantiateNestedTypeVariable) {
     testUtils::TestEnvironment env;
     babelwires::TypeSystem& typeSystem = env.m_typeSystem;
@@ -2,13 +2,17 @@
 
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
 #include <BabelWiresLib/Types/Enum/enumValue.hpp>
+#include <BabelWiresLib/Types/Int/intType.hpp>
+#include <BabelWiresLib/Types/Map/Helpers/compiledMapApplicator.hpp>
 #include <BabelWiresLib/Types/Map/Helpers/enumSourceMapApplicator.hpp>
 #include <BabelWiresLib/Types/Map/Helpers/enumValueAdapters.hpp>
+#include <BabelWiresLib/Types/Map/Helpers/scalarValueAdapters.hpp>
 #include <BabelWiresLib/Types/Map/Helpers/unorderedMapApplicator.hpp>
 #include <BabelWiresLib/Types/Map/MapEntries/allToOneFallbackMapEntryData.hpp>
 #include <BabelWiresLib/Types/Map/MapEntries/allToSameFallbackMapEntryData.hpp>
 #include <BabelWiresLib/Types/Map/MapEntries/oneToOneMapEntryData.hpp>
 #include <BabelWiresLib/Types/Map/mapValue.hpp>
+#include <BabelWiresLib/Types/Rational/rationalType.hpp>
 #include <BabelWiresLib/Types/String/stringType.hpp>
 #include <BabelWiresLib/Types/String/stringValue.hpp>
 
@@ -144,6 +148,31 @@ namespace {
         return setUpTestMapValue(typeSystem, testDomain::TestEnum::getThisIdentifier(), testDomain::TestEnum::getThisIdentifier(),
                                  sourceValue1, sourceValue2, targetValue1, targetValue2, targetValue3, true);
     }
+
+    /// A map from ints to ints, where each source maps to its negation.
+    babelwires::MapValue setUpTestIntMapValue(const babelwires::TypeSystem& typeSystem,
+                                              const std::vector<babelwires::IntValue::NativeType>& sources,
+                                              bool allToOneFallback) {
+        babelwires::TypePtr intType = typeSystem.getRegisteredType<babelwires::DefaultIntType>();
+
+        babelwires::MapValue mapValue;
+        mapValue.setSourceTypeExp(babelwires::DefaultIntType::getThisIdentifier());
+        mapValue.setTargetTypeExp(babelwires::DefaultIntType::getThisIdentifier());
+        for (auto source : sources) {
+            auto oneToOne = std::make_unique<babelwires::OneToOneMapEntryData>(typeSystem, *intType, *intType);
+            oneToOne->setSourceValue(babelwires::IntValue(source));
+            oneToOne->setTargetValue(babelwires::IntValue(-source));
+            mapValue.emplaceBack(std::move(oneToOne));
+        }
+        if (allToOneFallback) {
+            auto allToOne = std::make_unique<babelwires::AllToOneFallbackMapEntryData>(typeSystem, *intType);
+            allToOne->setTargetValue(babelwires::IntValue(1000));
+            mapValue.emplaceBack(std::move(allToOne));
+        } else {
+            mapValue.emplaceBack(std::make_unique<babelwires::AllToSameFallbackMapEntryData>());
+        }
+        return mapValue;
+    }
 } // namespace
 
 TEST(MapHelperTest, unorderedMapApplicator_allToOneFallback) {
@@ -254,3 +283,118 @@ TEST(MapHelperTest, enumSourceMapApplicator_differentTypes) {
     EXPECT_EQ(mapApplicator[testDomain::TestEnum::Value::Oom], "zzz");
     EXPECT_EQ(mapApplicator[testDomain::TestEnum::Value::Boo], "zzz");
 }
+
+TEST(MapHelperTest, compiledMapApplicator_denseTable) {
+    testUtils::TestLog log;
+    babelwires::TypeSystem typeSystem;
+    typeSystem.addType<babelwires::DefaultIntType>();
+
+    for (bool allToOneFallback : {true, false}) {
+        babelwires::MapValue mapValue = setUpTestIntMapValue(typeSystem, {60, 64, 67}, allToOneFallback);
+
+        babelwires::CompiledMapApplicator<babelwires::IntValue::NativeType, babelwires::IntValue::NativeType>
+            mapApplicator(mapValue, babelwires::IntToNativeValueAdapter(), babelwires::IntToNativeValueAdapter());
+
+        EXPECT_EQ(mapApplicator.getRepresentation(), decltype(mapApplicator)::Representation::DenseTable);
+        EXPECT_EQ(mapApplicator[60], -60);
+        EXPECT_EQ(mapApplicator[64], -64);
+        EXPECT_EQ(mapApplicator[67], -67);
+        // Inside the table but not an entry.
+        EXPECT_EQ(mapApplicator[62], allToOneFallback ? 1000 : 62);
+        // Outside the table in both directions.
+        EXPECT_EQ(mapApplicator[59], allToOneFallback ? 1000 : 59);
+        EXPECT_EQ(mapApplicator[68], allToOneFallback ? 1000 : 68);
+        EXPECT_EQ(mapApplicator[-1000000], allToOneFallback ? 1000 : -1000000);
+    }
+}
+
+TEST(MapHelperTest, compiledMapApplicator_sortedArrayAndHashTable) {
+    testUtils::TestLog log;
+    babelwires::TypeSystem typeSystem;
+    typeSystem.addType<babelwires::DefaultIntType>();
+
+    using Applicator =
+        babelwires::CompiledMapApplicator<babelwires::IntValue::NativeType, babelwires::IntValue::NativeType>;
+
+    // Too sparse for a dense table.
+    std::vector<babelwires::IntValue::NativeType> sources = {-5000, 0, 5000};
+    {
+        babelwires::MapValue mapValue = setUpTestIntMapValue(typeSystem, sources, false);
+        Applicator mapApplicator(mapValue, babelwires::IntToNativeValueAdapter(),
+                                 babelwires::IntToNativeValueAdapter());
+        EXPECT_EQ(mapApplicator.getRepresentation(), Applicator::Representation::SortedArray);
+        EXPECT_EQ(mapApplicator[-5000], 5000);
+        EXPECT_EQ(mapApplicator[0], 0);
+        EXPECT_EQ(mapApplicator[5000], -5000);
+        EXPECT_EQ(mapApplicator[17], 17);
+    }
+
+    for (int i = 0; i < 40; ++i) {
+        sources.emplace_back(10000 * (i + 1));
+    }
+    {
+        babelwires::MapValue mapValue = setUpTestIntMapValue(typeSystem, sources, false);
+        Applicator mapApplicator(mapValue, babelwires::IntToNativeValueAdapter(),
+                                 babelwires::IntToNativeValueAdapter());
+        EXPECT_EQ(mapApplicator.getRepresentation(), Applicator::Representation::HashTable);
+        EXPECT_EQ(mapApplicator[-5000], 5000);
+        EXPECT_EQ(mapApplicator[400000], -400000);
+        EXPECT_EQ(mapApplicator[17], 17);
+    }
+}
+
+TEST(MapHelperTest, compiledMapApplicator_laterEntriesTakePrecedence) {
+    testUtils::TestLog log;
+    babelwires::TypeSystem typeSystem;
+    typeSystem.addType<babelwires::StringType>();
+
+    babelwires::MapValue mapValue = setUpTestMapValue(
+        typeSystem, babelwires::StringType::getThisIdentifier(), babelwires::StringType::getThisIdentifier(),
+        babelwires::StringValue("aaa"), babelwires::StringValue("aaa"), babelwires::StringValue("xxx"),
+        babelwires::StringValue("yyy"), babelwires::StringValue("zzz"), true);
+
+    babelwires::CompiledMapApplicator<std::string, std::string> mapApplicator(
+        mapValue, babelwires::StringToNativeValueAdapter(), babelwires::StringToNativeValueAdapter());
+
+    EXPECT_EQ(mapApplicator.getRepresentation(),
+              (babelwires::CompiledMapApplicator<std::string, std::string>::Representation::SortedArray));
+    EXPECT_EQ(mapApplicator["aaa"], "yyy");
+    EXPECT_EQ(mapApplicator["bbb"], "zzz");
+}
+
+TEST(MapHelperTest, compiledMapApplicator_batch) {
+    testUtils::TestLog log;
+    babelwires::TypeSystem typeSystem;
+    typeSystem.addType<babelwires::DefaultIntType>();
+
+    babelwires::MapValue mapValue = setUpTestIntMapValue(typeSystem, {1, 2, 3}, false);
+
+    babelwires::CompiledMapApplicator<babelwires::IntValue::NativeType, babelwires::IntValue::NativeType>
+        mapApplicator(mapValue, babelwires::IntToNativeValueAdapter(), babelwires::IntToNativeValueAdapter());
+
+    const std::vector<babelwires::IntValue::NativeType> in = {0, 1, 2, 3, 4, 2};
+    std::vector<babelwires::IntValue::NativeType> out(in.size());
+    mapApplicator.apply(in, out);
+
+    EXPECT_EQ(out, (std::vector<babelwires::IntValue::NativeType>{0, -1, -2, -3, 4, -2}));
+}
+
+TEST(MapHelperTest, compiledMapApplicator_rational) {
+    testUtils::TestLog log;
+    babelwires::TypeSystem typeSystem;
+    typeSystem.addType<babelwires::DefaultRationalType>();
+
+    babelwires::MapValue mapValue = setUpTestMapValue(
+        typeSystem, babelwires::DefaultRationalType::getThisIdentifier(),
+        babelwires::DefaultRationalType::getThisIdentifier(), babelwires::RationalValue(babelwires::Rational(1, 2)),
+        babelwires::RationalValue(babelwires::Rational(1, 3)), babelwires::RationalValue(babelwires::Rational(1, 4)),
+        babelwires::RationalValue(babelwires::Rational(1, 5)), babelwires::RationalValue(babelwires::Rational(1)),
+        false);
+
+    babelwires::CompiledMapApplicator<babelwires::Rational, babelwires::Rational> mapApplicator(
+        mapValue, babelwires::RationalToNativeValueAdapter(), babelwires::RationalToNativeValueAdapter());
+
+    EXPECT_EQ(mapApplicator[babelwires::Rational(1, 2)], babelwires::Rational(1, 4));
+    EXPECT_EQ(mapApplicator[babelwires::Rational(1, 3)], babelwires::Rational(1, 5));
+    EXPECT_EQ(mapApplicator[babelwires::Rational(2, 3)], babelwires::Rational(2, 3));
+}
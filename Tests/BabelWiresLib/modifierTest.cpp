@@ -404,3 +404,75 @@ TEST(ModifierTest, connectionModifierApplicationFailure) {
     EXPECT_TRUE(testEnvironment.m_log.hasSubstringIgnoreCase("Failed to apply operation"));
     EXPECT_TRUE(testEnvironment.m_log.hasSubstringIgnoreCase("not a valid instance"));
 }
+
+TEST(ModifierTest, connectionModifierFollowsStructuralChanges) {
+    testUtils::TestEnvironment testEnvironment;
+
+    babelwires::ValueNodeData elementData{testDomain::TestComplexRecordType::getThisIdentifier()};
+
+    const babelwires::Path sourcePath{
+        std::vector<babelwires::PathStep>{testDomain::TestComplexRecordType::getSubrecordId(),
+                                          testDomain::TestSimpleRecordType::getInt0Id()}};
+
+    babelwires::ValueAssignmentData sourceData(babelwires::IntValue(100));
+    sourceData.m_targetPath = sourcePath;
+    elementData.m_modifiers.emplace_back(std::make_unique<babelwires::ValueAssignmentData>(sourceData));
+
+    const babelwires::NodeId sourceId = testEnvironment.m_project.addNode(elementData);
+
+    babelwires::ValueTreeRoot targetRecordFeature(
+        testEnvironment.m_typeSystem,
+        testEnvironment.m_typeSystem.getRegisteredType<testDomain::TestComplexRecordType>());
+    targetRecordFeature.setToDefault();
+    testDomain::TestComplexRecordType::Instance targetInstance{targetRecordFeature};
+
+    const babelwires::Path targetPath{std::vector<babelwires::PathStep>{
+        testDomain::TestComplexRecordType::getArrayId(), babelwires::PathStep(3)}};
+
+    auto assignFromData = std::make_unique<babelwires::ConnectionModifierData>();
+    assignFromData->m_targetPath = targetPath;
+    assignFromData->m_sourcePath = sourcePath;
+    assignFromData->m_sourceId = sourceId;
+
+    babelwires::ConnectionModifier connectionMod(std::move(assignFromData));
+    TestOwner owner;
+    connectionMod.setOwner(&owner);
+
+    connectionMod.applyConnection(testEnvironment.m_project, testEnvironment.m_log, &targetRecordFeature);
+    EXPECT_FALSE(connectionMod.isFailed());
+    EXPECT_EQ(targetInstance.getarray().getEntry(3).get(), 100);
+
+    // Value changes do not change the structure of the tree.
+    const std::uint64_t generation = targetRecordFeature.getStructureGeneration();
+    targetInstance.getstring().set("Hello");
+    EXPECT_EQ(targetRecordFeature.getStructureGeneration(), generation);
+
+    // Removing the target changes the structure.
+    targetInstance.getarray().setSize(2);
+    EXPECT_NE(targetRecordFeature.getStructureGeneration(), generation);
+    connectionMod.applyConnection(testEnvironment.m_project, testEnvironment.m_log, &targetRecordFeature, true);
+    EXPECT_TRUE(connectionMod.isFailed());
+    EXPECT_EQ(connectionMod.getState(), babelwires::Modifier::State::TargetMissing);
+
+    targetInstance.getarray().setSize(4);
+    EXPECT_EQ(targetInstance.getarray().getEntry(3).get(), 0);
+    connectionMod.applyConnection(testEnvironment.m_project, testEnvironment.m_log, &targetRecordFeature, true);
+    EXPECT_FALSE(connectionMod.isFailed());
+    EXPECT_EQ(targetInstance.getarray().getEntry(3).get(), 100);
+
+    // Replacing the source node.
+    testEnvironment.m_project.removeNode(sourceId);
+    connectionMod.applyConnection(testEnvironment.m_project, testEnvironment.m_log, &targetRecordFeature, true);
+    EXPECT_TRUE(connectionMod.isFailed());
+    EXPECT_EQ(connectionMod.getState(), babelwires::Modifier::State::SourceMissing);
+
+    elementData.m_id = sourceId;
+    elementData.m_modifiers.clear();
+    babelwires::ValueAssignmentData newSourceData(babelwires::IntValue(200));
+    newSourceData.m_targetPath = sourcePath;
+    elementData.m_modifiers.emplace_back(std::make_unique<babelwires::ValueAssignmentData>(newSourceData));
+    EXPECT_EQ(testEnvironment.m_project.addNode(elementData), sourceId);
+    connectionMod.applyConnection(testEnvironment.m_project, testEnvironment.m_log, &targetRecordFeature, true);
+    EXPECT_FALSE(connectionMod.isFailed());
+    EXPECT_EQ(targetInstance.getarray().getEntry(3).get(), 200);
+}
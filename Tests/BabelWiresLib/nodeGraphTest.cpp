@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <BabelWiresLib/Project/Modifiers/connectionModifier.hpp>
+#include <BabelWiresLib/Project/Modifiers/connectionModifierData.hpp>
+#include <BabelWiresLib/Project/Nodes/node.hpp>
+#include <BabelWiresLib/Project/nodeGraph.hpp>
+#include <BabelWiresLib/Project/project.hpp>
+
+#include <Domains/TestDomain/testRecordType.hpp>
+
+#include <Tests/BabelWiresLib/TestUtils/testEnvironment.hpp>
+
+namespace {
+    std::unique_ptr<babelwires::ConnectionModifier> createConnectionModifier(babelwires::NodeId sourceId) {
+        auto data = std::make_unique<babelwires::ConnectionModifierData>();
+        data->m_sourceId = sourceId;
+        return std::make_unique<babelwires::ConnectionModifier>(std::move(data));
+    }
+
+    bool hasEdge(std::span<const babelwires::NodeGraph::Edge> edges, const babelwires::ConnectionModifier* connection,
+                 babelwires::NodeGraph::Slot otherSlot) {
+        return std::find_if(edges.begin(), edges.end(), [&](const babelwires::NodeGraph::Edge& edge) {
+                   return (edge.m_connection == connection) && (edge.m_otherSlot == otherSlot);
+               }) != edges.end();
+    }
+} // namespace
+
+TEST(NodeGraphTest, slots) {
+    testUtils::TestEnvironment testEnvironment;
+
+    const babelwires::NodeId idA = testEnvironment.m_project.addNode(testDomain::TestComplexRecordElementData());
+    const babelwires::NodeId idB = testEnvironment.m_project.addNode(testDomain::TestComplexRecordElementData());
+    const babelwires::NodeId idC = testEnvironment.m_project.addNode(testDomain::TestComplexRecordElementData());
+    babelwires::Node* nodeA = testEnvironment.m_project.getNode(idA);
+    babelwires::Node* nodeB = testEnvironment.m_project.getNode(idB);
+    babelwires::Node* nodeC = testEnvironment.m_project.getNode(idC);
+
+    babelwires::NodeGraph graph;
+    const babelwires::NodeGraph::Slot slotA = graph.addNode(nodeA);
+    const babelwires::NodeGraph::Slot slotB = graph.addNode(nodeB);
+    EXPECT_EQ(graph.getNumSlots(), 2);
+    EXPECT_NE(slotA, slotB);
+    EXPECT_EQ(graph.getSlot(idA), slotA);
+    EXPECT_EQ(graph.getSlot(idB), slotB);
+    EXPECT_EQ(graph.getSlot(idC), babelwires::NodeGraph::c_invalidSlot);
+    EXPECT_EQ(graph.getNode(slotA), nodeA);
+    EXPECT_EQ(graph.getNode(slotB), nodeB);
+
+    graph.removeNode(slotA);
+    EXPECT_EQ(graph.getSlot(idA), babelwires::NodeGraph::c_invalidSlot);
+    EXPECT_EQ(graph.getNode(slotA), nullptr);
+
+    // The free slot is reused, so the slots stay dense.
+    const babelwires::NodeGraph::Slot slotC = graph.addNode(nodeC);
+    EXPECT_EQ(slotC, slotA);
+    EXPECT_EQ(graph.getNumSlots(), 2);
+    EXPECT_EQ(graph.getNode(slotC), nodeC);
+    EXPECT_EQ(graph.getSlot(idC), slotC);
+
+    graph.clear();
+    EXPECT_EQ(graph.getNumSlots(), 0);
+    EXPECT_EQ(graph.getSlot(idB), babelwires::NodeGraph::c_invalidSlot);
+}
+
+TEST(NodeGraphTest, connections) {
+    testUtils::TestEnvironment testEnvironment;
+
+    std::vector<babelwires::Node*> nodes;
+    for (int i = 0; i < 4; ++i) {
+        const babelwires::NodeId id = testEnvironment.m_project.addNode(testDomain::TestComplexRecordElementData());
+        nodes.emplace_back(testEnvironment.m_project.getNode(id));
+    }
+
+    babelwires::NodeGraph graph;
+    std::vector<babelwires::NodeGraph::Slot> slots;
+    for (auto* node : nodes) {
+        slots.emplace_back(graph.addNode(node));
+    }
+
+    // Enough connections from the first node that its block of edges has to move several times.
+    std::vector<std::unique_ptr<babelwires::ConnectionModifier>> connections;
+    for (int i = 0; i < 30; ++i) {
+        const int target = 1 + (i % 3);
+        connections.emplace_back(createConnectionModifier(nodes[0]->getNodeId()));
+        graph.addConnection(slots[0], slots[target], connections.back().get());
+        connections.emplace_back(createConnectionModifier(nodes[target]->getNodeId()));
+        graph.addConnection(slots[target], slots[0], connections.back().get());
+    }
+
+    graph.validate();
+    EXPECT_EQ(graph.getNumConnections(), 60);
+    EXPECT_EQ(graph.getOutgoingEdges(slots[0]).size(), 30);
+    EXPECT_EQ(graph.getIncomingEdges(slots[0]).size(), 30);
+    for (int t = 1; t < 4; ++t) {
+        EXPECT_EQ(graph.getOutgoingEdges(slots[t]).size(), 10);
+        EXPECT_EQ(graph.getIncomingEdges(slots[t]).size(), 10);
+    }
+    for (int i = 0; i < 30; ++i) {
+        const int target = 1 + (i % 3);
+        EXPECT_TRUE(hasEdge(graph.getOutgoingEdges(slots[0]), connections[2 * i].get(), slots[target]));
+        EXPECT_TRUE(hasEdge(graph.getIncomingEdges(slots[target]), connections[2 * i].get(), slots[0]));
+        EXPECT_TRUE(hasEdge(graph.getOutgoingEdges(slots[target]), connections[2 * i + 1].get(), slots[0]));
+        EXPECT_TRUE(hasEdge(graph.getIncomingEdges(slots[0]), connections[2 * i + 1].get(), slots[target]));
+    }
+
+    // Remove the connections to and from the last node.
+    for (int i = 2; i < 30; i += 3) {
+        graph.removeConnection(connections[2 * i].get());
+        graph.removeConnection(connections[2 * i + 1].get());
+        graph.validate();
+    }
+    EXPECT_EQ(graph.getNumConnections(), 40);
+    EXPECT_FALSE(graph.hasConnection(connections[4].get()));
+    EXPECT_TRUE(graph.hasConnection(connections[2].get()));
+    EXPECT_EQ(graph.getOutgoingEdges(slots[0]).size(), 20);
+    EXPECT_EQ(graph.getIncomingEdges(slots[0]).size(), 20);
+    EXPECT_TRUE(graph.getOutgoingEdges(slots[3]).empty());
+    EXPECT_TRUE(graph.getIncomingEdges(slots[3]).empty());
+    EXPECT_FALSE(hasEdge(graph.getOutgoingEdges(slots[0]), connections[4].get(), slots[3]));
+    EXPECT_TRUE(hasEdge(graph.getOutgoingEdges(slots[0]), connections[2].get(), slots[2]));
+
+    // The remaining edges keep the order in which they were added.
+    std::vector<const babelwires::ConnectionModifier*> expectedOutgoing;
+    std::vector<const babelwires::ConnectionModifier*> expectedIncoming;
+    for (int i = 0; i < 30; ++i) {
+        if ((i % 3) != 2) {
+            expectedOutgoing.emplace_back(connections[2 * i].get());
+            expectedIncoming.emplace_back(connections[2 * i + 1].get());
+        }
+    }
+    std::vector<const babelwires::ConnectionModifier*> actualOutgoing;
+    for (const auto& edge : graph.getOutgoingEdges(slots[0])) {
+        actualOutgoing.emplace_back(edge.m_connection);
+    }
+    std::vector<const babelwires::ConnectionModifier*> actualIncoming;
+    for (const auto& edge : graph.getIncomingEdges(slots[0])) {
+        actualIncoming.emplace_back(edge.m_connection);
+    }
+    EXPECT_EQ(actualOutgoing, expectedOutgoing);
+    EXPECT_EQ(actualIncoming, expectedIncoming);
+
+    graph.removeNode(slots[3]);
+    EXPECT_EQ(graph.getNode(slots[3]), nullptr);
+}
+
+TEST(NodeGraphTest, dependencyOrderAndLoops) {
+    testUtils::TestEnvironment testEnvironment;
+
+    std::vector<babelwires::Node*> nodes;
+    for (int i = 0; i < 5; ++i) {
+        const babelwires::NodeId id = testEnvironment.m_project.addNode(testDomain::TestComplexRecordElementData());
+        nodes.emplace_back(testEnvironment.m_project.getNode(id));
+    }
+
+    babelwires::NodeGraph graph;
+    std::vector<babelwires::NodeGraph::Slot> slots;
+    for (auto* node : nodes) {
+        slots.emplace_back(graph.addNode(node));
+    }
+
+    std::vector<std::unique_ptr<babelwires::ConnectionModifier>> connections;
+    const auto connect = [&](int source, int target) {
+        connections.emplace_back(createConnectionModifier(nodes[source]->getNodeId()));
+        graph.addConnection(slots[source], slots[target], connections.back().get());
+        graph.validate();
+        return connections.back().get();
+    };
+    const auto getPosition = [&](int i) {
+        const auto order = graph.getSlotsInDependencyOrder();
+        return std::find(order.begin(), order.end(), slots[i]) - order.begin();
+    };
+
+    // Connections against the initial order force the slots to be reordered.
+    connect(4, 3);
+    connect(3, 2);
+    connect(2, 1);
+    connect(0, 4);
+    EXPECT_LT(getPosition(0), getPosition(4));
+    EXPECT_LT(getPosition(4), getPosition(3));
+    EXPECT_LT(getPosition(3), getPosition(2));
+    EXPECT_LT(getPosition(2), getPosition(1));
+    EXPECT_TRUE(graph.getSlotsInDependencyLoops().empty());
+
+    // Close a loop through 3, 2 and 1. Nodes 0 and 4 are not on the loop.
+    babelwires::ConnectionModifier* const loopConnection = connect(1, 3);
+    EXPECT_EQ(graph.getSlotsInDependencyLoops(),
+              (std::vector<babelwires::NodeGraph::Slot>{slots[1], slots[2], slots[3]}));
+    const auto edges = graph.getOutgoingEdges(slots[1]);
+    ASSERT_EQ(edges.size(), 1);
+    EXPECT_TRUE(edges[0].m_closesLoop);
+
+    // A second loop sharing a node with the first.
+    babelwires::ConnectionModifier* const secondLoopConnection = connect(3, 4);
+    EXPECT_EQ(graph.getSlotsInDependencyLoops(),
+              (std::vector<babelwires::NodeGraph::Slot>{slots[1], slots[2], slots[3], slots[4]}));
+
+    // Breaking the first loop leaves the second.
+    graph.removeConnection(connections[2].get());
+    graph.validate();
+    EXPECT_EQ(graph.getSlotsInDependencyLoops(), (std::vector<babelwires::NodeGraph::Slot>{slots[3], slots[4]}));
+
+    // Once the second loop is broken, its closing connection can be ordered again.
+    graph.removeConnection(connections[0].get());
+    graph.validate();
+    EXPECT_TRUE(graph.getSlotsInDependencyLoops().empty());
+    for (const auto& edge : graph.getOutgoingEdges(slots[3])) {
+        EXPECT_FALSE(edge.m_closesLoop);
+    }
+    EXPECT_LT(getPosition(1), getPosition(3));
+    EXPECT_LT(getPosition(3), getPosition(4));
+    EXPECT_TRUE(graph.hasConnection(loopConnection));
+    EXPECT_TRUE(graph.hasConnection(secondLoopConnection));
+
+    // A connection from a node to itself is a loop.
+    connect(0, 0);
+    EXPECT_EQ(graph.getSlotsInDependencyLoops(), (std::vector<babelwires::NodeGraph::Slot>{slots[0]}));
+}
@@ -144,8 +144,56 @@ TEST(ParallelProcessorTest, noUnnecessaryWorkDone) {
     EXPECT_TRUE(findPath(testEnvironment.m_log.getLogContents(), *inputArray.getEntry(0)));
     EXPECT_FALSE(findPath(testEnvironment.m_log.getLogContents(), *inputArray.getEntry(1)));
 
-    // TODO: Adjusting the size of the array (or inserting / deleting elements) should also not trigger work,
-    // but this needs work.
+    // Growing the array only processes the new entry.
+    processor.getInput().clearChanges();
+    testEnvironment.m_log.clear();
+    inputArray.setSize(3);
+    inputArray.getEntry(2).set(9);
+    processor.process(testEnvironment.m_log);
+
+    EXPECT_EQ(outputArray.getSize(), 3);
+    EXPECT_EQ(outputArray.getEntry(0).get(), 4);
+    EXPECT_EQ(outputArray.getEntry(1).get(), 10);
+    EXPECT_EQ(outputArray.getEntry(2).get(), 13);
+
+    EXPECT_FALSE(findPath(testEnvironment.m_log.getLogContents(), *inputArray.getEntry(0)));
+    EXPECT_FALSE(findPath(testEnvironment.m_log.getLogContents(), *inputArray.getEntry(1)));
+    EXPECT_TRUE(findPath(testEnvironment.m_log.getLogContents(), *inputArray.getEntry(2)));
+
+    // Reordering the entries does not trigger work.
+    processor.getInput().clearChanges();
+    testEnvironment.m_log.clear();
+    inputArray.getEntry(0).set(9);
+    inputArray.getEntry(2).set(0);
+    processor.process(testEnvironment.m_log);
+
+    EXPECT_EQ(outputArray.getSize(), 3);
+    EXPECT_EQ(outputArray.getEntry(0).get(), 13);
+    EXPECT_EQ(outputArray.getEntry(1).get(), 10);
+    EXPECT_EQ(outputArray.getEntry(2).get(), 4);
+    EXPECT_EQ(testEnvironment.m_log.getLogContents(), "");
+
+    // Shrinking the array does not trigger work.
+    processor.getInput().clearChanges();
+    testEnvironment.m_log.clear();
+    inputArray.setSize(2);
+    processor.process(testEnvironment.m_log);
+
+    EXPECT_EQ(outputArray.getSize(), 2);
+    EXPECT_EQ(outputArray.getEntry(0).get(), 13);
+    EXPECT_EQ(outputArray.getEntry(1).get(), 10);
+    EXPECT_EQ(testEnvironment.m_log.getLogContents(), "");
+
+    // A change to the common input still processes every entry.
+    processor.getInput().clearChanges();
+    testEnvironment.m_log.clear();
+    intValueTreeNode.assertSetValue(babelwires::IntValue(1));
+    processor.process(testEnvironment.m_log);
+
+    EXPECT_EQ(outputArray.getEntry(0).get(), 10);
+    EXPECT_EQ(outputArray.getEntry(1).get(), 7);
+    EXPECT_TRUE(findPath(testEnvironment.m_log.getLogContents(), *inputArray.getEntry(0)));
+    EXPECT_TRUE(findPath(testEnvironment.m_log.getLogContents(), *inputArray.getEntry(1)));
 }
 
 TEST(ParallelProcessorTest, testFailure) {
@@ -187,3 +235,47 @@ TEST(ParallelProcessorTest, testFailure) {
     EXPECT_TRUE(findPath(result.error().toString(), *inputArray.getEntry(0)));
     EXPECT_FALSE(findPath(result.error().toString(), *inputArray.getEntry(1)));
 }
+
+TEST(ParallelProcessorTest, manyEntries) {
+    testUtils::TestEnvironment testEnvironment;
+
+    testDomain::TestParallelProcessor processor(testEnvironment.m_projectContext);
+    processor.getInput().setToDefault();
+    processor.getOutput().setToDefault();
+
+    babelwires::ValueTreeNode& input = processor.getInput();
+    const babelwires::ValueTreeNode& output = processor.getOutput();
+
+    babelwires::ValueTreeNode& intValueTreeNode =
+        processor.getInput().assertGetChildFromStep(babelwires::PathStep("intVal"));
+
+    babelwires::ArrayInstanceImpl<babelwires::ValueTreeNode, babelwires::IntType> inputArray(
+        input.assertGetChildFromStep(testDomain::TestParallelProcessor::getCommonArrayId()));
+    const babelwires::ArrayInstanceImpl<const babelwires::ValueTreeNode, babelwires::IntType> outputArray(
+        output.assertGetChildFromStep(testDomain::TestParallelProcessor::getCommonArrayId()));
+
+    // More entries than there are threads in the pool.
+    constexpr unsigned int numEntries = 100;
+
+    processor.getInput().clearChanges();
+    intValueTreeNode.assertSetValue(babelwires::IntValue(3));
+    inputArray.setSize(numEntries);
+    for (unsigned int i = 0; i < numEntries; ++i) {
+        inputArray.getEntry(i).set(static_cast<int>(i % 21) - 10);
+    }
+    EXPECT_TRUE(processor.process(testEnvironment.m_log));
+
+    ASSERT_EQ(outputArray.getSize(), numEntries);
+    for (unsigned int i = 0; i < numEntries; ++i) {
+        EXPECT_EQ(outputArray.getEntry(i).get(), static_cast<int>(i % 21) - 7);
+    }
+
+    // The entry roots from the first pass get reused.
+    processor.getInput().clearChanges();
+    intValueTreeNode.assertSetValue(babelwires::IntValue(-3));
+    EXPECT_TRUE(processor.process(testEnvironment.m_log));
+
+    for (unsigned int i = 0; i < numEntries; ++i) {
+        EXPECT_EQ(outputArray.getEntry(i).get(), static_cast<int>(i % 21) - 13);
+    }
+}
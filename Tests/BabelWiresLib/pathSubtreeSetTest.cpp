@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <BabelWiresLib/Path/pathSubtreeSet.hpp>
+
+#include <algorithm>
+
+namespace {
+    babelwires::Path makePath(const std::string& pathString) {
+        return *babelwires::Path::deserializeFromString(pathString);
+    }
+} // namespace
+
+TEST(PathSubtreeSetTest, addAndContains) {
+    babelwires::PathSubtreeSet set;
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_FALSE(set.contains(babelwires::Path()));
+
+    set.add(makePath("aa/1"));
+    EXPECT_FALSE(set.isEmpty());
+    EXPECT_TRUE(set.contains(makePath("aa/1")));
+    EXPECT_TRUE(set.contains(makePath("aa/1/bb")));
+    EXPECT_FALSE(set.contains(makePath("aa")));
+    EXPECT_FALSE(set.contains(makePath("aa/2")));
+    EXPECT_FALSE(set.contains(babelwires::Path()));
+
+    set.clear();
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_FALSE(set.contains(makePath("aa/1")));
+}
+
+TEST(PathSubtreeSetTest, nestedPaths) {
+    babelwires::PathSubtreeSet set;
+    set.add(makePath("aa/bb/cc"));
+    set.add(makePath("aa/bb/dd"));
+    set.add(makePath("ee"));
+
+    // Adding a path beneath one in the set has no effect.
+    set.add(makePath("ee/ff"));
+    EXPECT_EQ(set.getPaths(), (std::vector<babelwires::Path>{makePath("aa/bb/cc"), makePath("aa/bb/dd"), makePath("ee")}));
+
+    // Adding a path removes the paths beneath it.
+    set.add(makePath("aa"));
+    EXPECT_EQ(set.getPaths(), (std::vector<babelwires::Path>{makePath("aa"), makePath("ee")}));
+    EXPECT_TRUE(set.contains(makePath("aa/bb/zz")));
+
+    // The empty path covers everything.
+    set.add(babelwires::Path());
+    EXPECT_EQ(set.getPaths(), (std::vector<babelwires::Path>{babelwires::Path()}));
+    EXPECT_TRUE(set.contains(makePath("gg/3")));
+}
+
+TEST(PathSubtreeSetTest, pathOrder) {
+    babelwires::PathSubtreeSet set;
+    std::vector<babelwires::Path> paths;
+    for (int i = 0; i < 20; ++i) {
+        paths.emplace_back(makePath("aa/" + std::to_string((i * 7) % 20)));
+        set.add(paths.back());
+    }
+    std::sort(paths.begin(), paths.end());
+    EXPECT_EQ(set.getPaths(), paths);
+}
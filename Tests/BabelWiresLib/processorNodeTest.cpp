@@ -4,10 +4,12 @@
 #include <BabelWiresLib/Project/Nodes/ProcessorNode/processorNode.hpp>
 #include <BabelWiresLib/Project/Nodes/ProcessorNode/processorNodeData.hpp>
 #include <BabelWiresLib/Project/Nodes/node.hpp>
+#include <BabelWiresLib/Processors/processorResultCache.hpp>
 #include <BabelWiresLib/ValueTree/valueTreePathUtils.hpp>
 
 #include <BaseLib/Identifiers/identifierRegistry.hpp>
 
+#include <Domains/TestDomain/testParallelProcessor.hpp>
 #include <Domains/TestDomain/testProcessor.hpp>
 
 #include <Tests/BabelWiresLib/TestUtils/testEnvironment.hpp>
@@ -99,3 +101,67 @@ TEST(ProcessorNodeTest, sourceFileDataCreateElement) {
     EXPECT_TRUE(processorNode->isChanged(babelwires::Node::Changes::FeatureChangesMask));
     EXPECT_TRUE(processorNode->isChanged(babelwires::Node::Changes::SomethingChanged));
 }
+
+TEST(ProcessorNodeTest, resultCache) {
+    testUtils::TestEnvironment testEnvironment;
+    babelwires::ProcessorResultCache resultCache(1000);
+    testEnvironment.m_projectContext.registerService<babelwires::ProcessorResultCache>(resultCache);
+
+    babelwires::ProcessorNodeData data;
+    data.m_factoryIdentifier = testDomain::TestParallelProcessor::getFactoryIdentifier();
+    data.m_factoryVersion = 1;
+
+    auto node = data.createNode(testEnvironment.m_projectContext, testEnvironment.m_log, 10);
+    ASSERT_TRUE(node);
+    ASSERT_FALSE(node->isFailed());
+    babelwires::ProcessorNode* processorNode = static_cast<babelwires::ProcessorNode*>(node.get());
+
+    const babelwires::ValueTreeNode& input = *processorNode->getInput();
+    const babelwires::ValueTreeNode& output = *processorNode->getOutput();
+    const babelwires::ValueTreeNode& inputArray =
+        input.getChild(input.getNumChildren() - 1)->as<babelwires::ValueTreeNode>();
+    const babelwires::ValueTreeNode& inputEntry = inputArray.getChild(0)->as<babelwires::ValueTreeNode>();
+    const babelwires::ValueTreeNode& outputEntry =
+        output.getChild(0)->as<babelwires::ValueTreeNode>().getChild(0)->as<babelwires::ValueTreeNode>();
+    const babelwires::Path pathToIntVal = babelwires::getPathTo(&input.getChild(0)->as<babelwires::ValueTreeNode>());
+    const babelwires::Path pathToEntry = babelwires::getPathTo(&inputEntry);
+
+    const auto setValue = [&](const babelwires::Path& path, int value) {
+        babelwires::ValueAssignmentData assignmentData(babelwires::IntValue{value});
+        assignmentData.m_targetPath = path;
+        processorNode->clearChanges();
+        testEnvironment.m_log.clear();
+        if (processorNode->findModifier(path)) {
+            processorNode->removeModifier(processorNode->findModifier(path));
+        }
+        processorNode->addModifier(testEnvironment.m_log, assignmentData);
+        processorNode->process(testEnvironment.m_project, testEnvironment.m_log);
+    };
+    const auto wasProcessed = [&]() {
+        std::ostringstream pathStream;
+        pathStream << pathToEntry;
+        return testEnvironment.m_log.getLogContents().find(pathStream.str()) != std::string::npos;
+    };
+    const auto getOutput = [&]() { return outputEntry.getValue()->as<babelwires::IntValue>().get(); };
+
+    setValue(pathToIntVal, 1);
+    EXPECT_TRUE(wasProcessed());
+    EXPECT_EQ(getOutput(), 1);
+
+    setValue(pathToIntVal, 2);
+    EXPECT_TRUE(wasProcessed());
+    EXPECT_EQ(getOutput(), 2);
+    EXPECT_EQ(resultCache.getNumEntries(), 2);
+
+    // Returning to an earlier input uses the cached output.
+    setValue(pathToIntVal, 1);
+    EXPECT_FALSE(wasProcessed());
+    EXPECT_EQ(getOutput(), 1);
+    EXPECT_TRUE(processorNode->isChanged(babelwires::Node::Changes::FeatureValueChanged));
+
+    // Later processing builds correctly on the restored output.
+    setValue(pathToEntry, 5);
+    EXPECT_TRUE(wasProcessed());
+    EXPECT_EQ(getOutput(), 6);
+    EXPECT_EQ(resultCache.getNumEntries(), 3);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <BabelWiresLib/Processors/processorResultCache.hpp>
+#include <BabelWiresLib/Types/Int/intValue.hpp>
+
+#include <Tests/TestUtils/testIdentifiers.hpp>
+
+namespace {
+    babelwires::LongId getFactoryIdentifier() {
+        return testUtils::getTestRegisteredLongIdentifier("factory", 1);
+    }
+
+    babelwires::LongId getOtherFactoryIdentifier() {
+        return testUtils::getTestRegisteredLongIdentifier("other", 2);
+    }
+} // namespace
+
+TEST(ProcessorResultCacheTest, findAndInsert) {
+    babelwires::ProcessorResultCache cache(8);
+
+    const babelwires::ValueHolder input = babelwires::IntValue(3);
+    const babelwires::ValueHolder output = babelwires::IntValue(6);
+
+    EXPECT_FALSE(cache.find(getFactoryIdentifier(), 1, input));
+
+    cache.insert(getFactoryIdentifier(), 1, input, output, 1);
+    EXPECT_EQ(cache.getNumEntries(), 1);
+
+    // The input is compared by value.
+    const babelwires::ValueHolder equalInput = babelwires::IntValue(3);
+    const babelwires::ValueHolder found = cache.find(getFactoryIdentifier(), 1, equalInput);
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found, output);
+
+    // The factory and its version are part of the key.
+    EXPECT_FALSE(cache.find(getFactoryIdentifier(), 2, input));
+    EXPECT_FALSE(cache.find(getOtherFactoryIdentifier(), 1, input));
+    EXPECT_FALSE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(4)));
+
+    // Inserting with the same key replaces the output.
+    const babelwires::ValueHolder newOutput = babelwires::IntValue(7);
+    cache.insert(getFactoryIdentifier(), 1, input, newOutput, 2);
+    EXPECT_EQ(cache.getNumEntries(), 1);
+    EXPECT_EQ(cache.find(getFactoryIdentifier(), 1, input), newOutput);
+    EXPECT_EQ(cache.getTotalSize(), 2);
+
+    cache.clear();
+    EXPECT_EQ(cache.getNumEntries(), 0);
+    EXPECT_EQ(cache.getTotalSize(), 0);
+    EXPECT_FALSE(cache.find(getFactoryIdentifier(), 1, input));
+}
+
+TEST(ProcessorResultCacheTest, leastRecentlyUsedIsDiscarded) {
+    babelwires::ProcessorResultCache cache(3);
+
+    for (int i = 0; i < 3; ++i) {
+        cache.insert(getFactoryIdentifier(), 1, babelwires::IntValue(i), babelwires::IntValue(i * 10), 1);
+    }
+    EXPECT_EQ(cache.getNumEntries(), 3);
+
+    // Use the oldest entry, so the second is now the least recently used.
+    EXPECT_TRUE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(0)));
+
+    cache.insert(getFactoryIdentifier(), 1, babelwires::IntValue(3), babelwires::IntValue(30), 1);
+    EXPECT_EQ(cache.getNumEntries(), 3);
+    EXPECT_TRUE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(0)));
+    EXPECT_FALSE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(1)));
+    EXPECT_TRUE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(2)));
+    EXPECT_TRUE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(3)));
+}
+
+TEST(ProcessorResultCacheTest, budgetIsBySize) {
+    babelwires::ProcessorResultCache cache(10);
+
+    for (int i = 0; i < 3; ++i) {
+        cache.insert(getFactoryIdentifier(), 1, babelwires::IntValue(i), babelwires::IntValue(i * 10), 3);
+    }
+    EXPECT_EQ(cache.getNumEntries(), 3);
+    EXPECT_EQ(cache.getTotalSize(), 9);
+
+    // A large entry displaces as many of the least recently used entries as necessary.
+    cache.insert(getFactoryIdentifier(), 1, babelwires::IntValue(3), babelwires::IntValue(30), 7);
+    EXPECT_EQ(cache.getNumEntries(), 2);
+    EXPECT_EQ(cache.getTotalSize(), 10);
+    EXPECT_FALSE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(0)));
+    EXPECT_FALSE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(1)));
+    EXPECT_TRUE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(2)));
+    EXPECT_TRUE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(3)));
+
+    // An entry larger than the whole budget is not stored, and does not displace anything.
+    cache.insert(getFactoryIdentifier(), 1, babelwires::IntValue(4), babelwires::IntValue(40), 11);
+    EXPECT_EQ(cache.getNumEntries(), 2);
+    EXPECT_FALSE(cache.find(getFactoryIdentifier(), 1, babelwires::IntValue(4)));
+}
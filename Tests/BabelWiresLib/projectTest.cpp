@@ -695,6 +695,46 @@ TEST(ProjectTest, dependencyLoopAndProcessing) {
     EXPECT_FALSE(node4->isInDependencyLoop());
 }
 
+// Check that only the nodes on a dependency loop are flagged, and not the nodes downstream of it.
+TEST(ProjectTest, dependencyLoopDownstream) {
+    testUtils::TestEnvironment testEnvironment;
+
+    testDomain::TestComplexRecordElementData elementData;
+
+    const babelwires::NodeId nodeId1 = testEnvironment.m_project.addNode(elementData);
+    const babelwires::NodeId nodeId2 = testEnvironment.m_project.addNode(elementData);
+    const babelwires::NodeId nodeId3 = testEnvironment.m_project.addNode(elementData);
+
+    const babelwires::Node* node1 = testEnvironment.m_project.getNode(nodeId1);
+    const babelwires::Node* node2 = testEnvironment.m_project.getNode(nodeId2);
+    const babelwires::Node* node3 = testEnvironment.m_project.getNode(nodeId3);
+
+    const auto connect = [&](babelwires::NodeId sourceId, babelwires::NodeId targetId) {
+        babelwires::ConnectionModifierData modData;
+        modData.m_targetPath = elementData.getPathToRecordInt0();
+        modData.m_sourceId = sourceId;
+        modData.m_sourcePath = elementData.getPathToRecordInt0();
+        testEnvironment.m_project.addModifier(targetId, modData);
+    };
+
+    connect(nodeId1, nodeId3);
+    connect(nodeId1, nodeId2);
+    connect(nodeId2, nodeId1);
+    testEnvironment.m_project.process();
+
+    EXPECT_TRUE(node1->isInDependencyLoop());
+    EXPECT_TRUE(node2->isInDependencyLoop());
+    EXPECT_FALSE(node3->isInDependencyLoop());
+    EXPECT_FALSE(node3->isFailed());
+
+    testEnvironment.m_project.removeModifier(nodeId1, elementData.getPathToRecordInt0());
+    testEnvironment.m_project.process();
+
+    EXPECT_FALSE(node1->isInDependencyLoop());
+    EXPECT_FALSE(node2->isInDependencyLoop());
+    EXPECT_FALSE(node3->isInDependencyLoop());
+}
+
 TEST(ProjectTest, updateWithAvailableIds) {
     testUtils::TestEnvironment testEnvironment;
 
@@ -475,6 +475,33 @@ TEST(RecordTypeTest, featureChanges) {
     EXPECT_FALSE(valueFeature.isChanged(babelwires::ValueTreeNode::Changes::ValueChanged));
 }
 
+TEST(RecordTypeTest, instanceFieldsWhenOptionalsChange) {
+    testUtils::TestEnvironment testEnvironment;
+
+    babelwires::ValueTreeRoot valueFeature(testEnvironment.m_typeSystem,
+                                           testEnvironment.m_typeSystem.getRegisteredType<testDomain::TestComplexRecordType>());
+    valueFeature.setToDefault();
+
+    testDomain::TestComplexRecordType::Instance instance(valueFeature);
+    instance.getintR1().set(5);
+    EXPECT_EQ(instance.getintR1().get(), 5);
+    EXPECT_FALSE(instance.tryGetopInt());
+
+    // Activating an optional which precedes intR1 changes the child index of intR1.
+    instance.activateAndGetopInt().set(3);
+    EXPECT_EQ(instance.getintR1().get(), 5);
+    EXPECT_EQ(instance.getopInt().get(), 3);
+    ASSERT_TRUE(instance.tryGetopInt());
+    EXPECT_EQ(instance.tryGetopInt()->get(), 3);
+
+    instance.deactivateopInt();
+    EXPECT_EQ(instance.getintR1().get(), 5);
+    EXPECT_FALSE(instance.tryGetopInt());
+
+    instance.getintR1().set(6);
+    EXPECT_EQ(instance.getintR1().get(), 6);
+}
+
 TEST(RecordTypeTest, valueEquality) {
     testUtils::TestEnvironment testEnvironment;
     testDomain::TestComplexRecordType recordType(testEnvironment.m_typeSystem);
@@ -580,6 +607,64 @@ TEST(RecordTypeTest, constructorWithOptionals) {
     EXPECT_EQ(recordType.getFields()[1].m_optionality, babelwires::RecordType::Optionality::optionalDefaultInactive);
 }
 
+TEST(RecordTypeTest, childIndicesOfValueViewedByTwoTypes) {
+    testUtils::TestEnvironment testEnvironment;
+
+    const babelwires::ShortId int0Id = testUtils::getTestRegisteredIdentifier("int0");
+    const babelwires::ShortId str0Id = testUtils::getTestRegisteredIdentifier("str0");
+    const babelwires::ShortId str1Id = testUtils::getTestRegisteredIdentifier("str1");
+
+    // The same fields in a different order.
+    babelwires::TypeExp recordTypeExpA(
+        babelwires::RecordTypeConstructor::getThisIdentifier(),
+        babelwires::TypeConstructorArguments{
+            {babelwires::DefaultIntType::getThisIdentifier(), babelwires::StringType::getThisIdentifier(),
+             babelwires::StringType::getThisIdentifier()},
+            {babelwires::FieldIdValue(int0Id),
+             babelwires::FieldIdValue(str0Id, babelwires::RecordType::Optionality::optionalDefaultInactive),
+             babelwires::FieldIdValue(str1Id, babelwires::RecordType::Optionality::optionalDefaultActive)}});
+    babelwires::TypeExp recordTypeExpB(
+        babelwires::RecordTypeConstructor::getThisIdentifier(),
+        babelwires::TypeConstructorArguments{
+            {babelwires::StringType::getThisIdentifier(), babelwires::StringType::getThisIdentifier(),
+             babelwires::DefaultIntType::getThisIdentifier()},
+            {babelwires::FieldIdValue(str1Id, babelwires::RecordType::Optionality::optionalDefaultActive),
+             babelwires::FieldIdValue(str0Id, babelwires::RecordType::Optionality::optionalDefaultInactive),
+             babelwires::FieldIdValue(int0Id)}});
+
+    babelwires::TypePtr typeA = recordTypeExpA.assertResolve(testEnvironment.m_typeSystem);
+    babelwires::TypePtr typeB = recordTypeExpB.assertResolve(testEnvironment.m_typeSystem);
+    const babelwires::RecordType& recordTypeA = typeA->as<babelwires::RecordType>();
+    const babelwires::RecordType& recordTypeB = typeB->as<babelwires::RecordType>();
+
+    babelwires::ValueHolder value = recordTypeA.createValue(testEnvironment.m_typeSystem);
+
+    // Alternate between the types, so each has to cope with the other's cached index.
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(recordTypeA.getNumChildren(value), 2);
+        EXPECT_EQ(recordTypeB.getNumChildren(value), 2);
+        EXPECT_EQ(recordTypeA.getChildIndexFromStep(value, babelwires::PathStep(int0Id)), 0);
+        EXPECT_EQ(recordTypeA.getChildIndexFromStep(value, babelwires::PathStep(str0Id)), -1);
+        EXPECT_EQ(recordTypeA.getChildIndexFromStep(value, babelwires::PathStep(str1Id)), 1);
+        EXPECT_EQ(recordTypeB.getChildIndexFromStep(value, babelwires::PathStep(str1Id)), 0);
+        EXPECT_EQ(recordTypeB.getChildIndexFromStep(value, babelwires::PathStep(str0Id)), -1);
+        EXPECT_EQ(recordTypeB.getChildIndexFromStep(value, babelwires::PathStep(int0Id)), 1);
+        EXPECT_EQ(std::get<1>(recordTypeA.getChild(value, 1)), babelwires::PathStep(str1Id));
+        EXPECT_EQ(std::get<1>(recordTypeB.getChild(value, 1)), babelwires::PathStep(int0Id));
+    }
+
+    recordTypeB.activateField(testEnvironment.m_typeSystem, value, str0Id);
+
+    EXPECT_EQ(recordTypeA.getNumChildren(value), 3);
+    EXPECT_EQ(recordTypeB.getNumChildren(value), 3);
+    EXPECT_EQ(recordTypeA.getChildIndexFromStep(value, babelwires::PathStep(str0Id)), 1);
+    EXPECT_EQ(recordTypeA.getChildIndexFromStep(value, babelwires::PathStep(str1Id)), 2);
+    EXPECT_EQ(recordTypeB.getChildIndexFromStep(value, babelwires::PathStep(str0Id)), 1);
+    EXPECT_EQ(recordTypeB.getChildIndexFromStep(value, babelwires::PathStep(int0Id)), 2);
+    EXPECT_EQ(std::get<1>(recordTypeA.getChild(value, 1)), babelwires::PathStep(str0Id));
+    EXPECT_EQ(std::get<1>(recordTypeB.getChild(value, 2)), babelwires::PathStep(int0Id));
+}
+
 TEST(RecordTypeTest, constructorBadArgs) {
     testUtils::TestEnvironment testEnvironment;
 
@@ -478,3 +478,44 @@ TEST(RecordWithVariantsTypeTest, valueHash) {
     EXPECT_NE(hash0, hash2);
     EXPECT_NE(hash1, hash2);
 }
+
+TEST(RecordWithVariantsTypeTest, getChildIndexFromStepInEachVariant) {
+    testUtils::TestEnvironment testEnvironment;
+    testDomain::TestRecordWithVariantsType recordType(testEnvironment.m_typeSystem);
+
+    babelwires::ValueHolder value = recordType.createValue(testEnvironment.m_typeSystem);
+
+    for (auto tag : recordType.getTags()) {
+        ASSERT_TRUE(recordType.selectTag(testEnvironment.m_typeSystem, value, tag));
+        for (unsigned int i = 0; i < recordType.getNumChildren(value); ++i) {
+            const babelwires::PathStep step = std::get<1>(recordType.getChild(value, i));
+            EXPECT_EQ(recordType.getChildIndexFromStep(value, step), i);
+        }
+    }
+
+    ASSERT_TRUE(recordType.selectTag(testEnvironment.m_typeSystem, value, testDomain::TestRecordWithVariantsType::getTagCId()));
+    EXPECT_EQ(recordType.getChildIndexFromStep(
+                  value, babelwires::PathStep(testDomain::TestRecordWithVariantsType::getFieldA0Id())),
+              -1);
+    EXPECT_EQ(recordType.getChildIndexFromStep(value, babelwires::PathStep(babelwires::ShortId("Foo"))), -1);
+    EXPECT_EQ(recordType.getChildIndexFromStep(value, babelwires::PathStep(babelwires::ArrayIndex(0))), -1);
+}
+
+TEST(RecordWithVariantsTypeTest, sharedFieldsCarriedOverWhenTagChanges) {
+    testUtils::TestEnvironment testEnvironment;
+    testDomain::TestRecordWithVariantsType recordType(testEnvironment.m_typeSystem);
+
+    babelwires::ValueHolder value = recordType.createValue(testEnvironment.m_typeSystem);
+    EXPECT_EQ(recordType.getSelectedTag(value), testDomain::TestRecordWithVariantsType::getTagBId());
+
+    const auto& valueB = value->as<babelwires::RecordWithVariantsValue>();
+    const babelwires::ValueHolder ff0 = valueB.getValue(testDomain::TestRecordWithVariantsType::getFf0Id());
+    const babelwires::ValueHolder fieldAB = valueB.getValue(testDomain::TestRecordWithVariantsType::getFieldABId());
+
+    ASSERT_TRUE(recordType.selectTag(testEnvironment.m_typeSystem, value, testDomain::TestRecordWithVariantsType::getTagAId()));
+
+    // Fields in both variants are not recreated.
+    const auto& valueA = value->as<babelwires::RecordWithVariantsValue>();
+    EXPECT_EQ(&*valueA.getValue(testDomain::TestRecordWithVariantsType::getFf0Id()), &*ff0);
+    EXPECT_EQ(&*valueA.getValue(testDomain::TestRecordWithVariantsType::getFieldABId()), &*fieldAB);
+}
@@ -20,6 +20,32 @@ TEST(StringValueTest, basics) {
     EXPECT_EQ(stringValue2.get(), "Goodbye");
 }
 
+TEST(StringValueTest, getView) {
+    babelwires::StringValue stringValue;
+    EXPECT_TRUE(stringValue.getView().empty());
+
+    stringValue.set("Hello");
+    EXPECT_EQ(stringValue.getView(), "Hello");
+
+    stringValue.set(std::string());
+    EXPECT_TRUE(stringValue.getView().empty());
+}
+
+TEST(StringValueTest, copiesShareBuffer) {
+    babelwires::StringValue stringValue("Shared");
+    babelwires::StringValue stringValue2 = stringValue;
+    EXPECT_EQ(stringValue.getView().data(), stringValue2.getView().data());
+
+    // Setting the same contents does not replace the buffer.
+    stringValue2.set("Shared");
+    EXPECT_EQ(stringValue.getView().data(), stringValue2.getView().data());
+
+    stringValue2.set("Different");
+    EXPECT_NE(stringValue.getView().data(), stringValue2.getView().data());
+    EXPECT_EQ(stringValue.getView(), "Shared");
+    EXPECT_EQ(stringValue2.getView(), "Different");
+}
+
 TEST(StringValueTest, serialization) {
     std::string serializedContents;
     {
@@ -52,6 +78,7 @@ TEST(StringValueTest, clone) {
     auto clone = stringValue.clone();
     ASSERT_NE(clone, nullptr);
     EXPECT_EQ(clone->get(), "Plop");  
+    EXPECT_EQ(clone->getView().data(), stringValue.getView().data());
 }
 
 TEST(StringValueTest, visitors) {
@@ -2,6 +2,7 @@
 
 #include <BabelWiresLib/TypeSystem/registeredType.hpp>
 #include <BabelWiresLib/Types/Int/intType.hpp>
+#include <BabelWiresLib/Types/Int/intTypeConstructor.hpp>
 #include <BabelWiresLib/Types/Int/intValue.hpp>
 #include <BabelWiresLib/Types/Rational/rationalType.hpp>
 #include <BabelWiresLib/Types/Rational/rationalValue.hpp>
@@ -63,6 +64,61 @@ TEST(SumTypeTest, sumTypeDefault1) {
     EXPECT_TRUE(sumType.isValidValue(testEnvironment.m_typeSystem, *intValue));
 }
 
+TEST(SumTypeTest, getIndexOfValueAfterValueChanges) {
+    testUtils::TestEnvironment testEnvironment;
+
+    babelwires::TypeExp sumTypeExp(
+        babelwires::SumTypeConstructor::getThisIdentifier(),
+        babelwires::TypeExp(babelwires::IntTypeConstructor::getThisIdentifier(), babelwires::IntValue(0),
+                            babelwires::IntValue(10), babelwires::IntValue(0)),
+        babelwires::TypeExp(babelwires::IntTypeConstructor::getThisIdentifier(), babelwires::IntValue(20),
+                            babelwires::IntValue(30), babelwires::IntValue(20)));
+
+    const babelwires::TypePtr type = sumTypeExp.assertResolve(testEnvironment.m_typeSystem);
+    const babelwires::SumType& sumType = type->as<babelwires::SumType>();
+
+    // The same object is queried each time, and the index follows its contents.
+    babelwires::IntValue value(5);
+    EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, value), 0);
+    EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, value), 0);
+    value.set(25);
+    EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, value), 1);
+    value.set(15);
+    EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, value), -1);
+    EXPECT_FALSE(sumType.isValidValue(testEnvironment.m_typeSystem, value));
+    value.set(10);
+    EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, value), 0);
+}
+
+TEST(SumTypeTest, getIndexOfHeldValues) {
+    testUtils::TestEnvironment testEnvironment;
+
+    babelwires::TypeExp sumTypeExp(
+        babelwires::SumTypeConstructor::getThisIdentifier(),
+        babelwires::TypeExp(babelwires::IntTypeConstructor::getThisIdentifier(), babelwires::IntValue(0),
+                            babelwires::IntValue(10), babelwires::IntValue(0)),
+        babelwires::TypeExp(babelwires::IntTypeConstructor::getThisIdentifier(), babelwires::IntValue(20),
+                            babelwires::IntValue(30), babelwires::IntValue(20)));
+
+    const babelwires::TypePtr type = sumTypeExp.assertResolve(testEnvironment.m_typeSystem);
+    const babelwires::SumType& sumType = type->as<babelwires::SumType>();
+
+    // Held values are cached, and a value allocated where a destroyed value was must not pick up its index.
+    for (int i = 0; i < 10; ++i) {
+        const int intValue = (i % 2) ? 25 : 5;
+        const babelwires::ValueHolder value = babelwires::IntValue(intValue);
+        EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, *value), i % 2);
+        EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, *value), i % 2);
+        EXPECT_EQ(sumType.valueToString(testEnvironment.m_typeSystem, value), std::to_string(intValue));
+    }
+
+    // A copy of a held value is a different value.
+    babelwires::ValueHolder value = babelwires::IntValue(5);
+    EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, *value), 0);
+    value.copyContentsAndGetNonConst().as<babelwires::IntValue>().set(25);
+    EXPECT_EQ(sumType.getIndexOfValue(testEnvironment.m_typeSystem, *value), 1);
+}
+
 TEST(SumTypeTest, sumTypeConstructorNoDefaultIndex) {
     testUtils::TestEnvironment testEnvironment;
 
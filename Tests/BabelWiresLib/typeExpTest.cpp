@@ -79,6 +79,29 @@ TEST(TypeExpTest, equality) {
     EXPECT_NE(constructedTypeExpValue1, constructedTypeExpMixed1);
 }
 
+TEST(TypeExpTest, equalityOfIndependentlyConstructedTypeExps) {
+    const auto makeTypeExp = [](babelwires::RegisteredTypeId argId) {
+        return babelwires::TypeExp(
+            testUtils::getTestRegisteredMediumIdentifier("Foo", 2),
+            babelwires::TypeConstructorArguments{
+                {babelwires::TypeExp(testUtils::getTestRegisteredMediumIdentifier("Flerm", 1), argId)},
+                {babelwires::IntValue(16), babelwires::StringValue("Erm")}});
+    };
+
+    const babelwires::TypeExp typeExp1 = makeTypeExp(testUtils::getTestRegisteredMediumIdentifier("Bar", 4));
+    const babelwires::TypeExp typeExp2 = makeTypeExp(testUtils::getTestRegisteredMediumIdentifier("Bar", 4));
+    const babelwires::TypeExp typeExp3 = makeTypeExp(testUtils::getTestRegisteredMediumIdentifier("Bar", 5));
+    // An identifier without a discriminator is equal to the same identifier with any discriminator.
+    const babelwires::TypeExp typeExp4 = makeTypeExp(babelwires::RegisteredTypeId("Bar"));
+
+    EXPECT_EQ(typeExp1, typeExp2);
+    EXPECT_EQ(typeExp1.getHash(), typeExp2.getHash());
+    EXPECT_NE(typeExp1, typeExp3);
+    EXPECT_EQ(typeExp1, typeExp4);
+    EXPECT_EQ(typeExp3, typeExp4);
+    EXPECT_EQ(typeExp1.getHash(), typeExp4.getHash());
+}
+
 TEST(TypeExpTest, resolve) {
     babelwires::IdentifierRegistryScope identifierRegistry;
     babelwires::TypeSystem typeSystem;
@@ -116,6 +139,38 @@ TEST(TypeExpTest, tryResolveSuccess) {
     EXPECT_EQ(constructedTypeExp.tryResolve(typeSystem).get(), constructedTypeExp.tryResolve(typeSystem).get());
 }
 
+TEST(TypeExpTest, typeConstructorCacheStatistics) {
+    babelwires::IdentifierRegistryScope identifierRegistry;
+    babelwires::TypeSystem typeSystem;
+
+    typeSystem.addType<testUtils::TestType>();
+    const testUtils::TestUnaryTypeConstructor* unaryConstructor =
+        typeSystem.addTypeConstructor<testUtils::TestUnaryTypeConstructor>();
+
+    babelwires::TypeExp constructedTypeExp(testUtils::TestUnaryTypeConstructor::getThisIdentifier(),
+                                           testUtils::TestType::getThisIdentifier());
+
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numConstructed, 0);
+
+    babelwires::TypePtr newType = constructedTypeExp.tryResolve(typeSystem);
+    ASSERT_NE(newType, nullptr);
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numConstructed, 1);
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numCached, 0);
+
+    EXPECT_EQ(constructedTypeExp.tryResolve(typeSystem), newType);
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numConstructed, 1);
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numCached, 1);
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numExpired, 0);
+
+    // The cache only holds weak references, so the type gets reconstructed once it has been released.
+    newType.reset();
+    newType = constructedTypeExp.tryResolve(typeSystem);
+    ASSERT_NE(newType, nullptr);
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numConstructed, 2);
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numCached, 1);
+    EXPECT_EQ(unaryConstructor->getCacheStatistics().m_numExpired, 1);
+}
+
 // std::execution::par not currently supported on MacOs.
 #ifndef __APPLE__
 
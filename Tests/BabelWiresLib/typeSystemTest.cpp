@@ -62,6 +62,70 @@ TEST(TypeSystemTest, compareSubtype) {
     EXPECT_EQ(testEnvironment.m_typeSystem.compareSubtype(*testType6, *testEnum), babelwires::SubtypeOrder::IsDisjoint);
 }
 
+TEST(TypeSystemTest, compareSubtypeCache) {
+    testUtils::TestEnvironment testEnvironment;
+    const babelwires::TypeSystem& typeSystem = testEnvironment.m_typeSystem;
+
+    const babelwires::TypeExp testType4Exp(testUtils::TestMixedTypeConstructor::getThisIdentifier(), babelwires::TypeConstructorArguments{{testUtils::TestType::getThisIdentifier()}, {babelwires::StringValue("xxxx")}});
+    const babelwires::TypeExp testType6Exp(testUtils::TestMixedTypeConstructor::getThisIdentifier(), babelwires::TypeConstructorArguments{{testUtils::TestType::getThisIdentifier()}, {babelwires::StringValue("xxxxxx")}});
+
+    babelwires::TypePtr testType4 = testType4Exp.assertResolve(typeSystem);
+    const babelwires::TypePtr testType6 = testType6Exp.assertResolve(typeSystem);
+
+    const auto statistics0 = typeSystem.getSubtypeCacheStatistics();
+
+    EXPECT_EQ(typeSystem.compareSubtype(*testType4, *testType6), babelwires::SubtypeOrder::IsSubtype);
+    const auto statistics1 = typeSystem.getSubtypeCacheStatistics();
+    EXPECT_EQ(statistics1.m_numMisses, statistics0.m_numMisses + 1);
+    EXPECT_EQ(statistics1.m_numHits, statistics0.m_numHits);
+    EXPECT_GT(statistics1.m_numEntries, statistics0.m_numEntries);
+
+    // Both directions are now cached.
+    EXPECT_EQ(typeSystem.compareSubtype(*testType4, *testType6), babelwires::SubtypeOrder::IsSubtype);
+    EXPECT_EQ(typeSystem.compareSubtype(*testType6, *testType4), babelwires::SubtypeOrder::IsSupertype);
+    const auto statistics2 = typeSystem.getSubtypeCacheStatistics();
+    EXPECT_EQ(statistics2.m_numMisses, statistics1.m_numMisses);
+    EXPECT_EQ(statistics2.m_numHits, statistics1.m_numHits + 2);
+
+    // A reconstructed type is a new type as far as the cache is concerned.
+    const babelwires::Type::SerialNumber serialNumber4 = testType4->getSerialNumber();
+    testType4.reset();
+    testType4 = testType4Exp.assertResolve(typeSystem);
+    EXPECT_NE(testType4->getSerialNumber(), serialNumber4);
+    EXPECT_EQ(typeSystem.compareSubtype(*testType4, *testType6), babelwires::SubtypeOrder::IsSubtype);
+    const auto statistics3 = typeSystem.getSubtypeCacheStatistics();
+    EXPECT_EQ(statistics3.m_numMisses, statistics2.m_numMisses + 1);
+}
+
+TEST(TypeSystemTest, compareSubtypeCacheIsBounded) {
+    babelwires::TypeSystem typeSystem(8);
+
+    // Constructed types are created and destroyed, and their serial numbers are never reused.
+    const babelwires::TypePtr base = babelwires::makeType<testUtils::TestType>(10);
+    // A maximum length of 0 means unbounded, so start at 1.
+    for (unsigned int i = 1; i <= 100; ++i) {
+        const babelwires::TypePtr type = babelwires::makeType<testUtils::TestType>(i);
+        EXPECT_EQ(typeSystem.compareSubtype(*type, *base), (i < 10)    ? babelwires::SubtypeOrder::IsSubtype
+                                                           : (i == 10) ? babelwires::SubtypeOrder::IsEquivalent
+                                                                       : babelwires::SubtypeOrder::IsSupertype);
+    }
+    const auto statistics = typeSystem.getSubtypeCacheStatistics();
+    EXPECT_EQ(statistics.m_maximumNumEntries, 8);
+    EXPECT_LE(statistics.m_numEntries, 8);
+    EXPECT_EQ(statistics.m_numMisses, 100);
+
+    // Entries which are in use are kept in preference to others.
+    const babelwires::TypePtr inUse = babelwires::makeType<testUtils::TestType>(5);
+    EXPECT_EQ(typeSystem.compareSubtype(*inUse, *base), babelwires::SubtypeOrder::IsSubtype);
+    EXPECT_EQ(typeSystem.compareSubtype(*inUse, *base), babelwires::SubtypeOrder::IsSubtype);
+    for (unsigned int i = 1; i <= 20; ++i) {
+        const babelwires::TypePtr type = babelwires::makeType<testUtils::TestType>(i);
+        typeSystem.compareSubtype(*type, *base);
+        EXPECT_EQ(typeSystem.compareSubtype(*inUse, *base), babelwires::SubtypeOrder::IsSubtype);
+    }
+    EXPECT_EQ(typeSystem.getSubtypeCacheStatistics().m_numMisses, 121);
+}
+
 TEST(TypeSystemTest, isRelatedTypes) {
     testUtils::TestEnvironment testEnvironment;
 
@@ -14,6 +14,10 @@
 
 #include <Tests/TestUtils/testLog.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 TEST(ValueTreeNodePathTest, pathConstructFromSteps) {
     std::vector<babelwires::PathStep> steps = {*babelwires::PathStep::deserializeFromString("Hello'2"), 13,
                                                *babelwires::PathStep::deserializeFromString("Hello'3"),
@@ -264,8 +268,12 @@ TEST(ValueTreeNodePathTest, pathSerialization) {
 
     EXPECT_EQ(path.serializeToString(), "Forb/Erm/12");
 
-    path.getStep(0).getField().setDiscriminator(2);
-    path.getStep(1).getField().setDiscriminator(4);
+    babelwires::ShortId forb("Forb");
+    forb.setDiscriminator(2);
+    path.setStep(0, forb);
+    babelwires::ShortId erm("Erm");
+    erm.setDiscriminator(4);
+    path.setStep(1, erm);
 
     EXPECT_EQ(path.serializeToString(), "Forb'2/Erm'4/12");
 }
@@ -341,3 +349,136 @@ TEST(ValueTreeNodePathTest, pathHash) {
     EXPECT_EQ(hashWithOne, hashWithOneAgain);
     EXPECT_NE(hashWithOneHello, hashWithOneByebye);
 }
+
+TEST(ValueTreeNodePathTest, pathsSharingSteps) {
+    babelwires::Path path0(
+        std::vector<babelwires::PathStep>{*babelwires::PathStep::deserializeFromString("Hello'2"), 13,
+                                          *babelwires::PathStep::deserializeFromString("World'1")});
+    // Paths which differ only by discriminators are equal, but keep their own discriminators.
+    babelwires::Path path1(std::vector<babelwires::PathStep>{babelwires::PathStep("Hello"), 13,
+                                                             babelwires::PathStep("World")});
+    EXPECT_EQ(path0, path1);
+    EXPECT_EQ(path0.getHash(), path1.getHash());
+    EXPECT_FALSE(path0 < path1);
+    EXPECT_FALSE(path1 < path0);
+    EXPECT_EQ(path0.getStep(0).getField().getDiscriminator(), 2);
+    EXPECT_EQ(path1.getStep(0).getField().getDiscriminator(), 0);
+
+    // Paths built independently from the same steps behave like copies.
+    babelwires::Path path2;
+    path2.pushStep(*babelwires::PathStep::deserializeFromString("Hello'2"));
+    path2.pushStep(13);
+    EXPECT_TRUE(path2.isStrictPrefixOf(path0));
+    EXPECT_TRUE(path2.isStrictPrefixOf(path1));
+    path2.pushStep(*babelwires::PathStep::deserializeFromString("World'1"));
+    EXPECT_EQ(path2, path0);
+    EXPECT_EQ(path2.serializeToString(), "Hello'2/13/World'1");
+
+    // Changing a step does not affect other paths with the same steps.
+    path2.setStep(1, 14);
+    EXPECT_EQ(path2.serializeToString(), "Hello'2/14/World'1");
+    EXPECT_EQ(path0.serializeToString(), "Hello'2/13/World'1");
+    EXPECT_LT(path0, path2);
+    EXPECT_FALSE(path0.isPrefixOf(path2));
+
+    EXPECT_EQ(path2.getSteps(), (std::vector<babelwires::PathStep>{
+                                    *babelwires::PathStep::deserializeFromString("Hello'2"), 14,
+                                    *babelwires::PathStep::deserializeFromString("World'1")}));
+}
+
+TEST(ValueTreeNodePathTest, pathRandomAccess) {
+    std::vector<babelwires::PathStep> steps;
+    for (unsigned int i = 0; i < 100; ++i) {
+        steps.emplace_back(i);
+    }
+    const babelwires::Path path(steps);
+    for (unsigned int i = 0; i < steps.size(); ++i) {
+        EXPECT_EQ(path.getStep(i), steps[i]);
+    }
+    EXPECT_TRUE(std::equal(path.begin(), path.end(), steps.begin(), steps.end()));
+
+    babelwires::Path prefix = path;
+    prefix.truncate(50);
+    EXPECT_TRUE(prefix.isStrictPrefixOf(path));
+    EXPECT_LT(prefix, path);
+    prefix.pushStep(7);
+    EXPECT_FALSE(prefix.isPrefixOf(path));
+    EXPECT_LT(prefix, path);
+}
+
+TEST(ValueTreeNodePathTest, pathsBuiltConcurrently) {
+    std::vector<std::thread> threads;
+    std::vector<babelwires::Path> paths(8);
+    for (unsigned int t = 0; t < paths.size(); ++t) {
+        threads.emplace_back([&paths, t]() {
+            for (unsigned int i = 0; i < 1000; ++i) {
+                babelwires::Path path;
+                for (unsigned int j = 0; j < 10; ++j) {
+                    path.pushStep(babelwires::PathStep((i + j) % 20));
+                }
+                paths[t] = path;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& path : paths) {
+        EXPECT_EQ(path, paths[0]);
+        EXPECT_EQ(path.getHash(), paths[0].getHash());
+    }
+}
+
+TEST(ValueTreeNodePathTest, pathConstructionCost) {
+    // The ContentsCache builds the path of each row by extending the path of its parent row by one step, and stores
+    // it in the row and in its index. It rebuilds the rows whenever the value changes, usually with the same paths.
+    // Compare this against the same work with a vector of steps, which is what Path used to be.
+    constexpr unsigned int numChildren = 8;
+    constexpr unsigned int depth = 3;
+    constexpr unsigned int numRebuilds = 10;
+    constexpr unsigned int numTrials = 7;
+
+    const auto timeWork = [&](auto&& makePath, auto&& pushStep) {
+        using PathType = decltype(makePath());
+        std::vector<PathType> rows;
+        std::vector<PathType> index;
+        std::vector<PathType> previousRows;
+        auto bestDuration = std::chrono::steady_clock::duration::max();
+        for (unsigned int t = 0; t < numTrials; ++t) {
+            const auto start = std::chrono::steady_clock::now();
+            for (unsigned int r = 0; r < numRebuilds; ++r) {
+                previousRows.swap(rows);
+                rows.clear();
+                index.clear();
+                rows.emplace_back(makePath());
+                std::size_t firstRowAtDepth = 0;
+                for (unsigned int d = 0; d < depth; ++d) {
+                    const std::size_t endOfDepth = rows.size();
+                    for (std::size_t parentRow = firstRowAtDepth; parentRow < endOfDepth; ++parentRow) {
+                        for (unsigned int c = 0; c < numChildren; ++c) {
+                            PathType path = rows[parentRow];
+                            pushStep(path, babelwires::PathStep(c));
+                            index.emplace_back(path);
+                            rows.emplace_back(std::move(path));
+                        }
+                    }
+                    firstRowAtDepth = endOfDepth;
+                }
+                previousRows.clear();
+            }
+            bestDuration = std::min(bestDuration, std::chrono::steady_clock::now() - start);
+        }
+        return bestDuration;
+    };
+
+    const auto vectorDuration = timeWork([]() { return std::vector<babelwires::PathStep>(); },
+                                         [](auto& path, babelwires::PathStep step) { path.emplace_back(step); });
+    const auto pathDuration = timeWork([]() { return babelwires::Path(); },
+                                       [](auto& path, babelwires::PathStep step) { path.pushStep(step); });
+
+    RecordProperty("vectorMicroseconds",
+                   std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(vectorDuration).count()));
+    RecordProperty("pathMicroseconds",
+                   std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(pathDuration).count()));
+    EXPECT_LE(pathDuration, vectorDuration);
+}
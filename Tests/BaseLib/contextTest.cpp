@@ -68,6 +68,16 @@ TEST(ContextTest, independentInstances) {
     EXPECT_NE(&context1.get<ServiceA>(), &context2.get<ServiceA>());
 }
 
+TEST(ContextTest, tryGet) {
+    babelwires::Context context;
+    EXPECT_EQ(context.tryGet<ServiceA>(), nullptr);
+
+    ServiceA a;
+    context.registerService<ServiceA>(a);
+    EXPECT_EQ(context.tryGet<ServiceA>(), &a);
+    EXPECT_EQ(context.tryGet<ServiceB>(), nullptr);
+}
+
 TEST(ContextTest, getServiceAssertOnMissing) {
     babelwires::Context context;
     EXPECT_DEATH(context.get<ServiceA>(), "Service not registered");
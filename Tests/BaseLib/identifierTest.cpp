@@ -10,6 +10,11 @@
 #include <BaseLib/Serialization/serializer.hpp>
 #include <BaseLib/Serialization/userDocumentSerializationFactory.hpp>
 
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
 TEST(IdentifierTest, identifiers) {
     babelwires::ShortId hello("Hello");
     EXPECT_EQ(hello.getDiscriminator(), 0);
@@ -504,3 +509,96 @@ TEST(IdentifierTest, longIdentifierInRegistry) {
     EXPECT_NE(id2.getDiscriminator(), id.getDiscriminator());
     EXPECT_EQ(identifierRegistry.getName(id2), "Hello World 2");
 }
+
+namespace {
+    babelwires::Uuid getTestUuid(int i) {
+        std::ostringstream os;
+        os << "00000000-1111-2222-3333-" << std::setw(12) << std::setfill('0') << i;
+        return babelwires::Uuid(os.str());
+    }
+} // namespace
+
+TEST(IdentifierTest, identifierRegistryManyIdentifiers) {
+    testUtils::TestLog log;
+
+    babelwires::IdentifierRegistry identifierRegistry;
+
+    constexpr int numDistinct = 1000;
+    constexpr int numDuplicates = 100;
+
+    std::vector<babelwires::ShortId> ids;
+    for (int i = 0; i < numDistinct; ++i) {
+        ids.emplace_back(identifierRegistry.addIdentifierWithMetadata(
+            babelwires::ShortId("id" + std::to_string(i)), "Name " + std::to_string(i), getTestUuid(i),
+            babelwires::IdentifierRegistry::Authority::isProvisional));
+    }
+    for (int i = 0; i < numDuplicates; ++i) {
+        ids.emplace_back(identifierRegistry.addIdentifierWithMetadata(
+            babelwires::ShortId("dup"), "Name " + std::to_string(numDistinct + i), getTestUuid(numDistinct + i),
+            babelwires::IdentifierRegistry::Authority::isProvisional));
+        EXPECT_EQ(ids.back().getDiscriminator(), i + 1);
+    }
+
+    for (int i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(identifierRegistry.getName(ids[i]), "Name " + std::to_string(i));
+    }
+    EXPECT_EQ(identifierRegistry.getName(babelwires::ShortId("dup")), "dup");
+
+    int count = 0;
+    for (const auto& [identifier, name, uuid] : identifierRegistry) {
+        EXPECT_NE(identifier.getDiscriminator(), 0);
+        ++count;
+    }
+    EXPECT_EQ(count, ids.size());
+
+    // Authoritative registration updates the names.
+    for (int i = 0; i < ids.size(); i += 7) {
+        identifierRegistry.addIdentifierWithMetadata(babelwires::ShortId(ids[i].withoutDiscriminator()),
+                                                     "New name " + std::to_string(i), getTestUuid(i),
+                                                     babelwires::IdentifierRegistry::Authority::isAuthoritative);
+    }
+    for (int i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(identifierRegistry.getName(ids[i]),
+                  ((i % 7) == 0) ? ("New name " + std::to_string(i)) : ("Name " + std::to_string(i)));
+    }
+}
+
+TEST(IdentifierTest, identifierRegistryConcurrentReads) {
+    testUtils::TestLog log;
+
+    babelwires::IdentifierRegistryScope identifierRegistryScope;
+
+    constexpr int numIdentifiers = 2000;
+    std::vector<babelwires::ShortId> ids(numIdentifiers);
+    std::atomic<int> numRegistered = 0;
+
+    std::thread writer([&]() {
+        for (int i = 0; i < numIdentifiers; ++i) {
+            ids[i] = babelwires::IdentifierRegistry::write()->addIdentifierWithMetadata(
+                babelwires::ShortId("id" + std::to_string(i % 100)), "Name " + std::to_string(i), getTestUuid(i),
+                babelwires::IdentifierRegistry::Authority::isAuthoritative);
+            numRegistered.store(i + 1, std::memory_order_release);
+        }
+    });
+
+    std::atomic<int> numMismatches = 0;
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&, r]() {
+            int n = 0;
+            while ((n = numRegistered.load(std::memory_order_acquire)) < numIdentifiers) {
+                for (int i = r; i < n; i += 3) {
+                    if (babelwires::IdentifierRegistry::read()->getName(ids[i]) != "Name " + std::to_string(i)) {
+                        ++numMismatches;
+                    }
+                }
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(numMismatches, 0);
+}
@@ -1,4 +1,5 @@
 #include <BaseLib/Math/rational.hpp>
+#include <BaseLib/Math/rational64.hpp>
 
 #include <BaseLib/Result/resultDSL.hpp>
 
@@ -316,4 +317,95 @@ TEST(RationalTest, continuedFractionApproximation) {
         Rational result = Rational(maxComp - 1, 2) / Rational(3, maxComp - 2);
         EXPECT_EQ(result, Rational(maxComp));
     }
-}
\ No newline at end of file
+}
+TEST(RationalTest, rational64BasicOperations) {
+    EXPECT_EQ(Rational64(1, 2) + Rational64(1, 2), Rational64(1));
+    EXPECT_EQ(Rational64(1, 2) - Rational64(1, 2), Rational64(0));
+    EXPECT_EQ(Rational64(2, 4), Rational64(1, 2));
+    EXPECT_EQ(Rational64(1, 2) + Rational64(2, 3), Rational64(7, 6));
+    EXPECT_EQ(Rational64(1, 4) + Rational64(1, 4), Rational64(1, 2));
+    EXPECT_EQ(Rational64(1, 2) * Rational64(2, 3), Rational64(1, 3));
+    EXPECT_EQ(Rational64(1, 2) / Rational64(-2, 3), Rational64(-3, 4));
+    EXPECT_EQ(-Rational64(1, 2), Rational64(1, -2));
+    EXPECT_EQ(Rational64(0, -5), Rational64(0));
+    EXPECT_EQ(Rational64(Rational(3, 4)), Rational64(3, 4));
+    EXPECT_EQ(Rational64(3, 4).toRational(), Rational(3, 4));
+    EXPECT_EQ(Rational64(7, 2).toString(), Rational(7, 2).toString());
+}
+
+TEST(RationalTest, rational64BeyondRational) {
+    const Rational64::ComponentType maxComp32 = std::numeric_limits<Rational::ComponentType>::max();
+
+    // These would overflow Rational.
+    const Rational64 big = Rational64(maxComp32) * Rational64(4);
+    EXPECT_EQ(big.getNumerator(), static_cast<Rational64::ComponentType>(maxComp32) * 4);
+    EXPECT_EQ(big.getDenominator(), 1);
+    EXPECT_EQ(big / Rational64(4), Rational64(maxComp32));
+    EXPECT_EQ(Rational64(1, maxComp32) * Rational64(1, maxComp32) * Rational64(maxComp32), Rational64(1, maxComp32));
+
+    // Converting back approximates.
+    EXPECT_EQ(big.toRational(), Rational(maxComp32));
+}
+
+TEST(RationalTest, rational64NearLimits) {
+    const Rational64::ComponentType maxComp = std::numeric_limits<Rational64::ComponentType>::max();
+
+    // Exact comparison even where cross-multiplication would overflow.
+    EXPECT_LT(Rational64(maxComp - 2, maxComp - 1), Rational64(maxComp - 1, maxComp));
+    EXPECT_FALSE(Rational64(maxComp - 1, maxComp) < Rational64(maxComp - 2, maxComp - 1));
+    EXPECT_LT(Rational64(-maxComp, maxComp - 1), Rational64(-1));
+    EXPECT_LE(Rational64(1, maxComp), Rational64(1, maxComp));
+    EXPECT_GT(Rational64(maxComp, 3), Rational64(maxComp - 1, 3));
+    // Taking the integer part of a large negative value must not overflow either.
+    EXPECT_LT(Rational64(-2), Rational64(-maxComp, (maxComp / 2) + 2));
+    EXPECT_GT(Rational64(-maxComp, (maxComp / 2) + 2), Rational64(-2));
+
+    // Results which are not representable are approximated.
+    const Rational64 sum = Rational64(maxComp, 3) + Rational64(maxComp, 5);
+    EXPECT_GT(sum, Rational64(0));
+    const Rational64 product = Rational64(maxComp - 1, maxComp) * Rational64(maxComp - 2, maxComp - 1);
+    EXPECT_NEAR(static_cast<double>(product.getNumerator()) / product.getDenominator(), 1.0, 1e-9);
+    EXPECT_EQ(Rational64(maxComp) * Rational64(2), Rational64(maxComp));
+}
+
+TEST(RationalTest, rationalBatch) {
+    const std::vector<Rational> durations = {Rational(1, 4), Rational(1, 8), Rational(1, 8), Rational(1, 3),
+                                             Rational(2, 3), Rational(1, 2)};
+
+    EXPECT_EQ(rationalBatch::sum(durations), Rational64(2));
+    EXPECT_EQ(rationalBatch::sum({}), Rational64(0));
+
+    std::vector<Rational64> startTimes(durations.size());
+    rationalBatch::exclusivePrefixSum(durations, startTimes, Rational64(10));
+    EXPECT_EQ(startTimes, (std::vector<Rational64>{Rational64(10), Rational64(41, 4), Rational64(83, 8),
+                                                   Rational64(21, 2), Rational64(65, 6), Rational64(23, 2)}));
+
+    std::vector<Rational> scaled(durations.size());
+    rationalBatch::scale(durations, Rational(2), scaled);
+    EXPECT_EQ(scaled, (std::vector<Rational>{Rational(1, 2), Rational(1, 4), Rational(1, 4), Rational(2, 3),
+                                             Rational(4, 3), Rational(1)}));
+    rationalBatch::scale(durations, Rational(1), scaled);
+    EXPECT_EQ(scaled, durations);
+}
+
+TEST(RationalTest, rationalBatchSumBeyondRational) {
+    // A long timeline whose total does not fit in Rational.
+    const Rational::ComponentType maxComp32 = std::numeric_limits<Rational::ComponentType>::max();
+    std::vector<Rational> durations(1000, Rational(maxComp32 / 2, 3));
+    const Rational64 total = rationalBatch::sum(durations);
+    EXPECT_EQ(total, Rational64(static_cast<Rational64::ComponentType>(maxComp32 / 2) * 1000, 3));
+}
+
+TEST(RationalTest, rationalBatchPrefixSumBeyondCommonDenominator) {
+    // The sum outgrows the common denominator of the values, even though the values it reaches are integers.
+    const Rational::ComponentType maxComp32 = std::numeric_limits<Rational::ComponentType>::max();
+    std::vector<Rational> durations = {Rational(1, 1 << 30), Rational(-1, 1 << 30)};
+    durations.resize(22, Rational(maxComp32));
+    std::vector<Rational64> startTimes(durations.size());
+    rationalBatch::exclusivePrefixSum(durations, startTimes);
+    EXPECT_EQ(startTimes[0], Rational64(0));
+    EXPECT_EQ(startTimes[1], Rational64(1, 1 << 30));
+    for (std::size_t i = 2; i < durations.size(); ++i) {
+        EXPECT_EQ(startTimes[i], Rational64(static_cast<Rational64::ComponentType>(maxComp32) * (i - 2)));
+    }
+}
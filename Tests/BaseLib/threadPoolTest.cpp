@@ -0,0 +1,87 @@
+/**
+ * Tests for the ThreadPool.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <BaseLib/Threading/threadPool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ThreadPoolTest, eachIndexOnce) {
+    for (unsigned int numWorkers : {0, 1, 4}) {
+        babelwires::ThreadPool threadPool(numWorkers);
+        EXPECT_EQ(threadPool.getNumWorkers(), numWorkers);
+
+        std::vector<std::atomic<int>> counts(1000);
+        threadPool.parallelFor(counts.size(), [&counts](std::size_t i) { ++counts[i]; });
+        for (const auto& count : counts) {
+            EXPECT_EQ(count, 1);
+        }
+
+        // Empty and single ranges are fine.
+        threadPool.parallelFor(0, [](std::size_t) { FAIL(); });
+        int single = 0;
+        threadPool.parallelFor(1, [&single](std::size_t i) { single += static_cast<int>(i) + 1; });
+        EXPECT_EQ(single, 1);
+    }
+}
+
+TEST(ThreadPoolTest, workIsShared) {
+    babelwires::ThreadPool threadPool(3);
+
+    std::mutex mutex;
+    std::set<std::thread::id> threadIds;
+    std::atomic<int> numStarted = 0;
+    threadPool.parallelFor(4, [&](std::size_t) {
+        {
+            std::lock_guard lock(mutex);
+            threadIds.insert(std::this_thread::get_id());
+        }
+        // Don't let any thread finish until all four calls are running, so each call has its own thread.
+        ++numStarted;
+        while (numStarted < 4) {
+            std::this_thread::yield();
+        }
+    });
+    EXPECT_EQ(threadIds.size(), 4);
+}
+
+TEST(ThreadPoolTest, nested) {
+    babelwires::ThreadPool threadPool(2);
+
+    std::atomic<int> total = 0;
+    threadPool.parallelFor(8, [&](std::size_t i) {
+        threadPool.parallelFor(8, [&](std::size_t j) { total += static_cast<int>(i * 8 + j); });
+    });
+    EXPECT_EQ(total, 63 * 64 / 2);
+}
+
+TEST(ThreadPoolTest, exceptions) {
+    babelwires::ThreadPool threadPool(2);
+
+    std::atomic<int> numCalls = 0;
+    EXPECT_THROW(threadPool.parallelFor(100,
+                                        [&](std::size_t i) {
+                                            ++numCalls;
+                                            if (i == 50) {
+                                                throw std::runtime_error("Failed");
+                                            }
+                                        }),
+                 std::runtime_error);
+    // The other calls still happened.
+    EXPECT_EQ(numCalls, 100);
+
+    // The pool is still usable.
+    std::atomic<int> total = 0;
+    threadPool.parallelFor(10, [&](std::size_t i) { total += static_cast<int>(i); });
+    EXPECT_EQ(total, 45);
+}